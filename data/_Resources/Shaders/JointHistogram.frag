@@ -0,0 +1,36 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+in vec2 coord;
+in float valuePosition;
+out vec4 fragmentColor;
+
+uniform sampler2D uniformJointHistogram;
+
+void main()
+{
+	// Only range of transferfunction is covered, like by histogram
+	if(valuePosition < 0 || valuePosition > 1)
+	{
+		discard;
+	}
+
+	// Counts are log scaled already
+	float count = texture(uniformJointHistogram, coord).r;
+	fragmentColor = vec4(vec3(0.1 + 0.5 * count), 1);
+}
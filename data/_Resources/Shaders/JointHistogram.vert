@@ -0,0 +1,33 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+layout (location = 0) in vec4 positionAttribute;
+
+out vec2 coord;
+out float valuePosition;
+
+uniform mat4 uniformModel;
+uniform mat4 uniformView;
+
+void main()
+{
+	coord = positionAttribute.xy;
+	vec4 position = uniformModel * positionAttribute;
+	valuePosition = position.x;
+	gl_Position = uniformView * position;
+}
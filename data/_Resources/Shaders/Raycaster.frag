@@ -23,9 +23,16 @@ in vec3 volumeExtentMin;
 in vec3 volumeExtentMax;
 out vec4 fragmentColor;
 
-// Volumes
+// Volumes, values have mip levels but rays sample level zero since derivatives in loops are undefined
 uniform sampler3D uniformVolume;
 uniform sampler3D uniformImportanceVolume;
+uniform sampler3D uniformGradientVolume;
+uniform int uniformGradientVolumeReady;
+
+// Empty space skipping
+uniform sampler3D uniformBrickExtrema;
+uniform sampler2D uniformMaximumAlpha;
+uniform sampler3D uniformEmptySpaceMap;
 
 // Transferfunctions (preintegrated)
 uniform sampler2D uniformColorAlphaPreintegration;
@@ -55,7 +62,12 @@ uniform vec4 uniformAdvancedInput;
 
 // Information from the volume object, like value scale and offset
 uniform vec2 uniformVolumeValueInformation;
-uniform vec3 uniformVolumeResolution;
+
+// Texels per axis, voxel spaced steps follow texels when texture is downsampled
+uniform vec3 uniformTextureResolution;
+
+// Bricks per unit of texture coordinates, bricks are built over texels
+uniform vec3 uniformBrickGridScale;
 
 // Some nasty constants
 const float shadowBias = 5;
@@ -67,11 +79,53 @@ const float emptySpaceSkippingTreshold = 0.001;
 /** Calculate voxel spaced step size */
 float voxelSpacedStepSize(vec3 dir)
 {
-	vec3 voxelSize = 1.0/uniformVolumeResolution;
+	vec3 voxelSize = 1.0/uniformTextureResolution;
 	vec3 result = voxelSize * dir;
 	return length(result);
 }
 
+#if defined(USE_BRICK_ESS)
+/** Returns whether transferfunction is transparent for all values in brick */
+bool brickIsTransparent(ivec3 brick, float valueOffset, float valueScale)
+{
+	vec2 extrema = texelFetch(uniformBrickExtrema, brick, 0).rg * valueScale + valueOffset;
+	float low = min(extrema.x, extrema.y);
+	float high = max(extrema.x, extrema.y);
+
+	// Transferfunction is mirrored below zero and values are clamped at one
+	high = min(max(high, -low), 1);
+	low = max(low, 0);
+
+	// Texels which are interpolated for values between both
+	int resolution = textureSize(uniformMaximumAlpha, 0).x;
+	int lowTexel = clamp(int(floor(low * resolution - 0.5)), 0, resolution - 1);
+	int highTexel = clamp(int(ceil(high * resolution - 0.5)), 0, resolution - 1);
+	return texelFetch(uniformMaximumAlpha, ivec2(lowTexel, highTexel), 0).r < emptySpaceSkippingTreshold;
+}
+#endif
+
+#if defined(USE_BRICK_ESS) || defined(USE_DISTANCE_ESS)
+/** Calculate length of ray until it leaves box from first to last brick */
+float brickExitLength(vec3 pos, vec3 dir, ivec3 firstBrick, ivec3 lastBrick)
+{
+	vec3 brickMin = vec3(firstBrick) / uniformBrickGridScale;
+	vec3 brickMax = vec3(lastBrick + 1) / uniformBrickGridScale;
+	float exitLength = 100000;
+	for(int i = 0; i < 3; i++)
+	{
+		if(dir[i] > 0)
+		{
+			exitLength = min(exitLength, (brickMax[i] - pos[i]) / dir[i]);
+		}
+		else if(dir[i] < 0)
+		{
+			exitLength = min(exitLength, (brickMin[i] - pos[i]) / dir[i]);
+		}
+	}
+	return max(exitLength, 0);
+}
+#endif
+
 /** Calculate ray length */
 float rayLength(vec3 pos, vec3 dir, vec3 volumeExtMin, vec3 volumeExtMax)
 {
@@ -139,12 +193,12 @@ vec4 normalOnRawData(vec3 pos, float offset)
 	vec3 nrm = vec3(0,0,0);
 
 	// Get values from volume
-	float x1 = texture(uniformVolume, vec3(pos.x + offset, pos.y, pos.z)).r;
-	float x2 = texture(uniformVolume, vec3(pos.x - offset, pos.y, pos.z)).r;
-	float y1 = texture(uniformVolume, vec3(pos.x, pos.y + offset, pos.z)).r;
-	float y2 = texture(uniformVolume, vec3(pos.x, pos.y - offset, pos.z)).r;
-	float z1 = texture(uniformVolume, vec3(pos.x, pos.y, pos.z + offset)).r;
-	float z2 = texture(uniformVolume, vec3(pos.x, pos.y, pos.z - offset)).r;
+	float x1 = textureLod(uniformVolume, vec3(pos.x + offset, pos.y, pos.z), 0).r;
+	float x2 = textureLod(uniformVolume, vec3(pos.x - offset, pos.y, pos.z), 0).r;
+	float y1 = textureLod(uniformVolume, vec3(pos.x, pos.y + offset, pos.z), 0).r;
+	float y2 = textureLod(uniformVolume, vec3(pos.x, pos.y - offset, pos.z), 0).r;
+	float z1 = textureLod(uniformVolume, vec3(pos.x, pos.y, pos.z + offset), 0).r;
+	float z2 = textureLod(uniformVolume, vec3(pos.x, pos.y, pos.z - offset), 0).r;
 
 	// Create good normals at extent
 	#if defined(USE_EXTENT_AWARE_NORMALS)
@@ -189,22 +243,36 @@ vec4 normalOnRawData(vec3 pos, float offset)
 	return vec4(nrm, mag);
 }
 
+/** Returns vec4(normalized normal, magnitude) of precomputed gradients with one fetch, model space */
+vec4 normalOnGradientVolume(vec3 pos)
+{
+	// Normal is packed into zero to one, magnitude is already divided through sqrt(3)
+	vec4 gradient = texture(uniformGradientVolume, pos);
+	vec3 nrm = gradient.rgb * 2.0 - 1.0;
+
+	// Transformate with uniformModelScale
+	nrm = (uniformModelScale * vec4(nrm,0)).rgb;
+
+	nrm = normalize(nrm);
+	return vec4(nrm, gradient.a);
+}
+
 /** Returns vec4(normalized normal, magnitude), model space */
 vec4 normalOnClassifiedData(vec3 pos, float offset, float valueOffset, float valueScale)
 {
 	vec3 nrm = vec3(0,0,0);
 
 	// Get values from volume
-	float x1 = texture(uniformVolume, vec3(pos.x + offset, pos.y, pos.z)).r;
-	float x2 = texture(uniformVolume, vec3(pos.x - offset, pos.y, pos.z)).r;
-	float y1 = texture(uniformVolume, vec3(pos.x, pos.y + offset, pos.z)).r;
-	float y2 = texture(uniformVolume, vec3(pos.x, pos.y - offset, pos.z)).r;
-	float z1 = texture(uniformVolume, vec3(pos.x, pos.y, pos.z + offset)).r;
-	float z2 = texture(uniformVolume, vec3(pos.x, pos.y, pos.z - offset)).r;
+	float x1 = textureLod(uniformVolume, vec3(pos.x + offset, pos.y, pos.z), 0).r;
+	float x2 = textureLod(uniformVolume, vec3(pos.x - offset, pos.y, pos.z), 0).r;
+	float y1 = textureLod(uniformVolume, vec3(pos.x, pos.y + offset, pos.z), 0).r;
+	float y2 = textureLod(uniformVolume, vec3(pos.x, pos.y - offset, pos.z), 0).r;
+	float z1 = textureLod(uniformVolume, vec3(pos.x, pos.y, pos.z + offset), 0).r;
+	float z2 = textureLod(uniformVolume, vec3(pos.x, pos.y, pos.z - offset), 0).r;
 
 	#if defined(USE_PREINTEGRATION)
 		// Normals calculated from preintegrated alphas
-		float originValue = texture(uniformVolume, pos).r * valueScale + valueOffset;
+		float originValue = textureLod(uniformVolume, pos, 0).r * valueScale + valueOffset;
 		x1 = texture(uniformColorAlphaPreintegration, vec2(originValue, x1 * valueScale + valueOffset)).a;
 		x2 = texture(uniformColorAlphaPreintegration, vec2(originValue, x2 * valueScale + valueOffset)).a;
 		y1 = texture(uniformColorAlphaPreintegration, vec2(originValue, y1 * valueScale + valueOffset)).a;
@@ -322,7 +390,7 @@ float castShadowRay(
 
 	#if defined(USE_PREINTEGRATION)
 		vec3 nextPos = currPos;
-		float prevValue = texture(uniformVolume, nextPos).r * valueScale + valueOffset;
+		float prevValue = textureLod(uniformVolume, nextPos, 0).r * valueScale + valueOffset;
 	#endif
 
 	// Raycasting loop
@@ -344,7 +412,7 @@ float castShadowRay(
 			#if defined(USE_PREINTEGRATION)
 				// Preintegration (use 'currValue' for next position's value)
 				nextPos = currPos - sunDir * currStepSize;
-				currValue = texture(uniformVolume, nextPos).r;
+				currValue = textureLod(uniformVolume, nextPos, 0).r;
 				currValue = currValue * valueScale + valueOffset;
 				src = texture(uniformColorAlphaPreintegration, vec2(prevValue, currValue)).a;
 				// Prepare next run
@@ -352,7 +420,7 @@ float castShadowRay(
 				currPos = nextPos;
 			#else
 				// Postinterpolation
-				currValue = texture(uniformVolume, currPos).r;
+				currValue = textureLod(uniformVolume, currPos, 0).r;
 				currValue = currValue * valueScale + valueOffset;
 				src = texture(uniformColorAlpha, currValue).a;
 				currPos -= sunDir * currStepSize;
@@ -452,7 +520,7 @@ void main()
 
 	// For preintegration one need two values from volume, even on first run
 	#if defined(USE_PREINTEGRATION)
-		currValue = texture(uniformVolume, currPos).r * valueScale + valueOffset;
+		currValue = textureLod(uniformVolume, currPos, 0).r * valueScale + valueOffset;
 		currValue = min(currValue, 1);
 	#endif
 
@@ -490,6 +558,46 @@ void main()
 				#endif
 			#endif
 
+			// *** BRICK EMPTY SPACE SKIPPING ***
+
+			// Leap over whole bricks, which are transparent for all of their values
+			#if defined(USE_BRICK_ESS) || defined(USE_DISTANCE_ESS)
+				ivec3 brick = ivec3(floor((currPos + currJitteringOffset) * uniformBrickGridScale));
+				float exitLength = -1;
+				#if defined(USE_DISTANCE_ESS)
+					// All bricks closer than distance are transparent. Distance is zero while map is computed
+					brick = clamp(brick, ivec3(0), textureSize(uniformEmptySpaceMap, 0) - 1);
+					int emptyDistance = int(texelFetch(uniformEmptySpaceMap, brick, 0).r);
+					if(emptyDistance > 0)
+					{
+						exitLength = brickExitLength(currPos + currJitteringOffset, dir, brick - (emptyDistance - 1), brick + (emptyDistance - 1));
+					}
+				#endif
+				#if defined(USE_BRICK_ESS)
+					brick = clamp(brick, ivec3(0), textureSize(uniformBrickExtrema, 0) - 1);
+					if(exitLength < 0 && brickIsTransparent(brick, valueOffset, valueScale))
+					{
+						exitLength = brickExitLength(currPos + currJitteringOffset, dir, brick, brick);
+					}
+				#endif
+				if(exitLength >= 0)
+				{
+					// Whole steps keep positions of samples, at least one step is taken
+					float leap = (floor(exitLength / currStepSize) + 1) * currStepSize;
+					currPos += dir * leap;
+					currRayLength += leap;
+					#if defined(USE_PREINTEGRATION)
+						currValue = textureLod(uniformVolume, currPos + currJitteringOffset, 0).r * valueScale + valueOffset;
+						currValue = min(currValue, 1);
+					#endif
+					if(currRayLength >= maxRayLength)
+					{
+						break;
+					}
+					continue;
+				}
+			#endif
+
 			// Set previous value for preintegration
 			#if defined(USE_PREINTEGRATION)
 				prevValue = currValue;
@@ -503,12 +611,12 @@ void main()
 			// Decide whether to use preintegration or postinterpolation
 			#if defined(USE_PREINTEGRATION)
 				// Preintegration (use 'currValue' for value of next position)
-				currValue = texture(uniformVolume, nextPos + currJitteringOffset).r * valueScale + valueOffset;
+				currValue = textureLod(uniformVolume, nextPos + currJitteringOffset, 0).r * valueScale + valueOffset;
 				currValue = min(currValue, 1);
 				src = texture(uniformColorAlphaPreintegration, vec2(prevValue, currValue)).rgba;
 			#else
 				// Postinterpolation
-				currValue = texture(uniformVolume, currPos + currJitteringOffset).r * valueScale + valueOffset;
+				currValue = textureLod(uniformVolume, currPos + currJitteringOffset, 0).r * valueScale + valueOffset;
 				currValue = min(currValue, 1);
 				src = texture(uniformColorAlpha, currValue).rgba;
 			#endif
@@ -532,6 +640,16 @@ void main()
 			#if defined(USE_LOCAL_ILLUMINATION) || defined(USE_GRADIENT_ALPHA_MULTIPLIER) || defined(USE_FRESNEL_ALPHA_MULTIPLIER) || defined(USE_REFLECTION_COLOR_MULTIPLIER)
 				#if defined(USE_NORMALS_OF_CLASSIFIED_DATA)
 					nrm = normalOnClassifiedData(currPos + currJitteringOffset, nrmCalulationOffset, valueOffset, valueScale).rgba;
+				#elif defined(USE_GRADIENT_VOLUME)
+					// Gradient volume uses neighbouring voxels instead of offset, raw data is used while it is computed
+					if(uniformGradientVolumeReady != 0)
+					{
+						nrm = normalOnGradientVolume(currPos + currJitteringOffset).rgba;
+					}
+					else
+					{
+						nrm = normalOnRawData(currPos + currJitteringOffset, nrmCalulationOffset).rgba;
+					}
 				#else
 					nrm = normalOnRawData(currPos + currJitteringOffset, nrmCalulationOffset).rgba;
 				#endif
@@ -86,14 +86,13 @@ void App::init()
     LogInfo(std::string(reinterpret_cast<char const*>(renderer)));
     const GLubyte* version = glGetString(GL_VERSION);
     LogInfo(std::string(reinterpret_cast<char const*>(version)));
-    GLint maxVolumeResolution;
     glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &maxVolumeResolution);
     LogInfo("Maximum volume resolution per dimension: " + UT::to_string(maxVolumeResolution));
 
     // Member initializations
     pInput = Input::instantiate(pWindow, windowWidth, windowHeight);
     pEditor = new Editor();
-    pEditor->init(windowWidth, windowHeight);
+    pEditor->init(windowWidth, windowHeight, maxVolumeResolution);
 
     // OpenGL
     glEnable(GL_DEPTH_TEST);
@@ -168,7 +167,7 @@ void App::run()
                 pEditor = NULL;
             }
             pEditor = new Editor();
-            pEditor->init(windowWidth, windowHeight);
+            pEditor->init(windowWidth, windowHeight, maxVolumeResolution);
             LogInfo("Reset done");
         }
     }
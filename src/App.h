@@ -73,6 +73,9 @@ protected:
     GLuint windowWidth;
     GLuint windowHeight;
     GLfloat lastTime;
+
+    /** Limit of device for textures of volumes */
+    GLint maxVolumeResolution;
 };
 
 #endif
@@ -28,14 +28,38 @@ Editor::Editor()
 	bar_viewportPreset = EDITOR_VIEWPORT_PRESET_A;
 	previousViewportPreset = -1;
 	bar_overwriteExisting = GL_FALSE;
+	bar_saveBricked = GL_TRUE;
+	bar_saveCompressed = GL_FALSE;
+	bar_importRegion = GL_FALSE;
+	bar_importRegionOffset = glm::ivec3(0, 0, 0);
+	bar_importRegionSize = glm::ivec3(0, 0, 0);
+	bar_importQuantize = GL_FALSE;
+	bar_importClipPercentage = 0.1f;
+	bar_importResample = GL_FALSE;
+	bar_importResampleSpacing = 0;
+	bar_importResampleBudget = 0;
+	bar_importDenoising = VOLUMEPROCESSOR_DENOISE_NONE;
+	bar_importDenoisingSigma = 1;
+	bar_importDenoisingRangeSigma = 0.05f;
+	bar_importGradients = GL_FALSE;
+	bar_importGradients16Bit = GL_FALSE;
+	bar_importPyramidReduction = VOLUME_PYRAMID_REDUCTION;
+	bar_importTextureBudget = 0;
 	bar_setVolumeInAllViewports = GL_TRUE;
+	bar_generatorField = FIELD_MARSCHNER_LOBB;
+	bar_generatorResolution = glm::ivec3(256, 256, 256);
+	bar_generatorValueResolution = VOLUME_8BIT;
+	bar_generatorEmptyFraction = 0.9f;
+	bar_generatorSeed = 1;
+	bar_loadingProgress = 0;
+	bar_loadingTimeLeft = 0;
 }
 
 Editor::~Editor()
 {
 }
 
-void Editor::init(GLint windowWidth, GLint windowHeight)
+void Editor::init(GLint windowWidth, GLint windowHeight, GLint maxTextureResolution)
 {
 	LogInfo("");
 	LogInfo("***SPECIAL KEYS***");
@@ -53,7 +77,7 @@ void Editor::init(GLint windowWidth, GLint windowHeight)
 	rcManager.init();
 
 	// Volume manager
-	volumeManager.init();
+	volumeManager.init(maxTextureResolution);
 
 	// Try to use data from launch file
 	GLint errorsInLaunchFile = 0;
@@ -76,8 +100,15 @@ void Editor::init(GLint windowWidth, GLint windowHeight)
 	}
 	else
 	{
-		// Try to load volume
-		volumeHandle = volumeManager.loadVolume(launchVolume);
+		// Try to load or generate volume, launch file is the only one which blocks as there is no frame yet
+		if(VolumeGenerator::isSpecification(launchVolume))
+		{
+			volumeHandle = volumeManager.generateVolume(launchVolume);
+		}
+		else
+		{
+			volumeHandle = volumeManager.loadVolume(launchVolume);
+		}
 		if(volumeHandle < 0)
 		{
 			volumeHandle = volumeManager.createDefaultVolume();
@@ -127,6 +158,22 @@ void Editor::init(GLint windowWidth, GLint windowHeight)
 	// Configurate viewport preset enumerations
 	TwEnumVal viewportPresetEV[] = { {EDITOR_VIEWPORT_PRESET_A, "A"}, {EDITOR_VIEWPORT_PRESET_B, "B"}, {EDITOR_VIEWPORT_PRESET_C, "C"}, {EDITOR_VIEWPORT_PRESET_D, "D"} };
 	TwType viewportPresetType = TwDefineEnum("Viewport Presets", viewportPresetEV, 4);
+
+	// Configurate generator field enumerations
+	TwEnumVal generatorFieldEV[] = { {FIELD_MARSCHNER_LOBB, "Marschner-Lobb"}, {FIELD_NESTED_SPHERES, "Nested Spheres"}, {FIELD_FRACTAL_NOISE, "Fractal Noise"}, {FIELD_SPARSE_BLOBS, "Sparse Blobs"} };
+	TwType generatorFieldType = TwDefineEnum("Generator Fields", generatorFieldEV, 4);
+
+	// Configurate generator value resolution enumerations, fields are never negative
+	TwEnumVal generatorValueResolutionEV[] = { {VOLUME_8BIT, "8 Bit"}, {VOLUME_16BIT, "16 Bit"}, {VOLUME_32BIT_FLOAT, "32 Bit Float"} };
+	TwType generatorValueResolutionType = TwDefineEnum("Generator Value Resolutions", generatorValueResolutionEV, 3);
+
+	// Configurate mip reduction enumerations
+	TwEnumVal pyramidReductionEV[] = { {VOLUMEPYRAMID_AVERAGE, "Average"}, {VOLUMEPYRAMID_MINIMUM, "Minimum"}, {VOLUMEPYRAMID_MAXIMUM, "Maximum"} };
+	TwType pyramidReductionType = TwDefineEnum("Mip Reductions", pyramidReductionEV, 3);
+
+	// Configurate denoising enumerations
+	TwEnumVal denoisingEV[] = { {VOLUMEPROCESSOR_DENOISE_NONE, "None"}, {VOLUMEPROCESSOR_DENOISE_GAUSSIAN, "Gaussian"}, {VOLUMEPROCESSOR_DENOISE_MEDIAN, "Median 3x3x3"}, {VOLUMEPROCESSOR_DENOISE_BILATERAL, "Bilateral"} };
+	TwType denoisingType = TwDefineEnum("Denoising Filters", denoisingEV, 4);
 	
 	// Add variables to bar
 	TwAddVarRO(pBar, "TPF", TW_TYPE_FLOAT, &bar_tpf, " precision=5 help='Time per frame (ms).' ");
@@ -153,6 +200,7 @@ void Editor::init(GLint windowWidth, GLint windowHeight)
 	TwAddVarRW(pBar, "Mirror Y", TW_TYPE_BOOLCPP, &(bar_volumeMirrorY.value), "");
 	TwAddVarRW(pBar, "Mirror Z", TW_TYPE_BOOLCPP, &(bar_volumeMirrorZ.value), "");
 	TwAddVarRW(pBar, "Use Linear Filtering", TW_TYPE_BOOLCPP, &(bar_volumeLinearFiltering.value), "");
+	TwAddVarRO(pBar, "Texture Resolution", TW_TYPE_STDSTRING, &bar_volumeTextureResolution, " help='Resolution of texture, reduced if volume did not fit device or texture budget.' ");
 
 	TwAddSeparator(pBar, NULL, "");
 	
@@ -162,8 +210,45 @@ void Editor::init(GLint windowWidth, GLint windowHeight)
 	TwAddButton(pBar, "Load", loadVolumeButtonCallback, this, " group='Volume Management' ");
 	TwAddButton(pBar, "Import PVM", importPVMButtonCallback, this, " group='Volume Management' ");
 	TwAddButton(pBar, "Import DAT", importDATButtonCallback, this, " group='Volume Management' ");
+	TwAddButton(pBar, "Import NRRD", importNRRDButtonCallback, this, " group='Volume Management' ");
+	TwAddButton(pBar, "Import MHD", importMHDButtonCallback, this, " group='Volume Management' ");
+	TwAddButton(pBar, "Import PNG Stack", importPNGButtonCallback, this, " group='Volume Management' help='Directory of PNG slices.' ");
+	TwAddVarRW(pBar, "Read Region", TW_TYPE_BOOLCPP, &bar_importRegion, " group='Volume Management' help='Reads only region of volume when loading or importing.' ");
+	TwAddVarRW(pBar, "Region Offset X", TW_TYPE_INT32, &(bar_importRegionOffset.x), " group='Volume Management' min=0 ");
+	TwAddVarRW(pBar, "Region Offset Y", TW_TYPE_INT32, &(bar_importRegionOffset.y), " group='Volume Management' min=0 ");
+	TwAddVarRW(pBar, "Region Offset Z", TW_TYPE_INT32, &(bar_importRegionOffset.z), " group='Volume Management' min=0 ");
+	TwAddVarRW(pBar, "Region Size X", TW_TYPE_INT32, &(bar_importRegionSize.x), " group='Volume Management' min=0 help='Zero reaches to end of volume.' ");
+	TwAddVarRW(pBar, "Region Size Y", TW_TYPE_INT32, &(bar_importRegionSize.y), " group='Volume Management' min=0 help='Zero reaches to end of volume.' ");
+	TwAddVarRW(pBar, "Region Size Z", TW_TYPE_INT32, &(bar_importRegionSize.z), " group='Volume Management' min=0 help='Zero reaches to end of volume.' ");
+	TwAddVarRW(pBar, "Import As 8 Bit", TW_TYPE_BOOLCPP, &bar_importQuantize, " group='Volume Management' help='Quantizes imported 16 bit volumes to 8 bit within value window.' ");
+	TwAddVarRW(pBar, "Import Clip Percentage", TW_TYPE_FLOAT, &bar_importClipPercentage, " group='Volume Management' min=0 max=10 step=0.05 help='Percentage of voxels clipped at each end of value window, zero uses range of values.' ");
+	TwAddVarRW(pBar, "Import Resampled", TW_TYPE_BOOLCPP, &bar_importResample, " group='Volume Management' help='Resamples imported volumes to isotropic grid.' ");
+	TwAddVarRW(pBar, "Resample Spacing", TW_TYPE_FLOAT, &bar_importResampleSpacing, " group='Volume Management' min=0 step=0.05 help='Spacing of resampled grid in voxel scale units, zero takes finest axis.' ");
+	TwAddVarRW(pBar, "Resample Budget", TW_TYPE_INT32, &bar_importResampleBudget, " group='Volume Management' min=0 help='Maximum of megavoxels after resampling, zero means no limit.' ");
+	TwAddVarRW(pBar, "Import Denoised", denoisingType, &bar_importDenoising, " group='Volume Management' help='Filters imported volumes against noise, after resampling and before quantization.' ");
+	TwAddVarRW(pBar, "Denoising Sigma", TW_TYPE_FLOAT, &bar_importDenoisingSigma, " group='Volume Management' min=0.1 max=8 step=0.1 help='Sigma of Gaussian and bilateral filter in voxels.' ");
+	TwAddVarRW(pBar, "Denoising Range Sigma", TW_TYPE_FLOAT, &bar_importDenoisingRangeSigma, " group='Volume Management' min=0.001 max=1 step=0.005 help='Sigma of differences of values for bilateral filter, relative to range of values. Smaller keeps more edges.' ");
+	TwAddVarRW(pBar, "Precompute Gradients", TW_TYPE_BOOLCPP, &bar_importGradients, " group='Volume Management' help='Computes gradient volume for raycaster while loading instead of on first use.' ");
+	TwAddVarRW(pBar, "Gradients 16 Bit", TW_TYPE_BOOLCPP, &bar_importGradients16Bit, " group='Volume Management' help='Packs precomputed gradients with 16 instead of 8 bit per component.' ");
+	TwAddVarRW(pBar, "Texture Budget", TW_TYPE_INT32, &bar_importTextureBudget, " group='Volume Management' min=0 help='Maximum of megabytes for texture of volume, larger volumes are downsampled for rendering. Zero means no limit.' ");
+	TwAddVarRW(pBar, "Mip Reduction", pyramidReductionType, &bar_importPyramidReduction, " group='Volume Management' help='Reduction of blocks for mip levels, minimum and maximum keep extrema of values.' ");
 	TwAddVarRW(pBar, "Overwrite Existing", TW_TYPE_BOOLCPP, &bar_overwriteExisting, " group='Volume Management' ");
+	TwAddVarRW(pBar, "Save Bricked", TW_TYPE_BOOLCPP, &bar_saveBricked, " group='Volume Management' ");
+	TwAddVarRW(pBar, "Save Compressed", TW_TYPE_BOOLCPP, &bar_saveCompressed, " group='Volume Management' help='Block compressed raw data, used if not saved bricked.' ");
 	TwAddVarRW(pBar, "Set Loaded/Imported Volume In All Viewports", TW_TYPE_BOOLCPP, &bar_setVolumeInAllViewports, " group='Volume Management' ");
+	TwAddVarRW(pBar, "Generator Field", generatorFieldType, &bar_generatorField, " group='Volume Generator' ");
+	TwAddVarRW(pBar, "Generator Resolution X", TW_TYPE_INT32, &(bar_generatorResolution.x), " group='Volume Generator' min=4 ");
+	TwAddVarRW(pBar, "Generator Resolution Y", TW_TYPE_INT32, &(bar_generatorResolution.y), " group='Volume Generator' min=4 ");
+	TwAddVarRW(pBar, "Generator Resolution Z", TW_TYPE_INT32, &(bar_generatorResolution.z), " group='Volume Generator' min=4 ");
+	TwAddVarRW(pBar, "Generator Value Resolution", generatorValueResolutionType, &bar_generatorValueResolution, " group='Volume Generator' ");
+	TwAddVarRW(pBar, "Generator Empty Fraction", TW_TYPE_FLOAT, &bar_generatorEmptyFraction, " group='Volume Generator' min=0 max=1 step=0.05 help='Fraction of brick sized cells without blob.' ");
+	TwAddVarRW(pBar, "Generator Seed", TW_TYPE_INT32, &bar_generatorSeed, " group='Volume Generator' min=0 ");
+	TwAddButton(pBar, "Generate", generateVolumeButtonCallback, this, " group='Volume Generator' ");
+	TwAddVarRO(pBar, "Loading", TW_TYPE_STDSTRING, &bar_loadingVolume, " group='Volume Management' ");
+	TwAddVarRO(pBar, "Loading Progress", TW_TYPE_FLOAT, &bar_loadingProgress, " group='Volume Management' precision=0 help='Progress of loading in background (%).' ");
+	TwAddVarRO(pBar, "Loading Bytes", TW_TYPE_STDSTRING, &bar_loadingBytes, " group='Volume Management' help='Bytes read from disk by loading in background.' ");
+	TwAddVarRO(pBar, "Loading Time Left", TW_TYPE_FLOAT, &bar_loadingTimeLeft, " group='Volume Management' precision=1 help='Estimated seconds until loading in background is done.' ");
+	TwAddButton(pBar, "Cancel Loading", cancelLoadingButtonCallback, this, " group='Volume Management' ");
 
 	TwAddSeparator(pBar, NULL, "");
 
@@ -322,6 +407,9 @@ EditorCallToApp Editor::update(GLfloat tpf, InputData inputData)
 		useBarVariables();
 	}
 
+	// Volumes loaded in background replace current one
+	useLoadedVolumes();
+
 	// Update viewports
 	viewportManager.update(tpf, inputData);
 
@@ -397,37 +485,81 @@ void Editor::toggleFullscreen()
 
 void Editor::reloadVolume()
 {
-	volumeManager.reloadVolume(volumeHandle);
-	setVolumeHandle(volumeHandle);
+	volumeManager.requestReload(volumeHandle);
 }
 
 void Editor::saveVolume()
 {
-	volumeManager.saveVolume(volumeHandle, bar_overwriteExisting);
+	volumeManager.saveVolume(volumeHandle, bar_overwriteExisting, bar_saveBricked, bar_saveCompressed);
 }
 
 void Editor::loadVolume()
 {
-	if(setVolumeHandle(volumeManager.loadVolume(bar_pathToExternVolume)))
-	{
-		setVolumeInAllViewports(volumeHandle);
-	}
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_FILE, bar_pathToExternVolume, getImportOptions()));
 }
 
 void Editor::importPVM()
 {
-	if(setVolumeHandle(volumeManager.importPVM(bar_pathToExternVolume)))
-	{
-		setVolumeInAllViewports(volumeHandle);
-	}
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_PVM, bar_pathToExternVolume, getImportOptions()));
 }
 
 void Editor::importDAT()
 {
-	if(setVolumeHandle(volumeManager.importDAT(bar_pathToExternVolume)))
-	{
-		setVolumeInAllViewports(volumeHandle);
-	}
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_DAT, bar_pathToExternVolume, getImportOptions()));
+}
+
+void Editor::importNRRD()
+{
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_NRRD, bar_pathToExternVolume, getImportOptions()));
+}
+
+void Editor::importMHD()
+{
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_MHD, bar_pathToExternVolume, getImportOptions()));
+}
+
+void Editor::importPNG()
+{
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_PNG, bar_pathToExternVolume, getImportOptions()));
+}
+
+void Editor::generateVolume()
+{
+	VolumeGeneratorSettings settings;
+	settings.field = bar_generatorField;
+	settings.resolution = bar_generatorResolution;
+	settings.valueResolution = bar_generatorValueResolution;
+	settings.emptyFraction = bar_generatorEmptyFraction;
+	settings.seed = static_cast<GLuint>(bar_generatorSeed);
+	pendingVolumeHandles.push_back(volumeManager.requestVolume(VOLUME_SOURCE_GENERATOR, VolumeGenerator::createSpecification(settings), getImportOptions()));
+}
+
+void Editor::cancelLoading()
+{
+	// Cancelled requests never finish
+	volumeManager.cancelLoading();
+	pendingVolumeHandles.clear();
+}
+
+VolumeImportOptions Editor::getImportOptions() const
+{
+	VolumeImportOptions importOptions;
+	importOptions.useRegion = bar_importRegion;
+	importOptions.regionOffset = bar_importRegionOffset;
+	importOptions.regionSize = bar_importRegionSize;
+	importOptions.quantize = bar_importQuantize;
+	importOptions.quantizationClipPercentage = bar_importClipPercentage;
+	importOptions.resample = bar_importResample;
+	importOptions.resampleSpacing = bar_importResampleSpacing;
+	importOptions.resampleVoxelBudget = static_cast<GLuint64>(bar_importResampleBudget) * 1000000;
+	importOptions.denoising = bar_importDenoising;
+	importOptions.denoisingSigma = bar_importDenoisingSigma;
+	importOptions.denoisingRangeSigma = bar_importDenoisingRangeSigma;
+	importOptions.precomputeGradients = bar_importGradients;
+	importOptions.gradients16Bit = bar_importGradients16Bit;
+	importOptions.pyramidReduction = bar_importPyramidReduction;
+	importOptions.textureByteBudget = static_cast<GLuint64>(bar_importTextureBudget) * 1024 * 1024;
+	return importOptions;
 }
 
 void Editor::forwardInputToBars(InputData inputData)
@@ -466,6 +598,36 @@ void Editor::setVolumeInAllViewports(GLint handle)
 	}
 }
 
+void Editor::useLoadedVolumes()
+{
+	std::vector<GLint> handles = volumeManager.update();
+
+	for(GLuint i = 0; i < handles.size(); i++)
+	{
+		std::vector<GLint>::iterator it = std::find(pendingVolumeHandles.begin(), pendingVolumeHandles.end(), handles[i]);
+		if(it != pendingVolumeHandles.end())
+		{
+			// Requested volume is ready
+			pendingVolumeHandles.erase(it);
+			if(setVolumeHandle(handles[i]))
+			{
+				setVolumeInAllViewports(volumeHandle);
+			}
+		}
+		else if(handles[i] == volumeHandle)
+		{
+			// Reloaded volume
+			setVolumeHandle(volumeHandle);
+		}
+	}
+
+	// Failed requests do not report back
+	if(!volumeManager.isLoading())
+	{
+		pendingVolumeHandles.clear();
+	}
+}
+
 void Editor::updateBarVariables()
 {
 	// Call update methods
@@ -556,12 +718,30 @@ void Editor::useBarVariables()
 
 void Editor::fillBarVariables()
 {
+	// Loading in background
+	bar_loadingVolume = volumeManager.getLoadingName();
+	bar_loadingProgress = 100.0f * volumeManager.getLoadingProgress();
+
+	GLuint64 bytesRead, bytesTotal;
+	volumeManager.getLoadingBytes(bytesRead, bytesTotal);
+	bar_loadingBytes = UT::to_string(static_cast<GLuint>(bytesRead / (1024 * 1024))) + " / " + UT::to_string(static_cast<GLuint>(bytesTotal / (1024 * 1024))) + " MB";
+	bar_loadingTimeLeft = static_cast<GLfloat>(glm::max(volumeManager.getLoadingTimeLeft(), 0.0));
+
 	// Volume name
 	if(volumeHandle >= 0)
 	{
 		Volume* pVolume = volumeManager.getVolume(volumeHandle);
 		bar_volumeName.setValue(pVolume->getName());
 
+		// Reduction of texture compared to volume on CPU
+		glm::vec3 textureResolution = pVolume->getTextureResolution();
+		glm::vec3 volumeResolution = pVolume->getVolumeResolution();
+		bar_volumeTextureResolution = UT::to_string(textureResolution.x) + " x " + UT::to_string(textureResolution.y) + " x " + UT::to_string(textureResolution.z);
+		if(textureResolution != volumeResolution)
+		{
+			bar_volumeTextureResolution += " of " + UT::to_string(volumeResolution.x) + " x " + UT::to_string(volumeResolution.y) + " x " + UT::to_string(volumeResolution.z);
+		}
+
 		VolumeProperties properties = volumeManager.getVolume(volumeHandle)->getProperties();
 		bar_volumeVoxelScaleMultiplier.setValue(properties.voxelScaleMultiplier);
 		bar_volumeValueOffset.setValue(properties.valueOffset);
@@ -621,3 +801,28 @@ static void TW_CALL importDATButtonCallback(void* clientData)
 	reinterpret_cast<Editor*>(clientData)->importDAT();
 }
 
+static void TW_CALL importNRRDButtonCallback(void* clientData)
+{
+	reinterpret_cast<Editor*>(clientData)->importNRRD();
+}
+
+static void TW_CALL importMHDButtonCallback(void* clientData)
+{
+	reinterpret_cast<Editor*>(clientData)->importMHD();
+}
+
+static void TW_CALL importPNGButtonCallback(void* clientData)
+{
+	reinterpret_cast<Editor*>(clientData)->importPNG();
+}
+
+static void TW_CALL generateVolumeButtonCallback(void* clientData)
+{
+	reinterpret_cast<Editor*>(clientData)->generateVolume();
+}
+
+static void TW_CALL cancelLoadingButtonCallback(void* clientData)
+{
+	reinterpret_cast<Editor*>(clientData)->cancelLoading();
+}
+
@@ -32,6 +32,9 @@
 #include "GLFW/glfw3.h"
 #include "AntTweakBar.h"
 
+#include <vector>
+#include <algorithm>
+
 #include "Logger.h"
 #include "Input.h"
 #include "ViewportManager.h"
@@ -63,7 +66,7 @@ public:
     ~Editor();
 
     /** Standard methods */
-    void init(GLint windowWidth, GLint windowHeight);
+    void init(GLint windowWidth, GLint windowHeight, GLint maxTextureResolution);
     EditorCallToApp update(GLfloat tpf, InputData inputData);
     void draw();
     void terminate();
@@ -79,8 +82,16 @@ public:
     void loadVolume();
     void importPVM();
     void importDAT();
+    void importNRRD();
+    void importMHD();
+    void importPNG();
+    void generateVolume();
+    void cancelLoading();
 
 protected:
+    /** Options for imports set in bar */
+    VolumeImportOptions getImportOptions() const;
+
     /** Bars want input, too */
     void forwardInputToBars(InputData inputData);
 
@@ -90,6 +101,9 @@ protected:
     /** Set volume in all viewports */
     void setVolumeInAllViewports(GLint handle);
 
+    /** Use volumes which were loaded in background */
+    void useLoadedVolumes();
+
     /** Update bar variables */
     void updateBarVariables();
 
@@ -129,7 +143,37 @@ protected:
     GLfloat bar_fps;
     std::string bar_pathToExternVolume;
     GLboolean bar_overwriteExisting;
+    GLboolean bar_saveBricked;
+    GLboolean bar_saveCompressed;
+    GLboolean bar_importRegion;
+    glm::ivec3 bar_importRegionOffset;
+    glm::ivec3 bar_importRegionSize;
+    GLboolean bar_importQuantize;
+    GLfloat bar_importClipPercentage;
+    GLboolean bar_importResample;
+    GLfloat bar_importResampleSpacing;
+    GLint bar_importResampleBudget;
+    VolumeDenoising bar_importDenoising;
+    GLfloat bar_importDenoisingSigma;
+    GLfloat bar_importDenoisingRangeSigma;
+    GLboolean bar_importGradients;
+    GLboolean bar_importGradients16Bit;
+    VolumePyramidReduction bar_importPyramidReduction;
+    GLint bar_importTextureBudget;
     GLboolean bar_setVolumeInAllViewports;
+    VolumeField bar_generatorField;
+    glm::ivec3 bar_generatorResolution;
+    VolumeValueResolution bar_generatorValueResolution;
+    GLfloat bar_generatorEmptyFraction;
+    GLint bar_generatorSeed;
+    std::string bar_loadingVolume;
+    GLfloat bar_loadingProgress;
+    std::string bar_loadingBytes;
+    std::string bar_volumeTextureResolution;
+    GLfloat bar_loadingTimeLeft;
+
+    /** Handles of requested volumes which are not ready yet */
+    std::vector<GLint> pendingVolumeHandles;
 
     /** Bar variables */
     BarVariable<GLint> bar_activeVolume;
@@ -169,5 +213,10 @@ static void TW_CALL saveVolumeButtonCallback(void* clientData);
 static void TW_CALL loadVolumeButtonCallback(void* clientData);
 static void TW_CALL importPVMButtonCallback(void* clientData);
 static void TW_CALL importDATButtonCallback(void* clientData);
+static void TW_CALL importNRRDButtonCallback(void* clientData);
+static void TW_CALL importMHDButtonCallback(void* clientData);
+static void TW_CALL importPNGButtonCallback(void* clientData);
+static void TW_CALL generateVolumeButtonCallback(void* clientData);
+static void TW_CALL cancelLoadingButtonCallback(void* clientData);
 
 #endif
@@ -0,0 +1,201 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "EmptySpaceMap.h"
+
+EmptySpaceMap::EmptySpaceMap() : done(false), cancelled(false)
+{
+    cellCount = glm::ivec3(0);
+    valueOffset = 0;
+    valueScale = 1;
+}
+
+EmptySpaceMap::~EmptySpaceMap()
+{
+    cancel();
+}
+
+void EmptySpaceMap::init(const std::vector<GLfloat>& cellExtrema, glm::ivec3 cellCount)
+{
+    cancel();
+    this->cellExtrema = cellExtrema;
+    this->cellCount = cellCount;
+
+    // Next update has to start computation for new cells
+    alphas.clear();
+    done = false;
+}
+
+GLboolean EmptySpaceMap::isInitialized() const
+{
+    return !cellExtrema.empty();
+}
+
+GLboolean EmptySpaceMap::update(const std::vector<GLfloat>& alphas, GLfloat valueOffset, GLfloat valueScale)
+{
+    if(!isInitialized() || (alphas == this->alphas && valueOffset == this->valueOffset && valueScale == this->valueScale))
+    {
+        return GL_FALSE;
+    }
+
+    cancel();
+    this->alphas = alphas;
+    this->valueOffset = valueOffset;
+    this->valueScale = valueScale;
+    done = false;
+    cancelled = false;
+
+    // Worker gets own copy of alphas, so they can be compared with next update meanwhile
+    worker = std::thread(&EmptySpaceMap::compute, this, alphas, valueOffset, valueScale);
+    return GL_TRUE;
+}
+
+void EmptySpaceMap::cancel()
+{
+    cancelled = true;
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+GLboolean EmptySpaceMap::isDone() const
+{
+    return done;
+}
+
+glm::ivec3 EmptySpaceMap::getCellCount() const
+{
+    return cellCount;
+}
+
+const std::vector<GLfloat>& EmptySpaceMap::getDistances() const
+{
+    return distances;
+}
+
+void EmptySpaceMap::compute(std::vector<GLfloat> alphas, GLfloat valueOffset, GLfloat valueScale)
+{
+    GLdouble startTime = glfwGetTime();
+    std::vector<GLfloat> result;
+    classifyCells(alphas, valueOffset, valueScale, result);
+
+    // Chebyshev distance is separable, when each pass takes maximum of its axis and previous passes
+    for(GLint axis = 0; axis < 3; axis++)
+    {
+        if(cancelled)
+        {
+            return;
+        }
+        transformAxis(result, axis);
+    }
+    if(cancelled)
+    {
+        return;
+    }
+
+    distances.swap(result);
+    done = true;
+
+    LogInfo("Empty space map of " + UT::to_string(static_cast<GLuint>(distances.size())) + " bricks computed in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+}
+
+void EmptySpaceMap::classifyCells(const std::vector<GLfloat>& rAlphas, GLfloat valueOffset, GLfloat valueScale, std::vector<GLfloat>& rDistances) const
+{
+    // Maximum of alpha between any two entries, like table of transferfunction
+    GLint resolution = static_cast<GLint>(rAlphas.size());
+    std::vector<GLfloat> maximumAlpha(static_cast<size_t>(resolution) * resolution);
+    for(GLint x = 0; x < resolution; x++)
+    {
+        GLfloat maximum = rAlphas[x];
+        for(GLint y = x; y < resolution; y++)
+        {
+            maximum = glm::max(maximum, rAlphas[y]);
+            maximumAlpha[x + resolution * y] = maximum;
+        }
+    }
+
+    // Same conservative lookup as raycaster does for single bricks
+    rDistances.resize(cellExtrema.size() / 2);
+    for(size_t i = 0; i < rDistances.size(); i++)
+    {
+        GLfloat first = cellExtrema[2 * i] * valueScale + valueOffset;
+        GLfloat second = cellExtrema[2 * i + 1] * valueScale + valueOffset;
+        GLfloat low = glm::min(first, second);
+        GLfloat high = glm::max(first, second);
+
+        // Transferfunction is mirrored below zero and values are clamped at one
+        high = glm::min(glm::max(high, -low), 1.0f);
+        low = glm::max(low, 0.0f);
+
+        GLint lowTexel = glm::clamp(static_cast<GLint>(glm::floor(low * resolution - 0.5f)), 0, resolution - 1);
+        GLint highTexel = glm::clamp(static_cast<GLint>(glm::ceil(high * resolution - 0.5f)), 0, resolution - 1);
+        GLboolean transparent = maximumAlpha[lowTexel + resolution * glm::max(lowTexel, highTexel)] < EMPTYSPACEMAP_ALPHA_THRESHOLD;
+        rDistances[i] = transparent ? static_cast<GLfloat>(EMPTYSPACEMAP_MAXIMUM_DISTANCE) : 0.0f;
+    }
+}
+
+void EmptySpaceMap::transformAxis(std::vector<GLfloat>& rDistances, GLint axis) const
+{
+    // Rows along axis are independent of each other
+    GLint length = cellCount[axis];
+    GLint otherA = cellCount[(axis + 1) % 3];
+    GLint otherB = cellCount[(axis + 2) % 3];
+    size_t strides[3] = {1, static_cast<size_t>(cellCount.x), static_cast<size_t>(cellCount.x) * cellCount.y};
+    size_t stride = strides[axis];
+    size_t strideA = strides[(axis + 1) % 3];
+    size_t strideB = strides[(axis + 2) % 3];
+
+    UT::parallelFor(0, static_cast<size_t>(otherA) * otherB, [&](size_t first, size_t last)
+    {
+        std::vector<GLfloat> row(length);
+        for(size_t r = first; r < last; r++)
+        {
+            if(cancelled)
+            {
+                return;
+            }
+
+            size_t start = (r % otherA) * strideA + (r / otherA) * strideB;
+            for(GLint i = 0; i < length; i++)
+            {
+                row[i] = rDistances[start + i * stride];
+            }
+
+            // Smallest maximum of offset and distance within row. Offsets beyond current best cannot improve it
+            for(GLint i = 0; i < length; i++)
+            {
+                GLfloat best = row[i];
+                for(GLint offset = 1; offset < best; offset++)
+                {
+                    GLfloat neighbour = std::numeric_limits<GLfloat>::max();
+                    if(i - offset >= 0)
+                    {
+                        neighbour = row[i - offset];
+                    }
+                    if(i + offset < length)
+                    {
+                        neighbour = glm::min(neighbour, row[i + offset]);
+                    }
+                    best = glm::min(best, glm::max(static_cast<GLfloat>(offset), neighbour));
+                }
+                rDistances[start + i * stride] = best;
+            }
+        }
+    });
+}
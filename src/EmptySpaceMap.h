@@ -0,0 +1,103 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * EmptySpaceMap
+ *--------------
+ * Chebyshev distance in cells to nearest cell which is
+ * not transparent under transferfunction. Cells are bricks
+ * with minimum and maximum value. Distances are computed
+ * in background by separable passes along each axis,
+ * whenever alpha or mapping of values changes.
+ *
+ */
+
+#ifndef EMPTYSPACEMAP_H_
+#define EMPTYSPACEMAP_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <limits>
+
+#include "Logger.h"
+#include "Utilities.h"
+
+const GLfloat EMPTYSPACEMAP_ALPHA_THRESHOLD = 0.001f;
+const GLint EMPTYSPACEMAP_MAXIMUM_DISTANCE = 16;
+
+class EmptySpaceMap
+{
+public:
+    EmptySpaceMap();
+    ~EmptySpaceMap();
+
+    /** Sets minimum and maximum per cell as pairs, in units of volume texture */
+    void init(const std::vector<GLfloat>& cellExtrema, glm::ivec3 cellCount);
+
+    /** Returns whether cells were set */
+    GLboolean isInitialized() const;
+
+    /** Starts computation in background if alphas or mapping of values differ from last call.
+        Returns whether computation was started */
+    GLboolean update(const std::vector<GLfloat>& alphas, GLfloat valueOffset, GLfloat valueScale);
+
+    /** Stops computation and waits for background thread */
+    void cancel();
+
+    /** Returns whether computation for last update is done */
+    GLboolean isDone() const;
+
+    /** Returns count of cells per axis */
+    glm::ivec3 getCellCount() const;
+
+    /** Distances in cells, capped at maximum distance. Only valid when done */
+    const std::vector<GLfloat>& getDistances() const;
+
+private:
+    /** Private copy constuctor */
+    EmptySpaceMap(EmptySpaceMap const&) {};
+
+    /** Private assignment operator */
+    EmptySpaceMap& operator=(EmptySpaceMap const&) {return *this;};
+
+    /** Computation, runs in background */
+    void compute(std::vector<GLfloat> alphas, GLfloat valueOffset, GLfloat valueScale);
+
+    /** Cells whose values are transparent get maximum distance, others zero */
+    void classifyCells(const std::vector<GLfloat>& rAlphas, GLfloat valueOffset, GLfloat valueScale, std::vector<GLfloat>& rDistances) const;
+
+    /** Pass along one axis, distance is maximum of distance along axis and distance of previous passes */
+    void transformAxis(std::vector<GLfloat>& rDistances, GLint axis) const;
+
+    std::vector<GLfloat> cellExtrema;
+    glm::ivec3 cellCount;
+    std::vector<GLfloat> alphas;
+    GLfloat valueOffset;
+    GLfloat valueScale;
+    std::thread worker;
+    std::atomic<bool> done;
+    std::atomic<bool> cancelled;
+    std::vector<GLfloat> distances;
+};
+
+#endif
@@ -0,0 +1,191 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "FileReader.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+FileReader::FileReader()
+{
+    size = 0;
+    position = 0;
+
+#ifdef _WIN32
+    fileHandle = NULL;
+#else
+    file = -1;
+#endif
+}
+
+FileReader::~FileReader()
+{
+    close();
+}
+
+GLboolean FileReader::open(std::string path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        return GL_FALSE;
+    }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(handle, &fileSize))
+    {
+        CloseHandle(handle);
+        return GL_FALSE;
+    }
+
+    fileHandle = handle;
+    size = static_cast<GLuint64>(fileSize.QuadPart);
+#else
+    file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0)
+    {
+        return GL_FALSE;
+    }
+
+    struct stat fileStatus;
+    if(fstat(file, &fileStatus) != 0)
+    {
+        ::close(file);
+        file = -1;
+        return GL_FALSE;
+    }
+    size = static_cast<GLuint64>(fileStatus.st_size);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Larger read ahead, not available everywhere
+    posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+
+    position = 0;
+    return GL_TRUE;
+}
+
+void FileReader::close()
+{
+#ifdef _WIN32
+    if(fileHandle != NULL)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = NULL;
+    }
+#else
+    if(file >= 0)
+    {
+        ::close(file);
+        file = -1;
+    }
+#endif
+
+    size = 0;
+    position = 0;
+}
+
+GLboolean FileReader::isOpen() const
+{
+#ifdef _WIN32
+    return fileHandle != NULL;
+#else
+    return file >= 0;
+#endif
+}
+
+GLuint64 FileReader::getSize() const
+{
+    return size;
+}
+
+GLuint64 FileReader::getPosition() const
+{
+    return position;
+}
+
+void FileReader::seek(GLuint64 position)
+{
+    this->position = position;
+}
+
+size_t FileReader::read(GLubyte* pData, size_t size, std::function<bool(size_t)> blockRead)
+{
+    size_t offset = 0;
+    while(offset < size)
+    {
+        // First block ends at next aligned offset, so following ones start at aligned offsets
+        size_t block = static_cast<size_t>(FILEREADER_BLOCK_SIZE - (position % FILEREADER_BLOCK_SIZE));
+        block = (size - offset < block) ? size - offset : block;
+
+        size_t blockSize = readBlock(pData + offset, block);
+        offset += blockSize;
+        position += blockSize;
+
+        if(blockSize != block || (blockRead && !blockRead(blockSize)))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
+size_t FileReader::readBlock(GLubyte* pData, size_t size)
+{
+    if(!isOpen())
+    {
+        return 0;
+    }
+
+    size_t offset = 0;
+    while(offset < size)
+    {
+#ifdef _WIN32
+        // Position is given with every read, like pread does
+        OVERLAPPED overlapped = {};
+        GLuint64 readPosition = position + offset;
+        overlapped.Offset = static_cast<DWORD>(readPosition & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(readPosition >> 32);
+        DWORD count = 0;
+        if(!ReadFile(fileHandle, pData + offset, static_cast<DWORD>(size - offset), &count, &overlapped) || count == 0)
+        {
+            break;
+        }
+#else
+        // Reads may return less than requested, e.g. when interrupted
+        ssize_t count = pread(file, pData + offset, size - offset, static_cast<off_t>(position + offset));
+        if(count <= 0)
+        {
+            break;
+        }
+#endif
+        offset += static_cast<size_t>(count);
+    }
+    return offset;
+}
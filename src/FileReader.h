@@ -0,0 +1,87 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * FileReader
+ *--------------
+ * Reads files sequentially in large blocks which are
+ * aligned to offsets in the file. Operating system is
+ * told about sequential access, so it reads ahead.
+ *
+ */
+
+#ifndef FILEREADER_H_
+#define FILEREADER_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+
+#include <string>
+#include <functional>
+
+const size_t FILEREADER_BLOCK_SIZE = 8 * 1024 * 1024;
+
+class FileReader
+{
+public:
+    FileReader();
+    ~FileReader();
+
+    /** Opens file for sequential reading, returns whether successful */
+    GLboolean open(std::string path);
+
+    /** Closes file, done by destructor, too */
+    void close();
+
+    /** Returns whether file is open */
+    GLboolean isOpen() const;
+
+    /** Returns size of file in bytes */
+    GLuint64 getSize() const;
+
+    /** Returns position of next read */
+    GLuint64 getPosition() const;
+
+    /** Sets position of next read */
+    void seek(GLuint64 position);
+
+    /** Reads up to size bytes block by block. Callback gets size of each block and
+        stops reading by returning false. Returns count of bytes actually read */
+    size_t read(GLubyte* pData, size_t size, std::function<bool(size_t)> blockRead = std::function<bool(size_t)>());
+
+private:
+    /** Private copy constuctor */
+    FileReader(FileReader const&) {};
+
+    /** Private assignment operator */
+    FileReader& operator=(FileReader const&) {return *this;};
+
+    /** Reads once at position, returns count of bytes read */
+    size_t readBlock(GLubyte* pData, size_t size);
+
+    GLuint64 size;
+    GLuint64 position;
+
+#ifdef _WIN32
+    void* fileHandle;
+#else
+    GLint file;
+#endif
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "GradientVolume.h"
+
+GradientVolume::GradientVolume() : done(false), cancelled(false)
+{
+    started = GL_FALSE;
+    use16Bit = GL_FALSE;
+}
+
+GradientVolume::~GradientVolume()
+{
+    cancel();
+}
+
+void GradientVolume::start(const GLubyte* pData, glm::vec3 volumeResolution, glm::vec3 textureResolution, VolumeValueResolution valueResolution, GLboolean use16Bit)
+{
+    cancel();
+    this->use16Bit = use16Bit;
+    started = GL_TRUE;
+    done = false;
+    cancelled = false;
+    gradients.clear();
+
+    worker = std::thread(&GradientVolume::compute, this, pData, volumeResolution, textureResolution, valueResolution);
+}
+
+GLboolean GradientVolume::isStarted() const
+{
+    return started;
+}
+
+void GradientVolume::cancel()
+{
+    cancelled = true;
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+GLboolean GradientVolume::isDone() const
+{
+    return done;
+}
+
+GLboolean GradientVolume::is16Bit() const
+{
+    return use16Bit;
+}
+
+const std::vector<GLubyte>& GradientVolume::getGradients() const
+{
+    return gradients;
+}
+
+void GradientVolume::clear()
+{
+    std::vector<GLubyte>().swap(gradients);
+}
+
+void GradientVolume::compute(const GLubyte* pData, glm::vec3 volumeResolution, glm::vec3 textureResolution, VolumeValueResolution valueResolution)
+{
+    GLdouble startTime = glfwGetTime();
+    std::vector<GLubyte> result;
+    if(textureResolution != volumeResolution)
+    {
+        // Gradients have resolution of downsampled texture
+        std::vector<GLubyte> values(static_cast<size_t>(getVoxelCount(textureResolution)) * getBytesPerVoxel(valueResolution));
+        VolumeProcessor::resample(pData, volumeResolution, &values[0], textureResolution, valueResolution);
+        if(cancelled)
+        {
+            return;
+        }
+        VolumeProcessor::computeGradients(&values[0], textureResolution, valueResolution, use16Bit, result);
+    }
+    else
+    {
+        VolumeProcessor::computeGradients(pData, volumeResolution, valueResolution, use16Bit, result);
+    }
+    if(cancelled)
+    {
+        return;
+    }
+
+    gradients.swap(result);
+    done = true;
+
+    LogInfo("Gradients computed in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+}
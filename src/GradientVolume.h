@@ -0,0 +1,90 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * GradientVolume
+ *--------------
+ * Packed gradients of volume, computed in background
+ * when they were not precomputed while loading. Volume
+ * is resampled to resolution of its texture first, if
+ * texture was downsampled.
+ *
+ */
+
+#ifndef GRADIENTVOLUME_H_
+#define GRADIENTVOLUME_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "Logger.h"
+#include "VolumeProperties.h"
+#include "VolumeProcessor.h"
+#include "Utilities.h"
+
+class GradientVolume
+{
+public:
+    GradientVolume();
+    ~GradientVolume();
+
+    /** Starts computation in background, data must stay valid until done or cancelled */
+    void start(const GLubyte* pData, glm::vec3 volumeResolution, glm::vec3 textureResolution, VolumeValueResolution valueResolution, GLboolean use16Bit);
+
+    /** Returns whether computation was started */
+    GLboolean isStarted() const;
+
+    /** Stops computation and waits for background thread */
+    void cancel();
+
+    /** Returns whether computation is done */
+    GLboolean isDone() const;
+
+    /** Returns whether components have 16 bit */
+    GLboolean is16Bit() const;
+
+    /** Packed gradients with resolution of texture. Only valid when done */
+    const std::vector<GLubyte>& getGradients() const;
+
+    /** Frees gradients, when they are uploaded */
+    void clear();
+
+private:
+    /** Private copy constuctor */
+    GradientVolume(GradientVolume const&) {};
+
+    /** Private assignment operator */
+    GradientVolume& operator=(GradientVolume const&) {return *this;};
+
+    /** Computation, runs in background */
+    void compute(const GLubyte* pData, glm::vec3 volumeResolution, glm::vec3 textureResolution, VolumeValueResolution valueResolution);
+
+    GLboolean started;
+    GLboolean use16Bit;
+    std::thread worker;
+    std::atomic<bool> done;
+    std::atomic<bool> cancelled;
+    std::vector<GLubyte> gradients;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "JointHistogram.h"
+
+JointHistogram::JointHistogram() : done(false), cancelled(false), progress(0)
+{
+    maximumGradientMagnitude = 0;
+}
+
+JointHistogram::~JointHistogram()
+{
+    cancel();
+}
+
+void JointHistogram::start(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution)
+{
+    cancel();
+    this->volumeResolution = glm::ivec3(volumeResolution);
+    done = false;
+    cancelled = false;
+    progress = 0;
+
+    // Decide type once instead of per voxel
+    worker = std::thread([this, pData, valueResolution]()
+    {
+        switch(valueResolution)
+        {
+        case VOLUME_8BIT:
+            compute(pData);
+            break;
+        case VOLUME_16BIT:
+            compute(reinterpret_cast<const GLushort*>(pData));
+            break;
+        case VOLUME_16BIT_SIGNED:
+            compute(reinterpret_cast<const GLshort*>(pData));
+            break;
+        case VOLUME_32BIT_FLOAT:
+            compute(reinterpret_cast<const GLfloat*>(pData));
+            break;
+        }
+    });
+}
+
+void JointHistogram::cancel()
+{
+    cancelled = true;
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+GLboolean JointHistogram::isDone() const
+{
+    return done;
+}
+
+GLfloat JointHistogram::getProgress() const
+{
+    return progress;
+}
+
+const std::vector<GLfloat>& JointHistogram::getLogScaledBins() const
+{
+    return logScaledBins;
+}
+
+GLfloat JointHistogram::getMaximumGradientMagnitude() const
+{
+    return maximumGradientMagnitude;
+}
+
+template<typename T> void JointHistogram::compute(const T* pData)
+{
+    GLdouble startTime = glfwGetTime();
+    std::vector<GLuint64> fineBins(static_cast<size_t>(JOINTHISTOGRAM_VALUE_BIN_COUNT) * JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT, 0);
+    std::mutex mutex;
+
+    // Steps of slices, so cancelling does not have to wait for whole volume. Steps are large compared to bins of each thread
+    GLuint64 sliceSize = static_cast<GLuint64>(volumeResolution.x) * volumeResolution.y;
+    GLint slicesPerStep = static_cast<GLint>(glm::max(JOINTHISTOGRAM_VOXELS_PER_STEP / sliceSize, static_cast<GLuint64>(1)));
+    for(GLint step = 0; step < volumeResolution.z; step += slicesPerStep)
+    {
+        if(cancelled)
+        {
+            return;
+        }
+
+        GLint stepEnd = glm::min(step + slicesPerStep, volumeResolution.z);
+        UT::parallelFor(step, stepEnd, [&](size_t first, size_t last)
+        {
+            std::vector<GLuint> bins(fineBins.size(), 0);
+            accumulateSlices(pData, static_cast<GLint>(first), static_cast<GLint>(last), bins);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for(size_t i = 0; i < bins.size(); i++)
+            {
+                fineBins[i] += bins[i];
+            }
+        });
+
+        progress = static_cast<GLfloat>(stepEnd) / static_cast<GLfloat>(volumeResolution.z);
+    }
+
+    finish(fineBins);
+    done = true;
+
+    LogInfo("Joint histogram of value and gradient magnitude computed in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+}
+
+template<typename T> void JointHistogram::accumulateSlices(const T* pData, GLint firstSlice, GLint lastSlice, std::vector<GLuint>& rBins) const
+{
+    size_t rowSize = static_cast<size_t>(volumeResolution.x);
+    size_t sliceSize = rowSize * volumeResolution.y;
+
+    // Central differences of values from zero to one are at most one half per axis, one sided ones at borders are clamped into last bin
+    const GLdouble gradientScale = static_cast<GLdouble>(JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT - 1) / glm::sqrt(0.75);
+    const GLdouble valueScale = static_cast<GLdouble>(JOINTHISTOGRAM_VALUE_BIN_COUNT - 1);
+
+    for(GLint z = firstSlice; z < lastSlice; z++)
+    {
+        // Neighbours at the border are clamped
+        const T* pSlice = pData + z * sliceSize;
+        const T* pPreviousSlice = pData + glm::max(z - 1, 0) * sliceSize;
+        const T* pNextSlice = pData + glm::min(z + 1, volumeResolution.z - 1) * sliceSize;
+        GLdouble zDistance = glm::max(glm::min(z + 1, volumeResolution.z - 1) - glm::max(z - 1, 0), 1);
+
+        for(GLint y = 0; y < volumeResolution.y; y++)
+        {
+            const T* pRow = pSlice + y * rowSize;
+            const T* pPreviousRow = pSlice + glm::max(y - 1, 0) * rowSize;
+            const T* pNextRow = pSlice + glm::min(y + 1, volumeResolution.y - 1) * rowSize;
+            GLdouble yDistance = glm::max(glm::min(y + 1, volumeResolution.y - 1) - glm::max(y - 1, 0), 1);
+
+            for(GLint x = 0; x < volumeResolution.x; x++)
+            {
+                GLint previousX = glm::max(x - 1, 0);
+                GLint nextX = glm::min(x + 1, volumeResolution.x - 1);
+                GLdouble xDistance = glm::max(nextX - previousX, 1);
+
+                glm::dvec3 gradient(
+                    (VoxelTraits<T>::value(pRow[nextX]) - VoxelTraits<T>::value(pRow[previousX])) / xDistance,
+                    (VoxelTraits<T>::value(pNextRow[x]) - VoxelTraits<T>::value(pPreviousRow[x])) / yDistance,
+                    (VoxelTraits<T>::value(pNextSlice[y * rowSize + x]) - VoxelTraits<T>::value(pPreviousSlice[y * rowSize + x])) / zDistance);
+
+                size_t valueBin = static_cast<size_t>(VoxelTraits<T>::value(pRow[x]) * valueScale + 0.5);
+                size_t gradientBin = static_cast<size_t>(glm::min(glm::length(gradient) * gradientScale, static_cast<GLdouble>(JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT - 1)));
+                rBins[gradientBin * JOINTHISTOGRAM_VALUE_BIN_COUNT + valueBin]++;
+            }
+        }
+    }
+}
+
+void JointHistogram::finish(const std::vector<GLuint64>& rFineBins)
+{
+    // Find fine row at percentile, few steep edges would squeeze everything else into first rows
+    std::vector<GLuint64> rowCounts(JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT, 0);
+    GLuint64 total = 0;
+    for(size_t i = 0; i < rFineBins.size(); i++)
+    {
+        rowCounts[i / JOINTHISTOGRAM_VALUE_BIN_COUNT] += rFineBins[i];
+        total += rFineBins[i];
+    }
+    GLuint64 percentileCount = static_cast<GLuint64>(static_cast<GLdouble>(total) * JOINTHISTOGRAM_GRADIENT_PERCENTILE / 100.0);
+    GLuint fineRowCount = 1;
+    GLuint64 cumulated = 0;
+    for(GLuint i = 0; i < JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT; i++)
+    {
+        cumulated += rowCounts[i];
+        fineRowCount = i + 1;
+        if(cumulated >= percentileCount)
+        {
+            break;
+        }
+    }
+    maximumGradientMagnitude = static_cast<GLfloat>(fineRowCount * glm::sqrt(0.75) / (JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT - 1));
+
+    // Fine rows above percentile end up in last row
+    std::vector<GLuint64> bins(static_cast<size_t>(JOINTHISTOGRAM_VALUE_BIN_COUNT) * JOINTHISTOGRAM_GRADIENT_BIN_COUNT, 0);
+    for(GLuint fineRow = 0; fineRow < JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT; fineRow++)
+    {
+        GLuint row = glm::min(fineRow * JOINTHISTOGRAM_GRADIENT_BIN_COUNT / fineRowCount, JOINTHISTOGRAM_GRADIENT_BIN_COUNT - 1);
+        for(GLuint i = 0; i < JOINTHISTOGRAM_VALUE_BIN_COUNT; i++)
+        {
+            bins[row * JOINTHISTOGRAM_VALUE_BIN_COUNT + i] += rFineBins[fineRow * JOINTHISTOGRAM_VALUE_BIN_COUNT + i];
+        }
+    }
+
+    // Logarithm keeps sparse boundaries visible next to large homogeneous regions
+    GLuint64 maximum = 1;
+    for(size_t i = 0; i < bins.size(); i++)
+    {
+        maximum = glm::max(maximum, bins[i]);
+    }
+    GLdouble logMaximum = glm::log(1.0 + static_cast<GLdouble>(maximum));
+    logScaledBins.resize(bins.size());
+    for(size_t i = 0; i < bins.size(); i++)
+    {
+        logScaledBins[i] = static_cast<GLfloat>(glm::log(1.0 + static_cast<GLdouble>(bins[i])) / logMaximum);
+    }
+}
@@ -0,0 +1,100 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * JointHistogram
+ *--------------
+ * Histogram of value versus gradient magnitude,
+ * computed with central differences in background.
+ * Slices are processed in steps, each step runs on
+ * all threads with own bins. Result is log scaled for display.
+ *
+ */
+
+#ifndef JOINTHISTOGRAM_H_
+#define JOINTHISTOGRAM_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+#include "Logger.h"
+#include "VolumeProperties.h"
+#include "Utilities.h"
+
+const GLuint JOINTHISTOGRAM_VALUE_BIN_COUNT = 256;
+const GLuint JOINTHISTOGRAM_GRADIENT_BIN_COUNT = 256;
+const GLuint JOINTHISTOGRAM_FINE_GRADIENT_BIN_COUNT = 1024;
+const GLuint64 JOINTHISTOGRAM_VOXELS_PER_STEP = 64 * 1024 * 1024;
+const GLfloat JOINTHISTOGRAM_GRADIENT_PERCENTILE = 99.5f;
+
+class JointHistogram
+{
+public:
+    JointHistogram();
+    ~JointHistogram();
+
+    /** Starts computation in background, data must stay valid until done or cancelled */
+    void start(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution);
+
+    /** Stops computation and waits for background thread */
+    void cancel();
+
+    /** Returns whether computation is done */
+    GLboolean isDone() const;
+
+    /** Returns progress between zero and one */
+    GLfloat getProgress() const;
+
+    /** Log scaled counts between zero and one, values along rows and gradient magnitudes along columns. Only valid when done */
+    const std::vector<GLfloat>& getLogScaledBins() const;
+
+    /** Gradient magnitude of upper border of last row, values are mapped from zero to one. Only valid when done */
+    GLfloat getMaximumGradientMagnitude() const;
+
+private:
+    /** Private copy constuctor */
+    JointHistogram(JointHistogram const&) {};
+
+    /** Private assignment operator */
+    JointHistogram& operator=(JointHistogram const&) {return *this;};
+
+    /** Computation for one type of voxels, runs in background */
+    template<typename T> void compute(const T* pData);
+
+    /** Adds slices to fine bins, gradient magnitudes are binned up to largest possible one */
+    template<typename T> void accumulateSlices(const T* pData, GLint firstSlice, GLint lastSlice, std::vector<GLuint>& rBins) const;
+
+    /** Reduces fine bins to log scaled bins, which end at percentile of gradient magnitudes */
+    void finish(const std::vector<GLuint64>& rFineBins);
+
+    glm::ivec3 volumeResolution;
+    std::thread worker;
+    std::atomic<bool> done;
+    std::atomic<bool> cancelled;
+    std::atomic<GLfloat> progress;
+    std::vector<GLfloat> logScaledBins;
+    GLfloat maximumGradientMagnitude;
+};
+
+#endif
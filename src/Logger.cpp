@@ -44,6 +44,10 @@ void Logger::print(LogType type, std::string text)
         return;
     }
 
+    // Volumes are prepared by worker threads which log, too
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
     // Exists an instance?
     if(pInstance == NULL)
     {
@@ -31,6 +31,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <mutex>
 
 /** Defines for easier access */
 #define LogInfo(s) Logger::print(LOG_INFO, s);
@@ -0,0 +1,245 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+
+#include "RawData.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+RawData::RawData()
+{
+    pData = NULL;
+    size = 0;
+    pAllocation = NULL;
+    pMapping = NULL;
+    mappingSize = 0;
+
+#ifdef _WIN32
+    fileHandle = NULL;
+    mappingHandle = NULL;
+#endif
+}
+
+RawData::~RawData()
+{
+    release();
+}
+
+GLboolean RawData::allocate(size_t size)
+{
+    release();
+
+    pAllocation = (GLubyte*)calloc(size, sizeof(GLubyte));
+    if(pAllocation == NULL)
+    {
+        LogError("Allocation of " + UT::to_string(static_cast<GLdouble>(size) / 1048576.0) + " MB failed!");
+        return GL_FALSE;
+    }
+
+    pData = pAllocation;
+    this->size = size;
+    return GL_TRUE;
+}
+
+void RawData::adopt(GLubyte* pAllocation, size_t offset, size_t size)
+{
+    release();
+
+    this->pAllocation = pAllocation;
+    pData = pAllocation + offset;
+    this->size = size;
+}
+
+GLboolean RawData::map(std::string path, size_t offset, size_t size)
+{
+    release();
+
+    if(size == 0)
+    {
+        return GL_FALSE;
+    }
+
+#ifdef _WIN32
+    // Mapping has to start at multiple of allocation granularity
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    size_t alignedOffset = offset - (offset % systemInfo.dwAllocationGranularity);
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        return GL_FALSE;
+    }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || static_cast<unsigned long long>(fileSize.QuadPart) < static_cast<unsigned long long>(offset + size))
+    {
+        CloseHandle(file);
+        return GL_FALSE;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mapping == NULL)
+    {
+        CloseHandle(file);
+        return GL_FALSE;
+    }
+
+    unsigned long long offset64 = static_cast<unsigned long long>(alignedOffset);
+    mappingSize = size + (offset - alignedOffset);
+    pMapping = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset64 >> 32), static_cast<DWORD>(offset64 & 0xFFFFFFFF), mappingSize);
+    if(pMapping == NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        mappingSize = 0;
+        return GL_FALSE;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+#else
+    // Mapping has to start at page boundary
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t alignedOffset = offset - (offset % pageSize);
+
+    GLint file = open(path.c_str(), O_RDONLY);
+    if(file < 0)
+    {
+        return GL_FALSE;
+    }
+
+    struct stat fileStatus;
+    if(fstat(file, &fileStatus) != 0 || static_cast<size_t>(fileStatus.st_size) < offset + size)
+    {
+        close(file);
+        return GL_FALSE;
+    }
+
+    mappingSize = size + (offset - alignedOffset);
+    void* pResult = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, file, static_cast<off_t>(alignedOffset));
+
+    // Mapping stays valid after closing the file descriptor
+    close(file);
+
+    if(pResult == MAP_FAILED)
+    {
+        mappingSize = 0;
+        return GL_FALSE;
+    }
+    pMapping = pResult;
+#endif
+
+    pData = reinterpret_cast<GLubyte*>(pMapping) + (offset - alignedOffset);
+    this->size = size;
+    mappedPath = path;
+
+    return GL_TRUE;
+}
+
+void RawData::advise(RawDataAccessPattern pattern) const
+{
+#ifndef _WIN32
+    if(pMapping == NULL)
+    {
+        return;
+    }
+
+    switch(pattern)
+    {
+        case RAWDATA_ACCESS_NORMAL:
+            madvise(pMapping, mappingSize, MADV_NORMAL);
+            break;
+        case RAWDATA_ACCESS_SEQUENTIAL:
+            // Read ahead aggressively and start fetching right now
+            madvise(pMapping, mappingSize, MADV_SEQUENTIAL);
+            madvise(pMapping, mappingSize, MADV_WILLNEED);
+            break;
+        case RAWDATA_ACCESS_RANDOM:
+            madvise(pMapping, mappingSize, MADV_RANDOM);
+            break;
+    }
+#endif
+
+    // Windows mappings were opened for sequential scan already
+}
+
+const GLubyte* RawData::getData() const
+{
+    return pData;
+}
+
+GLubyte* RawData::getWritableData()
+{
+    if(pMapping != NULL)
+    {
+        return NULL;
+    }
+    return pData;
+}
+
+size_t RawData::getSize() const
+{
+    return size;
+}
+
+GLboolean RawData::isMapped() const
+{
+    return (pMapping != NULL);
+}
+
+std::string RawData::getMappedPath() const
+{
+    return mappedPath;
+}
+
+void RawData::release()
+{
+    if(pMapping != NULL)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(pMapping);
+        CloseHandle(reinterpret_cast<HANDLE>(mappingHandle));
+        CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+        mappingHandle = NULL;
+        fileHandle = NULL;
+#else
+        munmap(pMapping, mappingSize);
+#endif
+        pMapping = NULL;
+        mappingSize = 0;
+        mappedPath.clear();
+    }
+    else
+    {
+        free(pAllocation);
+        pAllocation = NULL;
+    }
+
+    pData = NULL;
+    size = 0;
+}
@@ -0,0 +1,108 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * RawData
+ *--------------
+ * Owner of raw volume data. Data is either allocated
+ * on the heap or a read-only mapping of a file.
+ *
+ */
+
+#ifndef RAWDATA_H_
+#define RAWDATA_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+
+#include <string>
+#include <cstdlib>
+
+#include "Logger.h"
+#include "Utilities.h"
+
+enum RawDataAccessPattern
+{
+    RAWDATA_ACCESS_NORMAL, RAWDATA_ACCESS_SEQUENTIAL, RAWDATA_ACCESS_RANDOM
+};
+
+class RawData
+{
+public:
+    RawData();
+    ~RawData();
+
+    /** Allocates zero initialized memory, returns whether successful */
+    GLboolean allocate(size_t size);
+
+    /** Takes ownership of memory allocated by malloc, data starts at offset */
+    void adopt(GLubyte* pAllocation, size_t offset, size_t size);
+
+    /** Maps part of file read-only, returns whether successful */
+    GLboolean map(std::string path, size_t offset, size_t size);
+
+    /** Hint for upcoming access, only used by mappings */
+    void advise(RawDataAccessPattern pattern) const;
+
+    /** Returns pointer to data */
+    const GLubyte* getData() const;
+
+    /** Returns pointer to data, NULL for mappings */
+    GLubyte* getWritableData();
+
+    /** Returns size of data in bytes */
+    size_t getSize() const;
+
+    /** Returns whether data is mapped from file */
+    GLboolean isMapped() const;
+
+    /** Returns path of mapped file, empty for allocated memory */
+    std::string getMappedPath() const;
+
+protected:
+    /** Frees memory or unmaps file */
+    void release();
+
+    /** Private copy constuctor */
+    RawData(RawData const&) {};
+
+    /** Private assignment operator */
+    RawData& operator=(RawData const&) {return *this;};
+
+    /** Pointer to first byte of data */
+    GLubyte* pData;
+
+    /** Size of data in bytes */
+    size_t size;
+
+    /** Start of heap memory, may be in front of data */
+    GLubyte* pAllocation;
+
+    /** Mapping has to start at page boundary, so remember real start */
+    void* pMapping;
+    size_t mappingSize;
+    std::string mappedPath;
+
+#ifdef _WIN32
+    /** Windows needs handles of file and mapping */
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif
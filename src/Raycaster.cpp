@@ -35,6 +35,9 @@ Raycaster::Raycaster()
     usePreintegration = RAYCASTER_USE_PREINTEGRATION;
     useAdaptiveSampling = RAYCASTER_USE_ADAPTIVE_SAMPLING;
     useVoxelSpacedSampling = RAYCASTER_USE_VOXEL_SPACED_SAMPLING;
+    useGradientVolume = RAYCASTER_USE_GRADIENT_VOLUME;
+    useBrickESS = RAYCASTER_USE_BRICK_ESS;
+    useDistanceESS = RAYCASTER_USE_DISTANCE_ESS;
 }
 
 Raycaster::~Raycaster()
@@ -69,8 +72,12 @@ void Raycaster::init(GLint handle, std::string name)
 void Raycaster::draw(
         GLint volumeTextureHandle,
         GLint importanceVolumeTextureHandle,
+        GLint gradientVolumeTextureHandle,
+        GLint brickExtremaTextureHandle,
+        GLint emptySpaceMapTextureHandle,
         glm::vec3 volumeScale,
-        glm::vec3 volumeResolution,
+        glm::vec3 textureResolution,
+        glm::vec3 brickGridScale,
         VolumeProperties volumeProperties,
         GLfloat aspectRatio,
         GLfloat fieldOfView,
@@ -86,6 +93,7 @@ void Raycaster::draw(
         GLint colorAlphaPreintegrationHandle,
         GLint ambientSpecularPreintegrationHandle,
         GLint advancedPreintegrationHandle,
+        GLint maximumAlphaHandle,
         GLint tfResolution,
         GLint reflectionHandle,
         glm::vec3 volumeExtent,
@@ -249,7 +257,29 @@ void Raycaster::draw(
 
     if(useVoxelSpacedSampling)
     {
-        shader.setUniformValue(uniformVolumeResolutionHandle, volumeResolution);
+        shader.setUniformValue(uniformTextureResolutionHandle, textureResolution);
+    }
+
+    if(useBrickESS || useDistanceESS)
+    {
+        shader.setUniformValue(uniformBrickGridScaleHandle, brickGridScale);
+    }
+
+    if(useBrickESS)
+    {
+        shader.setUniformTexture(uniformBrickExtremaHandle, brickExtremaTextureHandle, GL_TEXTURE_3D);
+        shader.setUniformTexture(uniformMaximumAlphaHandle, maximumAlphaHandle, GL_TEXTURE_2D);
+    }
+
+    if(useDistanceESS)
+    {
+        shader.setUniformTexture(uniformEmptySpaceMapHandle, emptySpaceMapTextureHandle, GL_TEXTURE_3D);
+    }
+
+    if(useGradientVolume)
+    {
+        shader.setUniformTexture(uniformGradientVolumeHandle, gradientVolumeTextureHandle, GL_TEXTURE_3D);
+        shader.setUniformValue(uniformGradientVolumeReadyHandle, gradientVolumeTextureHandle != 0 ? 1 : 0);
     }
 
     // Draw it
@@ -538,6 +568,57 @@ void Raycaster::setUseVoxelSpacedSampling(GLboolean useVoxelSpacedSampling)
     }
 }
 
+GLboolean Raycaster::getUseGradientVolume() const
+{
+    return useGradientVolume;
+}
+
+void Raycaster::setUseGradientVolume(GLboolean useGradientVolume)
+{
+    GLboolean previous = this->useGradientVolume;
+    this->useGradientVolume = useGradientVolume;
+
+    // Only reload shader if necessary
+    if(this->useGradientVolume != previous)
+    {
+        shaderShouldBeReloaded = GL_TRUE;
+    }
+}
+
+GLboolean Raycaster::getUseBrickESS() const
+{
+    return useBrickESS;
+}
+
+void Raycaster::setUseBrickESS(GLboolean useBrickESS)
+{
+    GLboolean previous = this->useBrickESS;
+    this->useBrickESS = useBrickESS;
+
+    // Only reload shader if necessary
+    if(this->useBrickESS != previous)
+    {
+        shaderShouldBeReloaded = GL_TRUE;
+    }
+}
+
+GLboolean Raycaster::getUseDistanceESS() const
+{
+    return useDistanceESS;
+}
+
+void Raycaster::setUseDistanceESS(GLboolean useDistanceESS)
+{
+    GLboolean previous = this->useDistanceESS;
+    this->useDistanceESS = useDistanceESS;
+
+    // Only reload shader if necessary
+    if(this->useDistanceESS != previous)
+    {
+        shaderShouldBeReloaded = GL_TRUE;
+    }
+}
+
 void Raycaster::reloadShader()
 {
     // Define vectors
@@ -574,6 +655,16 @@ void Raycaster::reloadShader()
         fragmentDefines.push_back("USE_SIMPLE_ESS");
     }
 
+    if(useBrickESS)
+    {
+        fragmentDefines.push_back("USE_BRICK_ESS");
+    }
+
+    if(useDistanceESS)
+    {
+        fragmentDefines.push_back("USE_DISTANCE_ESS");
+    }
+
     if(useGradientAlphaMultiplier)
     {
         fragmentDefines.push_back("USE_GRADIENT_ALPHA_MULTIPLIER");
@@ -619,6 +710,12 @@ void Raycaster::reloadShader()
         fragmentDefines.push_back("USE_VOXEL_SPACED_SAMPLING");
     }
 
+    // Precomputed gradients take central differences of neighbouring voxels, so normal range multiplier has no effect on them
+    if(useGradientVolume)
+    {
+        fragmentDefines.push_back("USE_GRADIENT_VOLUME");
+    }
+
     // Load shaders
     shader.loadShaders("Raycaster.vert", "Raycaster.frag", vertexDefines, fragmentDefines);
     shader.setVertexBuffer(primitives::cube, sizeof(primitives::cube), "positionAttribute");
@@ -690,7 +787,29 @@ void Raycaster::reloadShader()
 
     if(useVoxelSpacedSampling)
     {
-        uniformVolumeResolutionHandle = shader.getUniformHandle("uniformVolumeResolution");
+        uniformTextureResolutionHandle = shader.getUniformHandle("uniformTextureResolution");
+    }
+
+    if(useBrickESS || useDistanceESS)
+    {
+        uniformBrickGridScaleHandle = shader.getUniformHandle("uniformBrickGridScale");
+    }
+
+    if(useBrickESS)
+    {
+        uniformBrickExtremaHandle = shader.getUniformHandle("uniformBrickExtrema");
+        uniformMaximumAlphaHandle = shader.getUniformHandle("uniformMaximumAlpha");
+    }
+
+    if(useDistanceESS)
+    {
+        uniformEmptySpaceMapHandle = shader.getUniformHandle("uniformEmptySpaceMap");
+    }
+
+    if(useGradientVolume)
+    {
+        uniformGradientVolumeHandle = shader.getUniformHandle("uniformGradientVolume");
+        uniformGradientVolumeReadyHandle = shader.getUniformHandle("uniformGradientVolumeReady");
     }
 }
 
@@ -58,6 +58,9 @@ const GLboolean RAYCASTER_USE_EXTENT_AWARE_NORMALS = GL_FALSE;
 const GLboolean RAYCASTER_USE_PREINTEGRATION = GL_FALSE;
 const GLboolean RAYCASTER_USE_ADAPTIVE_SAMPLING = GL_FALSE;
 const GLboolean RAYCASTER_USE_VOXEL_SPACED_SAMPLING = GL_FALSE;
+const GLboolean RAYCASTER_USE_GRADIENT_VOLUME = GL_FALSE;
+const GLboolean RAYCASTER_USE_BRICK_ESS = GL_FALSE;
+const GLboolean RAYCASTER_USE_DISTANCE_ESS = GL_FALSE;
 const GLuint RAYCASTER_NOISE_RES = 64;
 
 class Raycaster
@@ -73,8 +76,12 @@ public:
     void draw(
         GLint volumeTextureHandle,
         GLint importanceVolumeTextureHandle,
+        GLint gradientVolumeTextureHandle,
+        GLint brickExtremaTextureHandle,
+        GLint emptySpaceMapTextureHandle,
         glm::vec3 volumeScale,
-        glm::vec3 volumeResolution,
+        glm::vec3 textureResolution,
+        glm::vec3 brickGridScale,
         VolumeProperties volumeProperties,
         GLfloat aspectRatio,
         GLfloat fieldOfView,
@@ -90,6 +97,7 @@ public:
         GLint colorAlphaPreintegrationHandle,
         GLint ambientSpecularPreintegrationHandle,
         GLint advancedPreintegrationHandle,
+        GLint maximumAlphaHandle,
         GLint tfResolution,
         GLint reflectionHandle,
         glm::vec3 volumeExtent,
@@ -139,6 +147,12 @@ public:
     void setUseAdaptiveSampling(GLboolean useAdaptiveSampling);
     GLboolean getUseVoxelSpacedSampling() const;
     void setUseVoxelSpacedSampling(GLboolean useVoxelSpacedSampling);
+    GLboolean getUseGradientVolume() const;
+    void setUseGradientVolume(GLboolean useGradientVolume);
+    GLboolean getUseBrickESS() const;
+    void setUseBrickESS(GLboolean useBrickESS);
+    GLboolean getUseDistanceESS() const;
+    void setUseDistanceESS(GLboolean useDistanceESS);
 
 protected:
     /** Reload shader after initialization or change of a define */
@@ -170,6 +184,9 @@ protected:
     GLboolean usePreintegration;
     GLboolean useAdaptiveSampling;
     GLboolean useVoxelSpacedSampling;
+    GLboolean useGradientVolume;
+    GLboolean useBrickESS;
+    GLboolean useDistanceESS;
 
     /** Max. only once per frame reload shader */
     GLboolean shaderShouldBeReloaded;
@@ -182,6 +199,11 @@ protected:
     GLuint uniformCameraPosHandle;
     GLuint uniformVolumeHandle;
     GLuint uniformImportanceVolumeHandle;
+    GLuint uniformGradientVolumeHandle;
+    GLuint uniformGradientVolumeReadyHandle;
+    GLuint uniformBrickExtremaHandle;
+    GLuint uniformMaximumAlphaHandle;
+    GLuint uniformEmptySpaceMapHandle;
     GLuint uniformColorAlphaHandle;
     GLuint uniformAmbientSpecularHandle;
     GLuint uniformReflectionHandle;
@@ -193,7 +215,8 @@ protected:
     GLuint uniformNoiseHandle;
     GLuint uniformAdvancedInputHandle;
     GLuint uniformVolumeValueInformationHandle;
-    GLuint uniformVolumeResolutionHandle;
+    GLuint uniformTextureResolutionHandle;
+    GLuint uniformBrickGridScaleHandle;
     GLuint uniformMirrorUVWHandle;
     GLuint uniformColorAlphaPreintegrationHandle;
     GLuint uniformAmbientSpecularPreintegrationHandle;
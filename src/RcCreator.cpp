@@ -83,6 +83,9 @@ GLboolean RcCreator::writeToFile(Raycaster* pRaycaster, GLboolean overwriteExist
 	appendBool(pRaycaster->getUseFresnelAlphaMultiplier(), "useFresnelAlphaMultiplier", &doc, pDefinesNode);
 	appendBool(pRaycaster->getUseReflectionColorMultiplier(), "useReflectionColorMultiplier", &doc, pDefinesNode);
 	appendBool(pRaycaster->getUseEmissionColorMultiplier(), "useEmissionColorMultiplier", &doc, pDefinesNode);
+	appendBool(pRaycaster->getUseGradientVolume(), "useGradientVolume", &doc, pDefinesNode);
+	appendBool(pRaycaster->getUseBrickESS(), "useBrickESS", &doc, pDefinesNode);
+	appendBool(pRaycaster->getUseDistanceESS(), "useDistanceESS", &doc, pDefinesNode);
 
 	pRootNode->append_node(pDefinesNode);
 
@@ -240,6 +243,25 @@ Raycaster* RcCreator::readFromFile(std::string name, GLint handle)
 	pCurrentAttribute = pGrandChildNode->first_attribute();
 	pRaycaster->useEmissionColorMultiplier  = convertCharToBool(pCurrentAttribute->value());
 
+	// Defines added later are optional, files saved before do not have them
+	for(pGrandChildNode = pGrandChildNode->next_sibling(); pGrandChildNode != NULL; pGrandChildNode = pGrandChildNode->next_sibling())
+	{
+		std::string defineName = pGrandChildNode->name();
+		pCurrentAttribute = pGrandChildNode->first_attribute();
+		if(defineName == "useGradientVolume")
+		{
+			pRaycaster->useGradientVolume = convertCharToBool(pCurrentAttribute->value());
+		}
+		else if(defineName == "useBrickESS")
+		{
+			pRaycaster->useBrickESS = convertCharToBool(pCurrentAttribute->value());
+		}
+		else if(defineName == "useDistanceESS")
+		{
+			pRaycaster->useDistanceESS = convertCharToBool(pCurrentAttribute->value());
+		}
+	}
+
 	// Properties
 	RaycasterProperties properties;
 
@@ -91,6 +91,8 @@ void Renderer::init(TfManager* pTfManager, RcManager* pRcManager, VolumeManager*
     TwAddSeparator(pBar, NULL, "");
 
     TwAddVarRW(pBar, "Use Simple ESS", TW_TYPE_BOOLCPP, &(bar_rcUseSimpleESS.value), "");
+    TwAddVarRW(pBar, "Use Brick ESS", TW_TYPE_BOOLCPP, &(bar_rcUseBrickESS.value), "");
+    TwAddVarRW(pBar, "Use Distance ESS", TW_TYPE_BOOLCPP, &(bar_rcUseDistanceESS.value), "");
     TwAddVarRW(pBar, "Use ERT", TW_TYPE_BOOLCPP, &(bar_rcUseERT.value), "");
     TwAddVarRW(pBar, "Use Jittering", TW_TYPE_BOOLCPP, &(bar_rcUseJittering.value), "");
     TwAddVarRW(pBar, "Use Extent Preserving Jittering", TW_TYPE_BOOLCPP, &(bar_rcUseExtentPreservingJittering.value), "");
@@ -100,6 +102,7 @@ void Renderer::init(TfManager* pTfManager, RcManager* pRcManager, VolumeManager*
     TwAddVarRW(pBar, "Use Local Illumination", TW_TYPE_BOOLCPP, &(bar_rcUseLocalIllumination.value), "");
     TwAddVarRW(pBar, "Use Shadows", TW_TYPE_BOOLCPP, &(bar_rcUseShadows.value), "");
     TwAddVarRW(pBar, "Use Normals Of Classified Data", TW_TYPE_BOOLCPP, &(bar_rcUseNormalsOfClassifiedData.value), "");
+    TwAddVarRW(pBar, "Use Gradient Volume", TW_TYPE_BOOLCPP, &(bar_rcUseGradientVolume.value), "");
     TwAddVarRW(pBar, "Use Extent Aware Normals", TW_TYPE_BOOLCPP, &(bar_rcUseExtentAwareNormals.value), "");
 
     TwAddVarRW(pBar, "Use Gradient Alpha Multiplier", TW_TYPE_BOOLCPP, &(bar_rcUseGradientAlphaMultiplier.value), " group='Use Of TfValues' ");
@@ -156,6 +159,7 @@ void Renderer::init(TfManager* pTfManager, RcManager* pRcManager, VolumeManager*
     TwAddVarRW(pBar, "Show Volume Clipping", TW_TYPE_BOOLCPP, &bar_showVolumeExtentGizmo, "");
     TwAddVarRW(pBar, "Show Sun", TW_TYPE_BOOLCPP, &bar_showSunGizmo, "");
     TwAddVarRW(pBar, "Show Importance Volume", TW_TYPE_BOOLCPP, &bar_showImportanceVolume, "");
+    TwAddVarRW(pBar, "Importance Downscale", TW_TYPE_INT32, &(bar_volumeImportanceDownscale.value), " min=1 max=64 help='Voxels per block of importance volume along each axis.' ");
 
     // Set some variable parameters
     TwSetParam(pBar, "FOV", "min", TW_PARAM_FLOAT, 1, &RENDERER_FIELD_OF_VIEW_MIN);
@@ -377,11 +381,23 @@ void Renderer::draw()
         Volume* pVolume = pVolumeManager->getVolume(volumeHandle);
         if(!bar_showImportanceVolume)
         {
-            pRcManager->getRc(rcHandle)->draw(
+            // Gradients are only computed in background when raycaster asks for them
+            Raycaster* pRaycaster = pRcManager->getRc(rcHandle);
+
+            // Empty space map follows transferfunction in background, no skipping until it is done
+            if(pRaycaster->getUseDistanceESS())
+            {
+                pVolume->updateEmptySpaceMap(pTfManager->getTf(tfHandle)->getColorAlphaFunction());
+            }
+            pRaycaster->draw(
                                             pVolume->getTextureHandle(),
                                             pVolume->getImportanceVolumeTextureHandle(),
+                                            pRaycaster->getUseGradientVolume() ? pVolume->getGradientVolumeTextureHandle() : 0,
+                                            pRaycaster->getUseBrickESS() ? pVolume->getBrickExtremaTextureHandle() : 0,
+                                            pRaycaster->getUseDistanceESS() ? pVolume->getEmptySpaceMapTextureHandle() : 0,
                                             pVolume->getRenderingScale(),
-                                            pVolume->getVolumeResolution(),
+                                            pVolume->getTextureResolution(),
+                                            pVolume->getBrickGridScale(),
                                             pVolume->getProperties(),
                                             this->getAspectRatio(),
                                             bar_fieldOfView,
@@ -397,6 +413,7 @@ void Renderer::draw()
                                             pTfManager->getTf(tfHandle)->getColorAlphaPreintegrationHandle(),
                                             pTfManager->getTf(tfHandle)->getAmbientSpecularPreintegrationHandle(),
                                             pTfManager->getTf(tfHandle)->getAdvancedPreintegrationHandle(),
+                                            pTfManager->getTf(tfHandle)->getMaximumAlphaHandle(),
                                             pTfManager->getTf(tfHandle)->getTextureResolution(),
                                             reflectionHandle,
                                             bar_volumeExtent,
@@ -650,14 +667,18 @@ void Renderer::updateBarVariables()
     bar_rcJitteringRangeMultiplier.update();
     bar_activeVolume.update();
     bar_volumeName.update();
+    bar_volumeImportanceDownscale.update();
     bar_rcUseGradientAlphaMultiplier.update();
     bar_rcUseFresnelAlphaMultiplier.update();
     bar_rcUseReflectionColorMultiplier.update();
     bar_rcUseEmissionColorMultiplier.update();
     bar_rcUseSimpleESS.update();
+    bar_rcUseBrickESS.update();
+    bar_rcUseDistanceESS.update();
     bar_rcNormalRangeMultiplier.update();
     bar_rcFresnelPower.update();
     bar_rcUseNormalsOfClassifiedData.update();
+    bar_rcUseGradientVolume.update();
     bar_rcUsePreintegration.update();
     bar_rcUseShadows.update();
     bar_rcUseAdaptiveSampling.update();
@@ -750,6 +771,12 @@ void Renderer::useBarVariables()
         pVolumeManager->getVolume(volumeHandle)->rename(bar_volumeName.getValue());
     }
 
+    // Update resolution of importance volume
+    if(bar_volumeImportanceDownscale.hasChanged() && volumeHandle >= 0)
+    {
+        pVolumeManager->getVolume(volumeHandle)->setImportanceVolumeDownscale(bar_volumeImportanceDownscale.getValue());
+    }
+
     // Raycaster
     if(rcHandle >= 0)
     {
@@ -857,6 +884,16 @@ void Renderer::useBarVariables()
             pRcManager->getRc(rcHandle)->setUseSimpleESS(bar_rcUseSimpleESS.getValue());
         }
 
+        if(bar_rcUseBrickESS.hasChanged())
+        {
+            pRcManager->getRc(rcHandle)->setUseBrickESS(bar_rcUseBrickESS.getValue());
+        }
+
+        if(bar_rcUseDistanceESS.hasChanged())
+        {
+            pRcManager->getRc(rcHandle)->setUseDistanceESS(bar_rcUseDistanceESS.getValue());
+        }
+
         if(bar_rcUseNormalsOfClassifiedData.hasChanged())
         {
             pRcManager->getRc(rcHandle)->setUseNormalsOfClassifiedData(bar_rcUseNormalsOfClassifiedData.getValue());
@@ -902,6 +939,11 @@ void Renderer::useBarVariables()
             pRcManager->getRc(rcHandle)->setUseVoxelSpacedSampling(bar_rcUseVoxelSpacedSampling.getValue());
         }
 
+        if(bar_rcUseGradientVolume.hasChanged())
+        {
+            pRcManager->getRc(rcHandle)->setUseGradientVolume(bar_rcUseGradientVolume.getValue());
+        }
+
     }
 }
 
@@ -926,6 +968,7 @@ void Renderer::fillBarVariables()
     if(volumeHandle >= 0)
     {
         bar_volumeName.setValue(pVolumeManager->getVolume(volumeHandle)->getName());
+        bar_volumeImportanceDownscale.setValue(pVolumeManager->getVolume(volumeHandle)->getImportanceVolumeDownscale());
     }
 
     // Camera
@@ -955,6 +998,8 @@ void Renderer::fillBarVariables()
         bar_rcUseExtentPreservingJittering.setValue(pRaycaster->getUseExtentPreservingJittering());
 
         bar_rcUseSimpleESS.setValue(pRaycaster->getUseSimpleESS());
+        bar_rcUseBrickESS.setValue(pRaycaster->getUseBrickESS());
+        bar_rcUseDistanceESS.setValue(pRaycaster->getUseDistanceESS());
 
         bar_rcUseNormalsOfClassifiedData.setValue(pRaycaster->getUseNormalsOfClassifiedData());
 
@@ -974,6 +1019,8 @@ void Renderer::fillBarVariables()
         bar_rcUseAdaptiveSampling.setValue(pRaycaster->getUseAdaptiveSampling());
         GLboolean adaptiveSampling = bar_rcUseAdaptiveSampling.getValue();
 
+        bar_rcUseGradientVolume.setValue(pRaycaster->getUseGradientVolume());
+
         bar_rcUseVoxelSpacedSampling.setValue(pRaycaster->getUseVoxelSpacedSampling());
         GLboolean voxelSpacedSampling = bar_rcUseVoxelSpacedSampling.getValue();
 
@@ -208,6 +208,7 @@ protected:
     BarVariable<std::string> bar_tfName;
     BarVariable<std::string> bar_rcName;
     BarVariable<std::string> bar_volumeName;
+    BarVariable<GLint> bar_volumeImportanceDownscale;
     BarVariable<GLboolean> bar_rcUseERT;
     BarVariable<GLboolean> bar_rcUseLocalIllumination;
     BarVariable<GLboolean> bar_rcUseShadows;
@@ -218,7 +219,10 @@ protected:
     BarVariable<GLboolean> bar_rcUseReflectionColorMultiplier;
     BarVariable<GLboolean> bar_rcUseEmissionColorMultiplier;
     BarVariable<GLboolean> bar_rcUseSimpleESS;
+    BarVariable<GLboolean> bar_rcUseBrickESS;
+    BarVariable<GLboolean> bar_rcUseDistanceESS;
     BarVariable<GLboolean> bar_rcUseNormalsOfClassifiedData;
+    BarVariable<GLboolean> bar_rcUseGradientVolume;
     BarVariable<GLboolean> bar_rcUseExtentAwareNormals;
     BarVariable<GLboolean> bar_rcUsePreintegration;
     BarVariable<GLboolean> bar_rcUseAdaptiveSampling;
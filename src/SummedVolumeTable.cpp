@@ -0,0 +1,261 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "SummedVolumeTable.h"
+
+SummedVolumeTable::SummedVolumeTable()
+{
+    volumeResolution = glm::ivec3(0, 0, 0);
+    cellCount = glm::ivec3(0, 0, 0);
+    cellSize = 1;
+}
+
+SummedVolumeTable::~SummedVolumeTable()
+{
+}
+
+void SummedVolumeTable::build(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution)
+{
+    this->volumeResolution = glm::ivec3(volumeResolution);
+
+    // Find smallest cells whose table fits
+    cellSize = 1;
+    while(true)
+    {
+        cellCount = (this->volumeResolution + cellSize - 1) / cellSize;
+        if(static_cast<GLuint64>(cellCount.x) * cellCount.y * cellCount.z <= SUMMEDVOLUMETABLE_MAX_CELL_COUNT)
+        {
+            break;
+        }
+        cellSize++;
+    }
+
+    size_t entryCount = static_cast<size_t>(cellCount.x + 1) * (cellCount.y + 1) * (cellCount.z + 1);
+    sums.assign(entryCount, 0);
+    squaredSums.assign(entryCount, 0);
+
+    // Decide type once instead of per voxel
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        sumCells(pData);
+        break;
+    case VOLUME_16BIT:
+        sumCells(reinterpret_cast<const GLushort*>(pData));
+        break;
+    case VOLUME_16BIT_SIGNED:
+        sumCells(reinterpret_cast<const GLshort*>(pData));
+        break;
+    case VOLUME_32BIT_FLOAT:
+        sumCells(reinterpret_cast<const GLfloat*>(pData));
+        break;
+    }
+
+    integrate();
+}
+
+GLboolean SummedVolumeTable::isBuilt() const
+{
+    return !sums.empty();
+}
+
+void SummedVolumeTable::swap(SummedVolumeTable& rOther)
+{
+    std::swap(volumeResolution, rOther.volumeResolution);
+    std::swap(cellCount, rOther.cellCount);
+    std::swap(cellSize, rOther.cellSize);
+    sums.swap(rOther.sums);
+    squaredSums.swap(rOther.squaredSums);
+}
+
+GLint SummedVolumeTable::getCellSize() const
+{
+    return cellSize;
+}
+
+GLdouble SummedVolumeTable::getVariance(glm::ivec3 begin, glm::ivec3 end) const
+{
+    glm::ivec3 beginCell, endCell;
+    snapToCells(begin, end, beginCell, endCell);
+
+    GLuint64 sum, squaredSum, count;
+    sumBox(beginCell, endCell, sum, squaredSum, count);
+    GLdouble mean = static_cast<GLdouble>(sum) / static_cast<GLdouble>(count);
+    return glm::max(0.0, static_cast<GLdouble>(squaredSum) / static_cast<GLdouble>(count) - mean * mean);
+}
+
+std::vector<GLfloat> SummedVolumeTable::computeVariances(GLint downscale, glm::ivec3& rResolution) const
+{
+    // Same blocks as accumulated by statistics
+    rResolution = glm::max(volumeResolution / glm::max(downscale, 1), glm::ivec3(1));
+    glm::ivec3 blockSize = volumeResolution / rResolution;
+
+    std::vector<GLfloat> variances(static_cast<size_t>(rResolution.x) * rResolution.y * rResolution.z);
+    UT::parallelFor(0, rResolution.z, [&](size_t firstZ, size_t lastZ)
+    {
+        glm::ivec3 block, begin, end;
+        for(block.z = static_cast<GLint>(firstZ); block.z < static_cast<GLint>(lastZ); block.z++)
+        {
+            for(block.y = 0; block.y < rResolution.y; block.y++)
+            {
+                for(block.x = 0; block.x < rResolution.x; block.x++)
+                {
+                    begin = block * blockSize;
+                    end = begin + blockSize;
+                    for(GLint i = 0; i < 3; i++)
+                    {
+                        end[i] = (block[i] + 1 == rResolution[i]) ? volumeResolution[i] : end[i];
+                    }
+                    size_t index = (static_cast<size_t>(block.z) * rResolution.y + block.y) * rResolution.x + block.x;
+                    variances[index] = static_cast<GLfloat>(getVariance(begin, end));
+                }
+            }
+        }
+    });
+    return variances;
+}
+
+template<typename T> void SummedVolumeTable::sumCells(const T* pData)
+{
+    size_t sliceSize = static_cast<size_t>(volumeResolution.x) * volumeResolution.y;
+
+    // Each thread takes whole layers of cells, walking voxels in order of memory
+    UT::parallelFor(0, cellCount.z, [&](size_t firstLayer, size_t lastLayer)
+    {
+        GLint firstZ = static_cast<GLint>(firstLayer) * cellSize;
+        GLint lastZ = glm::min(static_cast<GLint>(lastLayer) * cellSize, volumeResolution.z);
+        const T* pValue = pData + firstZ * sliceSize;
+        GLuint64 value, cellSum, cellSquaredSum;
+
+        for(GLint z = firstZ; z < lastZ; z++)
+        {
+            for(GLint y = 0; y < volumeResolution.y; y++)
+            {
+                size_t index = getIndex(1, y / cellSize + 1, z / cellSize + 1);
+                for(GLint x = 0; x < volumeResolution.x; x += cellSize)
+                {
+                    cellSum = 0;
+                    cellSquaredSum = 0;
+                    GLint cellEnd = glm::min(x + cellSize, volumeResolution.x);
+                    for(GLint i = x; i < cellEnd; i++)
+                    {
+                        value = VoxelTraits<T>::integer(pValue[i]);
+                        cellSum += value;
+                        cellSquaredSum += value * value;
+                    }
+                    sums[index] += cellSum;
+                    squaredSums[index] += cellSquaredSum;
+                    index++;
+                }
+                pValue += volumeResolution.x;
+            }
+        }
+    });
+}
+
+void SummedVolumeTable::integrate()
+{
+    GLint width = cellCount.x + 1;
+    GLint height = cellCount.y + 1;
+    GLint depth = cellCount.z + 1;
+
+    // Along x, each thread takes layers
+    UT::parallelFor(1, depth, [&](size_t first, size_t last)
+    {
+        for(GLint z = static_cast<GLint>(first); z < static_cast<GLint>(last); z++)
+        {
+            for(GLint y = 1; y < height; y++)
+            {
+                size_t index = getIndex(1, y, z);
+                for(GLint x = 1; x < width; x++, index++)
+                {
+                    sums[index] += sums[index - 1];
+                    squaredSums[index] += squaredSums[index - 1];
+                }
+            }
+        }
+    });
+
+    // Along y, rows are added to next row
+    UT::parallelFor(1, depth, [&](size_t first, size_t last)
+    {
+        for(GLint z = static_cast<GLint>(first); z < static_cast<GLint>(last); z++)
+        {
+            for(GLint y = 2; y < height; y++)
+            {
+                size_t index = getIndex(0, y, z);
+                for(GLint x = 0; x < width; x++, index++)
+                {
+                    sums[index] += sums[index - width];
+                    squaredSums[index] += squaredSums[index - width];
+                }
+            }
+        }
+    });
+
+    // Along z, each thread takes rows through all layers
+    size_t layerSize = static_cast<size_t>(width) * height;
+    UT::parallelFor(1, height, [&](size_t first, size_t last)
+    {
+        for(GLint z = 2; z < depth; z++)
+        {
+            for(GLint y = static_cast<GLint>(first); y < static_cast<GLint>(last); y++)
+            {
+                size_t index = getIndex(0, y, z);
+                for(GLint x = 0; x < width; x++, index++)
+                {
+                    sums[index] += sums[index - layerSize];
+                    squaredSums[index] += squaredSums[index - layerSize];
+                }
+            }
+        }
+    });
+}
+
+void SummedVolumeTable::sumBox(glm::ivec3 beginCell, glm::ivec3 endCell, GLuint64& rSum, GLuint64& rSquaredSum, GLuint64& rCount) const
+{
+    const glm::ivec3& a = beginCell;
+    const glm::ivec3& b = endCell;
+
+    // Inclusion and exclusion of corners, wrap around cancels out
+    rSum = sums[getIndex(b.x, b.y, b.z)] - sums[getIndex(a.x, b.y, b.z)] - sums[getIndex(b.x, a.y, b.z)] - sums[getIndex(b.x, b.y, a.z)]
+        + sums[getIndex(a.x, a.y, b.z)] + sums[getIndex(a.x, b.y, a.z)] + sums[getIndex(b.x, a.y, a.z)] - sums[getIndex(a.x, a.y, a.z)];
+    rSquaredSum = squaredSums[getIndex(b.x, b.y, b.z)] - squaredSums[getIndex(a.x, b.y, b.z)] - squaredSums[getIndex(b.x, a.y, b.z)] - squaredSums[getIndex(b.x, b.y, a.z)]
+        + squaredSums[getIndex(a.x, a.y, b.z)] + squaredSums[getIndex(a.x, b.y, a.z)] + squaredSums[getIndex(b.x, a.y, a.z)] - squaredSums[getIndex(a.x, a.y, a.z)];
+
+    // Cells at the end may be cut by volume
+    glm::ivec3 extent = glm::min(b * cellSize, volumeResolution) - a * cellSize;
+    rCount = static_cast<GLuint64>(extent.x) * extent.y * extent.z;
+}
+
+void SummedVolumeTable::snapToCells(glm::ivec3 begin, glm::ivec3 end, glm::ivec3& rBeginCell, glm::ivec3& rEndCell) const
+{
+    begin = glm::clamp(begin, glm::ivec3(0), volumeResolution);
+    end = glm::clamp(end, glm::ivec3(0), volumeResolution);
+    for(GLint i = 0; i < 3; i++)
+    {
+        rBeginCell[i] = glm::min((begin[i] + cellSize / 2) / cellSize, cellCount[i] - 1);
+        rEndCell[i] = (end[i] == volumeResolution[i]) ? cellCount[i] : (end[i] + cellSize / 2) / cellSize;
+        rEndCell[i] = glm::max(rEndCell[i], rBeginCell[i] + 1);
+    }
+}
+
+size_t SummedVolumeTable::getIndex(GLint x, GLint y, GLint z) const
+{
+    return (static_cast<size_t>(z) * (cellCount.y + 1) + y) * (cellCount.x + 1) + x;
+}
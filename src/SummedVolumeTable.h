@@ -0,0 +1,99 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * SummedVolumeTable
+ *--------------
+ * Prefix sums of values and squared values over
+ * cells of the volume, so sum, mean and variance of
+ * any box of cells are available in constant time.
+ * Sums are exact 64 bit integers and may wrap
+ * around, as differences stay correct.
+ *
+ */
+
+#ifndef SUMMEDVOLUMETABLE_H_
+#define SUMMEDVOLUMETABLE_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+
+#include "VolumeProperties.h"
+#include "Utilities.h"
+
+const GLuint64 SUMMEDVOLUMETABLE_MAX_CELL_COUNT = 8 * 1024 * 1024;
+
+class SummedVolumeTable
+{
+public:
+    SummedVolumeTable();
+    ~SummedVolumeTable();
+
+    /** Builds table in parallel, cells grow until count of cells fits */
+    void build(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution);
+
+    /** Returns whether table was built */
+    GLboolean isBuilt() const;
+
+    /** Swaps content with other table */
+    void swap(SummedVolumeTable& rOther);
+
+    /** Returns edge length of cells in voxels */
+    GLint getCellSize() const;
+
+    /** Variances of blocks for importance volume with downscale, blocks at the end take remaining voxels */
+    std::vector<GLfloat> computeVariances(GLint downscale, glm::ivec3& rResolution) const;
+
+private:
+    /** Private copy constuctor */
+    SummedVolumeTable(SummedVolumeTable const&) {};
+
+    /** Private assignment operator */
+    SummedVolumeTable& operator=(SummedVolumeTable const&) {return *this;};
+
+    /** Sums of cells per type of voxels */
+    template<typename T> void sumCells(const T* pData);
+
+    /** Variance of voxels in box, bounds are snapped to cells. Values are unsigned integers like in importance volume */
+    GLdouble getVariance(glm::ivec3 begin, glm::ivec3 end) const;
+
+    /** Prefix sums along all axes */
+    void integrate();
+
+    /** Sums and count of voxels of box in cells */
+    void sumBox(glm::ivec3 beginCell, glm::ivec3 endCell, GLuint64& rSum, GLuint64& rSquaredSum, GLuint64& rCount) const;
+
+    /** Snaps box in voxels to cells, box keeps at least one cell */
+    void snapToCells(glm::ivec3 begin, glm::ivec3 end, glm::ivec3& rBeginCell, glm::ivec3& rEndCell) const;
+
+    /** Index of entry in table, which has one more entry per axis than cells */
+    size_t getIndex(GLint x, GLint y, GLint z) const;
+
+    glm::ivec3 volumeResolution;
+    glm::ivec3 cellCount;
+    GLint cellSize;
+
+    /** Tables of sums with zeros at lower borders */
+    std::vector<GLuint64> sums;
+    std::vector<GLuint64> squaredSums;
+};
+
+#endif
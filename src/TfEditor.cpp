@@ -37,6 +37,7 @@ TfEditor::TfEditor() : Viewport()
 	bar_tfFunctionOpacity = TFEDITOR_TF_OPACITY;
 	bar_overwriteExisting = GL_FALSE;
 	bar_showPivot = GL_TRUE;
+	bar_showJointHistogram = GL_FALSE;
 }
 
 TfEditor::~TfEditor()
@@ -105,6 +106,7 @@ void TfEditor::init(TfManager* pTfManager, VolumeManager* pVolumeManager, GLint
 	TwAddSeparator(pBar, NULL, "");
 
 	TwAddVarRW(pBar, "Show pivot", TW_TYPE_BOOLCPP, &bar_showPivot, "");
+	TwAddVarRW(pBar, "Show joint histogram", TW_TYPE_BOOLCPP, &bar_showJointHistogram, " help='Value versus gradient magnitude instead of histogram, available when computed in background.' ");
 	TwAddVarRW(pBar, "Tf Function Opacity", TW_TYPE_FLOAT, &bar_tfFunctionOpacity, " min=0 max=1 step=0.1 ");
 	TwAddButton(pBar, "Reset Camera", resetCameraButtonCallback, this, "");
 
@@ -185,6 +187,13 @@ void TfEditor::init(TfManager* pTfManager, VolumeManager* pVolumeManager, GLint
 	histogramShaderViewHandle = histogramShader.getUniformHandle("uniformView");
 	histogramShaderTextureHandle = histogramShader.getUniformHandle("uniformHistogram");
 
+	// *** JOINT HISTOGRAM SHADER ***
+	jointHistogramShader.loadShaders("JointHistogram.vert", "JointHistogram.frag");
+	jointHistogramShader.setVertexBuffer(primitives::quad, sizeof(primitives::quad), "positionAttribute");
+	jointHistogramShaderModelHandle = jointHistogramShader.getUniformHandle("uniformModel");
+	jointHistogramShaderViewHandle = jointHistogramShader.getUniformHandle("uniformView");
+	jointHistogramShaderTextureHandle = jointHistogramShader.getUniformHandle("uniformJointHistogram");
+
 	// *** PIVOT SHADER *** 
 	pivotShader.loadShaders("SlicerPivot.vert", "SlicerPivot.frag");
 	pivotShader.setVertexBuffer(primitives::quad, sizeof(primitives::quad), "positionAttribute");
@@ -224,18 +233,22 @@ ViewportType TfEditor::update(GLfloat tpf, InputData inputData, GLboolean select
 
 	if(volumeHandle >= 0)
 	{
+		// Histogram covers range of texture values, mapped onto transfer function like in shaders
+		Volume* pVolume = pVolumeManager->getVolume(volumeHandle);
+		glm::vec2 valueRange = getTextureValueRange(pVolume->getValueResolution());
+		GLfloat valueOffset = valueRange.x * pVolume->getProperties().valueScale + pVolume->getProperties().valueOffset;
+		GLfloat valueScale = (valueRange.y - valueRange.x) * pVolume->getProperties().valueScale;
+
 		// Calculate model matrix for histogram shader
 		histogramShaderModel = glm::mat4(1.0f);
-		histogramShaderModel = glm::translate(histogramShaderModel, glm::vec3(pVolumeManager->getVolume(volumeHandle)->getProperties().valueOffset, 0, TFEDITOR_HISTOGRAM_POSZ));
-		histogramShaderModel = glm::scale(histogramShaderModel, glm::vec3(pVolumeManager->getVolume(volumeHandle)->getProperties().valueScale, 1, 1));
+		histogramShaderModel = glm::translate(histogramShaderModel, glm::vec3(valueOffset, 0, TFEDITOR_HISTOGRAM_POSZ));
+		histogramShaderModel = glm::scale(histogramShaderModel, glm::vec3(valueScale, 1, 1));
 
 		// Calculate model matrix for pivot shader
 		GLfloat pivotScale = TFEDITOR_PIVOT_SCALE/this->getAspectRatio();
 		pivotShaderModel = glm::mat4(1.0f);
 		pivotShaderModel = glm::translate(pivotShaderModel, 
-			glm::vec3(pVolumeManager->getVolume(volumeHandle)->getProperties().valueOffset 
-			+ (pVolumeManager->getVolume(volumeHandle)->getPivot() * (1.0f-pivotScale)) 
-			* pVolumeManager->getVolume(volumeHandle)->getProperties().valueScale, 0, TFEDITOR_PIVOT_POSZ));
+			glm::vec3(valueOffset + (pVolume->getPivot() * (1.0f-pivotScale)) * valueScale, 0, TFEDITOR_PIVOT_POSZ));
 		pivotShaderModel = glm::scale(pivotShaderModel, glm::vec3(pivotScale, 1, 1));
 	}
 
@@ -260,12 +273,25 @@ void TfEditor::draw()
 
 	if(volumeHandle >= 0)
 	{
-		// *** HISTOGRAM SHADER ***
-		histogramShader.use();
-		histogramShader.setUniformValue(histogramShaderModelHandle, histogramShaderModel);
-		histogramShader.setUniformValue(histogramShaderViewHandle, viewMatrix);
-		histogramShader.setUniformTexture(histogramShaderTextureHandle, pVolumeManager->getVolume(volumeHandle)->getHistogramTextureHandle(), GL_TEXTURE_1D);
-		histogramShader.draw(GL_TRIANGLES);
+		GLuint jointHistogramTextureHandle = bar_showJointHistogram ? pVolumeManager->getVolume(volumeHandle)->getJointHistogramTextureHandle() : 0;
+		if(jointHistogramTextureHandle != 0)
+		{
+			// *** JOINT HISTOGRAM SHADER ***
+			jointHistogramShader.use();
+			jointHistogramShader.setUniformValue(jointHistogramShaderModelHandle, histogramShaderModel);
+			jointHistogramShader.setUniformValue(jointHistogramShaderViewHandle, viewMatrix);
+			jointHistogramShader.setUniformTexture(jointHistogramShaderTextureHandle, jointHistogramTextureHandle, GL_TEXTURE_2D);
+			jointHistogramShader.draw(GL_TRIANGLES);
+		}
+		else
+		{
+			// *** HISTOGRAM SHADER ***
+			histogramShader.use();
+			histogramShader.setUniformValue(histogramShaderModelHandle, histogramShaderModel);
+			histogramShader.setUniformValue(histogramShaderViewHandle, viewMatrix);
+			histogramShader.setUniformTexture(histogramShaderTextureHandle, pVolumeManager->getVolume(volumeHandle)->getHistogramTextureHandle(), GL_TEXTURE_1D);
+			histogramShader.draw(GL_TRIANGLES);
+		}
 
 		// *** PIVOT SHADER ***
 		if(bar_showPivot)
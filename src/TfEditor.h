@@ -157,6 +157,12 @@ protected:
 	GLuint histogramShaderTextureHandle;
 	glm::mat4 histogramShaderModel;
 
+	/** Joint histogram of value and gradient magnitude, uses model of histogram */
+	Shader jointHistogramShader;
+	GLuint jointHistogramShaderModelHandle;
+	GLuint jointHistogramShaderViewHandle;
+	GLuint jointHistogramShaderTextureHandle;
+
 	/** Pivot */
 	Shader pivotShader;
 	GLuint pivotShaderModelHandle;
@@ -168,6 +174,7 @@ protected:
 	std::string bar_pathToExternTf;
 	GLboolean bar_overwriteExisting;
 	GLboolean bar_showPivot;
+	GLboolean bar_showJointHistogram;
 
 	/** Bar variables */
 	BarVariable<glm::vec3> bar_tfPointColor;
@@ -35,6 +35,7 @@ Transferfunction::~Transferfunction()
 	deleteTexture(colorAlphaPreintegrationHandle);
 	deleteTexture(ambientSpecularPreintegrationHandle);
 	deleteTexture(advancedPreintegrationHandle);
+	deleteTexture(maximumAlphaHandle);
 }
 
 void Transferfunction::init(GLint handle, std::string name)
@@ -128,6 +129,7 @@ void Transferfunction::init(GLint handle, std::string name)
 	textureInitialization(colorAlphaPreintegrationHandle, GL_TEXTURE_2D);
 	textureInitialization(ambientSpecularPreintegrationHandle, GL_TEXTURE_2D);
 	textureInitialization(advancedPreintegrationHandle, GL_TEXTURE_2D);
+	textureInitialization(maximumAlphaHandle, GL_TEXTURE_2D);
 
 	functionShouldBeUpdated = GL_TRUE;
 	preintegrationShouldBeUpdated = GL_TRUE;
@@ -543,6 +545,16 @@ GLuint Transferfunction::getAdvancedPreintegrationHandle() const
 	return advancedPreintegrationHandle;
 }
 
+GLuint Transferfunction::getMaximumAlphaHandle() const
+{
+	return maximumAlphaHandle;
+}
+
+const std::vector<glm::vec4>& Transferfunction::getColorAlphaFunction() const
+{
+	return colorAlphaFunction;
+}
+
 GLuint Transferfunction::getTextureResolution() const
 {
 	return TRANSFERFUNCTION_TEXTURES_RES;
@@ -838,9 +850,33 @@ void Transferfunction::updateFunction()
 	glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, TRANSFERFUNCTION_TEXTURES_RES, 0, GL_RGBA, GL_FLOAT, reinterpret_cast<GLfloat*> (&(advancedFunction[0])));
 	glBindTexture(GL_TEXTURE_1D, 0);
 
+	// Maximum alpha depends on color and alpha only
+	updateMaximumAlpha();
+
 	functionShouldBeUpdated = GL_FALSE;
 }
 
+void Transferfunction::updateMaximumAlpha()
+{
+	// Symmetric table, texel at x and y is maximum of alpha between both entries
+	std::vector<GLfloat> maximumAlpha(TRANSFERFUNCTION_TEXTURES_RES * TRANSFERFUNCTION_TEXTURES_RES);
+	for(GLuint x = 0; x < TRANSFERFUNCTION_TEXTURES_RES; x++)
+	{
+		GLfloat maximum = colorAlphaFunction[x].a;
+		for(GLuint y = x; y < TRANSFERFUNCTION_TEXTURES_RES; y++)
+		{
+			maximum = glm::max(maximum, colorAlphaFunction[y].a);
+			maximumAlpha[x + TRANSFERFUNCTION_TEXTURES_RES*y] = maximum;
+			maximumAlpha[y + TRANSFERFUNCTION_TEXTURES_RES*x] = maximum;
+		}
+	}
+
+	// Fill texture, it is read with texelFetch
+	glBindTexture(GL_TEXTURE_2D, maximumAlphaHandle);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, TRANSFERFUNCTION_TEXTURES_RES, TRANSFERFUNCTION_TEXTURES_RES, 0, GL_RED, GL_FLOAT, &(maximumAlpha[0]));
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Transferfunction::updatePreintegation()
 {
 	updatePreintegrationHelper(colorAlphaFunction, colorAlphaPreintegrationHandle);
@@ -124,6 +124,12 @@ public:
     GLuint getAmbientSpecularPreintegrationHandle() const;
     GLuint getAdvancedPreintegrationHandle() const;
 
+    /** Getter for texture handle of maximum alpha between two values, for empty space skipping */
+    GLuint getMaximumAlphaHandle() const;
+
+    /** Getter for color and alpha as they were filled into texture, for computations on CPU */
+    const std::vector<glm::vec4>& getColorAlphaFunction() const;
+
     /** Get texture resolution (let's assume all textures have the same) */
     GLuint getTextureResolution() const;
 
@@ -146,6 +152,9 @@ protected:
     /** Method for creation of the function */
     void updateFunction();
 
+    /** Update table of maximum alpha between two values */
+    void updateMaximumAlpha();
+
     /** Update preintegration table */
     void updatePreintegation();
 
@@ -193,6 +202,9 @@ protected:
     GLuint ambientSpecularPreintegrationHandle;
     GLuint advancedPreintegrationHandle;
 
+    /** Maximum alpha between two values, updated with function */
+    GLuint maximumAlphaHandle;
+
     /* Own shader to visualize colorAlphaFunction behind tfPoints */
     Shader functionShader;
 
@@ -0,0 +1,93 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "Utilities.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+    #ifdef _MSC_VER
+        #pragma comment(lib, "psapi.lib")
+    #endif
+#else
+    #include <sys/resource.h>
+    #include <dirent.h>
+#endif
+
+namespace UT
+{
+    std::vector<std::string> listDirectory(std::string path)
+    {
+        std::vector<std::string> names;
+#ifdef _WIN32
+        WIN32_FIND_DATAA findData;
+        HANDLE findHandle = FindFirstFileA((path + "/*").c_str(), &findData);
+        if(findHandle == INVALID_HANDLE_VALUE)
+        {
+            return names;
+        }
+        do
+        {
+            if(!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                names.push_back(findData.cFileName);
+            }
+        }
+        while(FindNextFileA(findHandle, &findData));
+        FindClose(findHandle);
+#else
+        DIR* pDirectory = opendir(path.c_str());
+        if(pDirectory == NULL)
+        {
+            return names;
+        }
+        struct dirent* pEntry;
+        while((pEntry = readdir(pDirectory)) != NULL)
+        {
+            if(pEntry->d_name[0] != '.')
+            {
+                names.push_back(pEntry->d_name);
+            }
+        }
+        closedir(pDirectory);
+#endif
+        return names;
+    }
+
+    double getPeakMemoryUsage()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return static_cast<double>(counters.PeakWorkingSetSize) / 1048576.0;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+        return static_cast<double>(usage.ru_maxrss) / 1048576.0;
+    #else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+    #endif
+#endif
+    }
+}
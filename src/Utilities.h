@@ -28,6 +28,10 @@
 
 #include <sstream>
 #include <string>
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <functional>
 
 namespace UT
 {
@@ -69,5 +73,46 @@ namespace UT
 		return fopen(path.c_str(), "wb");
 #endif
 	}
+
+	/** Count of threads used for parallel work */
+	inline unsigned int getThreadCount()
+	{
+		unsigned int count = std::thread::hardware_concurrency();
+		return count > 0 ? count : 1;
+	}
+
+	/** Splits range into one chunk per thread and calls function with begin and end of each chunk */
+	inline void parallelFor(size_t begin, size_t end, std::function<void(size_t, size_t)> function)
+	{
+		if(end <= begin)
+		{
+			return;
+		}
+
+		size_t count = end - begin;
+		size_t threadCount = getThreadCount();
+		threadCount = threadCount < count ? threadCount : count;
+		size_t chunkSize = (count + threadCount - 1) / threadCount;
+
+		// Calling thread takes first chunk
+		std::vector<std::thread> threads;
+		for(size_t chunkBegin = begin + chunkSize; chunkBegin < end; chunkBegin += chunkSize)
+		{
+			size_t chunkEnd = chunkBegin + chunkSize < end ? chunkBegin + chunkSize : end;
+			threads.push_back(std::thread(function, chunkBegin, chunkEnd));
+		}
+		function(begin, begin + chunkSize < end ? begin + chunkSize : end);
+
+		for(size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+	}
+
+	/** Names of files in directory, not sorted */
+	std::vector<std::string> listDirectory(std::string path);
+
+	/** Peak resident memory of process in megabytes */
+	double getPeakMemoryUsage();
 }
 #endif
@@ -21,14 +21,33 @@
 Volume::Volume()
 {
     pivot = VOLUME_PIVOT;
+    pRawData = NULL;
+    randomAccessAdvised = GL_FALSE;
+    regionOffset = glm::vec3(0, 0, 0);
+    importanceVolumeTextureHandle = 0;
+    jointHistogramTextureHandle = 0;
+    gradientVolumeTextureHandle = 0;
+    brickExtremaTextureHandle = 0;
+    emptySpaceMapTextureHandle = 0;
+    emptySpaceMapUploaded = GL_FALSE;
+    importanceVolumeDownscale = VOLUME_IMPORTANCE_VOLUME_DOWNSCALE;
 }
 
 Volume::~Volume()
 {
+    // Background computation reads raw data
+    jointHistogram.cancel();
+    gradientVolume.cancel();
+    emptySpaceMap.cancel();
+
+    glDeleteTextures(1, &jointHistogramTextureHandle);
+    glDeleteTextures(1, &gradientVolumeTextureHandle);
+    glDeleteTextures(1, &brickExtremaTextureHandle);
+    glDeleteTextures(1, &emptySpaceMapTextureHandle);
     glDeleteTextures(1, &importanceVolumeTextureHandle);
     glDeleteTextures(1, &textureHandle);
     glDeleteTextures(1, &histogramTextureHandle);
-    free(pRawData);
+    delete pRawData;
 }
 
 void Volume::init(
@@ -38,7 +57,10 @@ void Volume::init(
         glm::vec3 volumeResolution,
         glm::vec3 voxelScale,
         VolumeValueResolution valueResolution,
-        GLubyte* pRawData)
+        RawData* pRawData,
+        const VolumeStatistics* pStatistics,
+        SummedVolumeTable& rSummedVolumeTable,
+        VolumePyramid& rPyramid)
 {
     this->handle = handle;
     this->name = name;
@@ -47,27 +69,43 @@ void Volume::init(
     this->voxelScale = voxelScale;
     this->valueResolution = valueResolution;
     this->pRawData = pRawData;
+    this->textureResolution = volumeResolution;
 
     // Some logging for information
     LogInfo("Volume Resolution: " + UT::to_string(this->volumeResolution.x) +  " x " + UT::to_string(this->volumeResolution.y) +  " x " + UT::to_string(this->volumeResolution.z));
 
-    if(this->valueResolution == VOLUME_8BIT)
+    LogInfo("Value Resolution: " + std::string(getValueResolutionName(this->valueResolution)));
+
+    // Calculate rendering scale from input data
+    renderingScale = scaleToMaximumOne(volumeResolution * voxelScale);
+
+    // Accumulate statistics in one pass if it was not done while reading
+    if(pStatistics == NULL || !pStatistics->isComplete())
     {
-        LogInfo("Value Resolution: 8 BIT");
+        statistics.init(volumeResolution, valueResolution);
+        statistics.accumulate(pRawData->getData(), 0, static_cast<GLuint>(volumeResolution.z));
     }
-    else if(this->valueResolution == VOLUME_16BIT)
+    else
     {
-        LogInfo("Value Resolution: 16 BIT");
+        statistics = *pStatistics;
     }
 
-    // Calculate rendering scale from input data
-    renderingScale = scaleToMaximumOne(volumeResolution * voxelScale);
+    // Table and pyramid were built by worker thread, volume takes them over
+    summedVolumeTable.swap(rSummedVolumeTable);
+    pyramid.swap(rPyramid);
 
     // Create importance volume
-    createImportanceVolume();
+    createImportanceVolume(statistics.getVariances(), statistics.getImportanceVolumeResolution());
 
     // Create histogram
-    createHistogram();
+    createHistogram(statistics);
+
+    // Brick extrema come with statistics, empty space map is computed from them
+    createBrickExtremaVolume(statistics);
+
+    // Joint histogram is computed in background, texture is created when asked for after it is done. Readahead stays on for it
+    this->pRawData->advise(RAWDATA_ACCESS_SEQUENTIAL);
+    jointHistogram.start(this->pRawData->getData(), volumeResolution, valueResolution);
 
     LogInfo("Volume creation done");
 }
@@ -82,6 +120,11 @@ glm::vec3 Volume::getVolumeResolution() const
     return volumeResolution;
 }
 
+glm::vec3 Volume::getTextureResolution() const
+{
+    return textureResolution;
+}
+
 glm::vec3 Volume::getVoxelScale() const
 {
     return voxelScale;
@@ -92,6 +135,11 @@ glm::vec3 Volume::getRenderingScale() const
     return renderingScale;
 }
 
+glm::vec3 Volume::getRegionOffset() const
+{
+    return regionOffset;
+}
+
 VolumeProperties Volume::getProperties() const
 {
     return properties;
@@ -99,20 +147,28 @@ VolumeProperties Volume::getProperties() const
 
 void Volume::setProperties(VolumeProperties properties)
 {
-    // Choose filtering
+    // Choose filtering, gradients are filtered like values but only values have mip levels
     if(properties.useLinearFiltering != this->properties.useLinearFiltering)
     {
-        glBindTexture(GL_TEXTURE_3D, textureHandle);
-
-        if(properties.useLinearFiltering)
+        GLuint handles[] = {textureHandle, gradientVolumeTextureHandle};
+        for(GLuint i = 0; i < 2; i++)
         {
-            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        }
-        else
-        {
-            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            if(handles[i] == 0)
+            {
+                continue;
+            }
+            glBindTexture(GL_TEXTURE_3D, handles[i]);
+
+            if(properties.useLinearFiltering)
+            {
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, (i == 0) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            }
+            else
+            {
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, (i == 0) ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
+            }
         }
 
         glBindTexture(GL_TEXTURE_3D, 0);
@@ -124,28 +180,82 @@ void Volume::setProperties(VolumeProperties properties)
 
 void Volume::setPivot(glm::vec3 pivot)
 {
+    adviseRandomAccess();
+
     // Clamping to voxel coordinates
     pivot = glm::clamp(pivot * volumeResolution, glm::vec3(0,0,0), volumeResolution-1.0f);
     pivot = glm::floor(pivot);
 
-    GLdouble valueOfVoxel;
-    GLuint positionInVolume =
-        static_cast<GLuint>(pivot.x
-        + pivot.y*volumeResolution.x
-        + pivot.z*volumeResolution.y*volumeResolution.x);
+    GLdouble valueOfVoxel = 0;
+    size_t positionInVolume =
+        static_cast<size_t>(pivot.x)
+        + static_cast<size_t>(pivot.y) * static_cast<size_t>(volumeResolution.x)
+        + static_cast<size_t>(pivot.z) * static_cast<size_t>(volumeResolution.y) * static_cast<size_t>(volumeResolution.x);
 
-    if(valueResolution == VOLUME_8BIT)
+    switch(valueResolution)
     {
-        GLubyte value = pRawData[positionInVolume];
-        valueOfVoxel = static_cast<GLdouble>(value) / 255.0;
+    case VOLUME_8BIT:
+        valueOfVoxel = readVoxel<GLubyte>(positionInVolume);
+        break;
+    case VOLUME_16BIT:
+        valueOfVoxel = readVoxel<GLushort>(positionInVolume);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        valueOfVoxel = readVoxel<GLshort>(positionInVolume);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        valueOfVoxel = readVoxel<GLfloat>(positionInVolume);
+        break;
     }
-    else if(valueResolution == VOLUME_16BIT)
+
+    this->pivot = static_cast<GLfloat>(valueOfVoxel);
+}
+
+const VolumeStatistics& Volume::getStatistics() const
+{
+    return statistics;
+}
+
+const SummedVolumeTable& Volume::getSummedVolumeTable() const
+{
+    return summedVolumeTable;
+}
+
+const VolumePyramid& Volume::getPyramid() const
+{
+    return pyramid;
+}
+
+GLint Volume::getImportanceVolumeDownscale() const
+{
+    return importanceVolumeDownscale;
+}
+
+void Volume::setImportanceVolumeDownscale(GLint downscale)
+{
+    downscale = glm::max(downscale, 1);
+    if(downscale == importanceVolumeDownscale)
     {
-        GLushort value = reinterpret_cast<GLushort*>(pRawData)[positionInVolume];
-        valueOfVoxel = static_cast<GLdouble>(value) / 65535.0;
+        return;
     }
+    importanceVolumeDownscale = downscale;
 
-    this->pivot = static_cast<GLfloat>(valueOfVoxel);
+    GLdouble startTime = glfwGetTime();
+
+    // Volumes of bricked files were loaded without table
+    if(!summedVolumeTable.isBuilt())
+    {
+        pRawData->advise(RAWDATA_ACCESS_SEQUENTIAL);
+        randomAccessAdvised = GL_FALSE;
+        summedVolumeTable.build(pRawData->getData(), volumeResolution, valueResolution);
+        LogInfo("Summed volume table with cells of " + UT::to_string(summedVolumeTable.getCellSize()) + " voxels built in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+    }
+
+    glm::ivec3 resolution;
+    std::vector<GLfloat> variances = summedVolumeTable.computeVariances(downscale, resolution);
+    createImportanceVolume(variances, resolution);
+
+    LogInfo("Importance volume with downscale " + UT::to_string(downscale) + " created in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
 }
 
 GLuint Volume::getTextureHandle() const
@@ -158,11 +268,111 @@ GLuint Volume::getImportanceVolumeTextureHandle() const
     return importanceVolumeTextureHandle;
 }
 
+GLuint Volume::getGradientVolumeTextureHandle()
+{
+    // Gradients which were not precomputed while loading are computed in background, no texture until it is done
+    if(gradientVolumeTextureHandle == 0)
+    {
+        if(!gradientVolume.isStarted())
+        {
+            pRawData->advise(RAWDATA_ACCESS_SEQUENTIAL);
+            randomAccessAdvised = GL_FALSE;
+            gradientVolume.start(pRawData->getData(), volumeResolution, textureResolution, valueResolution, VOLUME_GRADIENT_VOLUME_16BIT);
+        }
+        else if(gradientVolume.isDone())
+        {
+            createGradientVolume(gradientVolume.getGradients(), gradientVolume.is16Bit());
+            gradientVolume.clear();
+            adviseRandomAccess();
+        }
+    }
+    return gradientVolumeTextureHandle;
+}
+
+GLuint Volume::getBrickExtremaTextureHandle() const
+{
+    return brickExtremaTextureHandle;
+}
+
+glm::vec3 Volume::getBrickGridScale() const
+{
+    return textureResolution / static_cast<GLfloat>(VOLUME_BRICK_SIZE);
+}
+
+void Volume::updateEmptySpaceMap(const std::vector<glm::vec4>& colorAlphaFunction)
+{
+    std::vector<GLfloat> alphas(colorAlphaFunction.size());
+    for(size_t i = 0; i < alphas.size(); i++)
+    {
+        alphas[i] = colorAlphaFunction[i].a;
+    }
+
+    // Old distances would skip space which is now visible
+    if(emptySpaceMap.update(alphas, properties.valueOffset, properties.valueScale))
+    {
+        emptySpaceMapUploaded = GL_FALSE;
+    }
+}
+
+GLuint Volume::getEmptySpaceMapTextureHandle()
+{
+    if(!emptySpaceMapUploaded && emptySpaceMap.isDone())
+    {
+        glm::ivec3 cellCount = emptySpaceMap.getCellCount();
+        GLboolean create = (emptySpaceMapTextureHandle == 0);
+        if(create)
+        {
+            glGenTextures(1, &emptySpaceMapTextureHandle);
+        }
+        glBindTexture(GL_TEXTURE_3D, emptySpaceMapTextureHandle);
+
+        // Storage is allocated once, later computations only replace the distances
+        if(create)
+        {
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage3D(GL_TEXTURE_3D, 0, GL_R32F, cellCount.x, cellCount.y, cellCount.z, 0, GL_RED, GL_FLOAT, &(emptySpaceMap.getDistances()[0]));
+        }
+        else
+        {
+            glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, cellCount.x, cellCount.y, cellCount.z, GL_RED, GL_FLOAT, &(emptySpaceMap.getDistances()[0]));
+        }
+        glBindTexture(GL_TEXTURE_3D, 0);
+        emptySpaceMapUploaded = GL_TRUE;
+    }
+    return emptySpaceMapUploaded ? emptySpaceMapTextureHandle : 0;
+}
+
 GLuint Volume::getHistogramTextureHandle() const
 {
     return histogramTextureHandle;
 }
 
+GLuint Volume::getJointHistogramTextureHandle()
+{
+    if(jointHistogramTextureHandle == 0 && jointHistogram.isDone())
+    {
+        glGenTextures(1, &jointHistogramTextureHandle);
+        glBindTexture(GL_TEXTURE_2D, jointHistogramTextureHandle);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, JOINTHISTOGRAM_VALUE_BIN_COUNT, JOINTHISTOGRAM_GRADIENT_BIN_COUNT, 0, GL_RED, GL_FLOAT, &(jointHistogram.getLogScaledBins()[0]));
+        glBindTexture(GL_TEXTURE_2D, 0);
+        adviseRandomAccess();
+    }
+    return jointHistogramTextureHandle;
+}
+
+const JointHistogram& Volume::getJointHistogram() const
+{
+    return jointHistogram;
+}
+
 GLint Volume::getHandle() const
 {
     return handle;
@@ -183,6 +393,21 @@ void Volume::rename(std::string name)
     this->name = name;
 }
 
+template<typename T> GLdouble Volume::readVoxel(size_t index) const
+{
+    return VoxelTraits<T>::value(reinterpret_cast<const T*>(pRawData->getData())[index]);
+}
+
+void Volume::adviseRandomAccess()
+{
+    // Readahead would only waste reads for single voxels, but background passes need it
+    if(!randomAccessAdvised && jointHistogram.isDone() && (!gradientVolume.isStarted() || gradientVolume.isDone()))
+    {
+        pRawData->advise(RAWDATA_ACCESS_RANDOM);
+        randomAccessAdvised = GL_TRUE;
+    }
+}
+
 glm::vec3 Volume::scaleToMaximumOne(glm::vec3 value)
 {
     GLfloat maximum = glm::max(value.x, value.y);
@@ -191,122 +416,42 @@ glm::vec3 Volume::scaleToMaximumOne(glm::vec3 value)
     return (value/maximum);
 }
 
- void Volume::createImportanceVolume()
+ void Volume::createImportanceVolume(std::vector<GLfloat> variances, glm::ivec3 resolution)
  {
-    // Calculate resolution of importance volume
-    GLuint xDim =  static_cast<GLuint>(volumeResolution.x/VOLUME_IMPORTANCE_VOLUME_DOWNSCALE);
-    xDim = xDim > 1 ? xDim : 1;
-    GLuint yDim =  static_cast<GLuint>(volumeResolution.y/VOLUME_IMPORTANCE_VOLUME_DOWNSCALE);
-    yDim = yDim > 1 ? yDim : 1;
-    GLuint zDim =  static_cast<GLuint>(volumeResolution.z/VOLUME_IMPORTANCE_VOLUME_DOWNSCALE);
-    zDim = zDim > 1 ? zDim : 1;
+    GLuint xDim = resolution.x;
+    GLuint yDim = resolution.y;
+    GLuint zDim = resolution.z;
 
     LogInfo("Resolution of importance volume: " + UT::to_string(xDim) + " x " + UT::to_string(yDim) + " x " + UT::to_string(zDim));
 
-    // Some variabels which are needed
-    GLfloat minVariance = std::numeric_limits<GLfloat>::max();
-    GLfloat maxVariance = std::numeric_limits<GLfloat>::min();
-    GLfloat variance, mean, valuesSum, squaredValuesSum, valueOfVoxel;
-    GLuint i,j,k, valueCount;
-    GLuint absolutePositionInBlock;
-
-    GLuint rawDataSize = static_cast<GLuint>(volumeResolution.x*volumeResolution.y*volumeResolution.z);
-
-    // Calc block sizes represented by one voxel of importance volume
-    GLuint xBlockSize = static_cast<GLuint>(volumeResolution.x/xDim);
-    GLuint yBlockSize = static_cast<GLuint>(volumeResolution.y/yDim);
-    GLuint zBlockSize = static_cast<GLuint>(volumeResolution.z/zDim);
+    // Variances were accumulated before
+    std::vector<GLfloat>& importanceVolumeData = variances;
 
-    // Create vector for variances
-    std::vector<GLfloat> importanceVolumeData(xDim *  yDim * zDim);
-
-    // Calculate variance per voxel of importance volume
-    for(GLuint x = 0; x < xDim; x++)
+    // Find min and max variance
+    GLfloat minVariance = std::numeric_limits<GLfloat>::max();
+    GLfloat maxVariance = 0;
+    for(GLuint i = 0; i < importanceVolumeData.size(); i++)
     {
-        for(GLuint y = 0; y < yDim; y++)
-        {
-            for(GLuint z = 0; z < zDim; z++)
-            {
-                valuesSum = 0;
-                squaredValuesSum = 0;
-                valueCount = 0;
-
-                for(i = 0; i < xBlockSize; i++)
-                {
-                    for(j = 0; j < yBlockSize; j++)
-                    {
-                        for(k = 0; k < zBlockSize; k++)
-                        {
-                            // Absolute position in block in original volume (8 or 16BIT?????)
-                            absolutePositionInBlock = static_cast<GLuint>(x * xBlockSize + i
-                                                + (y * yBlockSize + j) * volumeResolution.x
-                                                + (z * zBlockSize + k) * volumeResolution.x*volumeResolution.y);
-
-                            // Don't go behind border of used memory
-                            if(absolutePositionInBlock >= rawDataSize)
-                            {
-                                continue;
-                            }
-
-                            // Get raw values
-                            if(valueResolution == VOLUME_8BIT)
-                            {
-                                GLubyte value = pRawData[absolutePositionInBlock];
-                                valueOfVoxel = static_cast<GLfloat>(value);
-                            }
-                            else if(valueResolution == VOLUME_16BIT)
-                            {
-                                GLushort value = reinterpret_cast<GLushort*>(pRawData)[absolutePositionInBlock];
-                                valueOfVoxel = static_cast<GLfloat>(value);
-                            }
-
-                            // Sum up values
-                            valuesSum += static_cast<GLfloat>(valueOfVoxel);
-
-                            // Sum up squared values
-                            squaredValuesSum += static_cast<GLfloat>(valueOfVoxel * valueOfVoxel);
-
-                            // Increment counter
-                            valueCount++;
-                        }
-                    }
-                }
-
-                // Calculate mean of block
-                mean = valuesSum/valueCount;
-
-                // Calculate variance
-                variance = (1.0f/valueCount) * squaredValuesSum - (mean*mean);
-
-                // Save variance in vector
-                importanceVolumeData[x + xDim*y + xDim*yDim*z] = variance;
-
-                // New min or max variance found?
-                minVariance = variance < minVariance ? variance : minVariance;
-                maxVariance = variance > maxVariance ? variance : maxVariance;
-            }
-        }
+        minVariance = importanceVolumeData[i] < minVariance ? importanceVolumeData[i] : minVariance;
+        maxVariance = importanceVolumeData[i] > maxVariance ? importanceVolumeData[i] : maxVariance;
     }
 
     // Normalize importance volume's values
-    GLfloat range = maxVariance - minVariance;
+    // Volume without any variance is equally important everywhere
+    GLfloat range = glm::max(maxVariance - minVariance, std::numeric_limits<GLfloat>::min());
     GLfloat importanceValue;
 
-    for(GLuint x = 0; x < xDim; x++)
+    for(GLuint i = 0; i < importanceVolumeData.size(); i++)
     {
-        for(GLuint y = 0; y < yDim; y++)
-        {
-            for(GLuint z = 0; z < zDim; z++)
-            {
-                importanceValue = (importanceVolumeData[x + xDim*y + xDim*yDim*z] - minVariance)/range;
-                importanceVolumeData[x + xDim*y + xDim*yDim*z] = glm::pow(importanceValue, VOLUME_IMPORTANCE_VOLUME_VALUE_POWER_CORRECTION);
-
-            }
-        }
+        importanceValue = (importanceVolumeData[i] - minVariance)/range;
+        importanceVolumeData[i] = glm::pow(importanceValue, VOLUME_IMPORTANCE_VOLUME_VALUE_POWER_CORRECTION);
     }
 
-    // Fill texture
-    glGenTextures(1, &importanceVolumeTextureHandle);
+    // Fill texture, which is created only once
+    if(importanceVolumeTextureHandle == 0)
+    {
+        glGenTextures(1, &importanceVolumeTextureHandle);
+    }
     glBindTexture(GL_TEXTURE_3D, importanceVolumeTextureHandle);
 
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
@@ -328,32 +473,10 @@ glm::vec3 Volume::scaleToMaximumOne(glm::vec3 value)
     glBindTexture(GL_TEXTURE_3D, 0);
  }
 
- void Volume::createHistogram()
+ void Volume::createHistogram(const VolumeStatistics& statistics)
  {
-    GLdouble valueOfVoxel;
-    GLuint voxelCount = static_cast<GLuint>(volumeResolution.x * volumeResolution.y * volumeResolution.z);
-    GLuint bucket;
-    GLdouble bucketSize = (1.0/static_cast<GLdouble>(VOLUME_HISTOGRAMM_BUCKET_COUNT-1));
-
-    std::vector<GLuint> histogram(VOLUME_HISTOGRAMM_BUCKET_COUNT);
-
-    // Create histogram
-    for(GLuint i = 0; i < voxelCount; i++)
-    {
-        if(valueResolution == VOLUME_8BIT)
-        {
-            GLubyte value = pRawData[i];
-            valueOfVoxel = static_cast<GLdouble>(value) / 255.0;
-        }
-        else if(valueResolution == VOLUME_16BIT)
-        {
-            GLushort value = reinterpret_cast<GLushort*>(pRawData)[i];
-            valueOfVoxel = static_cast<GLdouble>(value) / 65535.0;
-        }
-
-        bucket = static_cast<GLuint>(valueOfVoxel / bucketSize);
-        histogram[bucket] = histogram[bucket]+1;
-    }
+    // Histogram was accumulated before
+    const std::vector<GLuint64>& histogram = statistics.getHistogram();
 
     // Get fullest bucket
     GLfloat maxBucket = 1;
@@ -390,3 +513,68 @@ glm::vec3 Volume::scaleToMaximumOne(glm::vec3 value)
     glBindTexture(GL_TEXTURE_1D, 0);
 
  }
+
+void Volume::createGradientVolume(const std::vector<GLubyte>& gradients, GLboolean is16Bit)
+{
+    if(gradientVolumeTextureHandle == 0)
+    {
+        glGenTextures(1, &gradientVolumeTextureHandle);
+    }
+    glBindTexture(GL_TEXTURE_3D, gradientVolumeTextureHandle);
+
+    // Border color would bend normals at extent
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    if(properties.useLinearFiltering)
+    {
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    }
+
+    glTexImage3D(
+        GL_TEXTURE_3D,
+        0,
+        is16Bit ? GL_RGBA16 : GL_RGBA8,
+        static_cast<GLuint>(textureResolution.x),
+        static_cast<GLuint>(textureResolution.y),
+        static_cast<GLuint>(textureResolution.z),
+        0,
+        GL_RGBA,
+        is16Bit ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE,
+        &gradients[0]);
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+void Volume::createBrickExtremaVolume(const VolumeStatistics& rBrickStatistics)
+{
+    std::vector<GLfloat> extrema;
+    VolumeProcessor::packBrickExtrema(rBrickStatistics, valueResolution, extrema);
+    glm::ivec3 brickCount = rBrickStatistics.getBrickCount();
+
+    if(brickExtremaTextureHandle == 0)
+    {
+        glGenTextures(1, &brickExtremaTextureHandle);
+    }
+    glBindTexture(GL_TEXTURE_3D, brickExtremaTextureHandle);
+
+    // Raycaster fetches single bricks
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RG32F, brickCount.x, brickCount.y, brickCount.z, 0, GL_RG, GL_FLOAT, &extrema[0]);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    // Empty space map is computed from same bricks
+    emptySpaceMap.init(extrema, brickCount);
+    emptySpaceMapUploaded = GL_FALSE;
+}
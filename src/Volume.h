@@ -20,7 +20,11 @@
  * Volume
  *--------------
  * Holds volume data, texture data, histogram and
- * importance volume.
+ * importance volume. Mip levels of values are kept
+ * for level of detail. Resolution of importance volume
+ * can be changed any time with the summed volume
+ * table. Empty space map is recomputed in background
+ * when transferfunction changes.
  *
  */
 
@@ -37,19 +41,22 @@
 
 #include "Logger.h"
 #include "VolumeProperties.h"
+#include "VolumeStatistics.h"
+#include "SummedVolumeTable.h"
+#include "VolumePyramid.h"
+#include "JointHistogram.h"
+#include "EmptySpaceMap.h"
+#include "GradientVolume.h"
+#include "VolumeProcessor.h"
+#include "RawData.h"
 #include "Utilities.h"
 
-const GLint VOLUME_IMPORTANCE_VOLUME_DOWNSCALE = 4;
 const GLboolean VOLUME_IMPORTANCE_VOLUME_LINEAR_FILTERING = GL_TRUE;
-const GLuint VOLUME_HISTOGRAMM_BUCKET_COUNT = 256;
 const GLfloat VOLUME_HISTOGRAMM_VALUE_POWER_CORRECTION = 0.25f;
 const GLfloat VOLUME_IMPORTANCE_VOLUME_VALUE_POWER_CORRECTION = 0.5f;
 const GLfloat VOLUME_PIVOT = 0.5f;
-
-enum VolumeValueResolution
-{
-    VOLUME_8BIT, VOLUME_16BIT
-};
+const GLboolean VOLUME_GRADIENT_VOLUME_16BIT = GL_FALSE;
+const VolumePyramidReduction VOLUME_PYRAMID_REDUCTION = VOLUMEPYRAMID_AVERAGE;
 
 class Volume
 {
@@ -60,6 +67,7 @@ public:
     /** Friends of this class */
     friend class VolumeCreator;
 
+    /** Takes over raw data, summed volume table and pyramid, which are built by creator */
     void init(
         GLint handle,
         std::string name,
@@ -67,7 +75,10 @@ public:
         glm::vec3 volumeResolution,
         glm::vec3 voxelScale,
         VolumeValueResolution valueResolution,
-        GLubyte* pRawData);
+        RawData* pRawData,
+        const VolumeStatistics* pStatistics,
+        SummedVolumeTable& rSummedVolumeTable,
+        VolumePyramid& rPyramid);
 
     /** Get value resolution */
     VolumeValueResolution getValueResolution() const;
@@ -75,12 +86,18 @@ public:
     /** Get volume resolution */
     glm::vec3 getVolumeResolution() const;
 
+    /** Get resolution of texture, which is smaller than volume resolution if volume did not fit device or budget */
+    glm::vec3 getTextureResolution() const;
+
     /** Get voxel scale */
     glm::vec3 getVoxelScale() const;
 
     /** Get rendering scale */
     glm::vec3 getRenderingScale() const;
 
+    /** Get offset in voxels of volume this one was read from as region */
+    glm::vec3 getRegionOffset() const;
+
     /** Get properties */
     VolumeProperties getProperties() const;
 
@@ -90,15 +107,51 @@ public:
     /** Set pivot */
     void setPivot(glm::vec3 pivot);
 
+    /** Get statistics accumulated at creation */
+    const VolumeStatistics& getStatistics() const;
+
+    /** Get summed volume table built at creation, volumes of bricked files build it on first change of downscale */
+    const SummedVolumeTable& getSummedVolumeTable() const;
+
+    /** Get mip levels built at creation, they have resolution of texture and are its levels */
+    const VolumePyramid& getPyramid() const;
+
+    /** Get downscale of importance volume */
+    GLint getImportanceVolumeDownscale() const;
+
+    /** Recreates importance volume with downscale from summed volume table */
+    void setImportanceVolumeDownscale(GLint downscale);
+
     /** Returns texture handle */
     GLuint getTextureHandle() const;
 
     /** Returns importance volume texture handle */
     GLuint getImportanceVolumeTextureHandle() const;
 
+    /** Returns texture handle of packed gradients, zero while they are computed in background if they were not precomputed */
+    GLuint getGradientVolumeTextureHandle();
+
+    /** Returns texture handle of minimum and maximum per brick of statistics for empty space skipping */
+    GLuint getBrickExtremaTextureHandle() const;
+
+    /** Bricks per unit of texture coordinates, bricks are built over texels */
+    glm::vec3 getBrickGridScale() const;
+
+    /** Recomputes empty space map in background if alpha of transferfunction or mapping of values changed */
+    void updateEmptySpaceMap(const std::vector<glm::vec4>& colorAlphaFunction);
+
+    /** Returns texture handle of distances in bricks to nearest brick which is not empty, zero while they are computed in background */
+    GLuint getEmptySpaceMapTextureHandle();
+
     /** Returns histogram texture handle */
     GLuint getHistogramTextureHandle() const;
 
+    /** Returns texture handle of joint histogram of value and gradient magnitude, zero while it is computed in background */
+    GLuint getJointHistogramTextureHandle();
+
+    /** Get joint histogram of value and gradient magnitude */
+    const JointHistogram& getJointHistogram() const;
+
     /** Returns handle */
     GLint getHandle() const;
 
@@ -112,14 +165,26 @@ public:
     void rename(std::string name);
 
 protected:
+    /** Value of voxel at index, mapped like histogram */
+    template<typename T> GLdouble readVoxel(size_t index) const;
+
+    /** Advises random access to raw data, once no background pass reads it sequentially */
+    void adviseRandomAccess();
+
     /** Scales vec3 per component, maximum per component is one */
     glm::vec3 scaleToMaximumOne(glm::vec3 value);
 
-    /** Create importance volume by using variance of values */
-    void createImportanceVolume();
+    /** Create or replace importance volume by using variance of values */
+    void createImportanceVolume(std::vector<GLfloat> variances, glm::ivec3 resolution);
 
     /** Creates histogram */
-    void createHistogram();
+    void createHistogram(const VolumeStatistics& statistics);
+
+    /** Creates texture of packed gradients */
+    void createGradientVolume(const std::vector<GLubyte>& gradients, GLboolean is16Bit);
+
+    /** Creates texture of minimum and maximum per brick from statistics, which have resolution of texture */
+    void createBrickExtremaVolume(const VolumeStatistics& rBrickStatistics);
 
     /** Basics */
     GLint handle;
@@ -132,24 +197,57 @@ protected:
     /** Volume resolution */
     glm::vec3 volumeResolution;
 
+    /** Resolution of texture, values in full volume resolution stay on CPU */
+    glm::vec3 textureResolution;
+
     /** Scale of voxels */
     glm::vec3 voxelScale;
 
-    /** 8Bit oder 16Bit depth */
+    /** Type of values */
     VolumeValueResolution valueResolution;
 
-    /** Raw data is saved for saving as xml */
-    GLubyte* pRawData;
+    /** Raw data is saved for saving as xml, owned by volume */
+    RawData* pRawData;
+    GLboolean randomAccessAdvised;
+
+    /** Histogram, variances and brick extrema, kept for bricked saving */
+    VolumeStatistics statistics;
 
-    /** Handle to texture of importance volume */
+    /** Sums of values and squared values, owned by volume */
+    SummedVolumeTable summedVolumeTable;
+
+    /** Mip levels of texture, owned by volume */
+    VolumePyramid pyramid;
+
+    /** Handle to texture of importance volume and its downscale */
     GLuint importanceVolumeTextureHandle;
+    GLint importanceVolumeDownscale;
 
     /** Handle to texture of histogram */
     GLuint histogramTextureHandle;
 
+    /** Background computation of gradients and handle to their texture, zero until they are computed */
+    GradientVolume gradientVolume;
+    GLuint gradientVolumeTextureHandle;
+
+    /** Handle to texture of brick extrema */
+    GLuint brickExtremaTextureHandle;
+
+    /** Empty space map and its texture, which is filled when computation for current transferfunction is done */
+    EmptySpaceMap emptySpaceMap;
+    GLuint emptySpaceMapTextureHandle;
+    GLboolean emptySpaceMapUploaded;
+
+    /** Joint histogram and its texture, which is created when computation is done */
+    JointHistogram jointHistogram;
+    GLuint jointHistogramTextureHandle;
+
     /** Rendering scale */
     glm::vec3 renderingScale;
 
+    /** Offset of region */
+    glm::vec3 regionOffset;
+
     /** Properties */
     VolumeProperties properties;
 };
@@ -0,0 +1,181 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "VolumeCodec.h"
+
+size_t VolumeCodec::getCompressedBound(size_t size, size_t bytesPerVoxel)
+{
+    // Every group stores its width and at most all bits of its values
+    size_t groups = (size / bytesPerVoxel + VOLUMECODEC_GROUP_SIZE - 1) / VOLUMECODEC_GROUP_SIZE;
+    return groups * (1 + VOLUMECODEC_GROUP_SIZE * bytesPerVoxel);
+}
+
+size_t VolumeCodec::compress(const GLubyte* pData, size_t size, size_t rowSize, size_t bytesPerVoxel, std::vector<GLubyte>& rOutput)
+{
+    size_t start = rOutput.size();
+    rOutput.resize(start + getCompressedBound(size, bytesPerVoxel));
+
+    size_t compressedSize;
+    if(bytesPerVoxel == 1)
+    {
+        compressedSize = compressRows(pData, size, rowSize, &rOutput[start]);
+    }
+    else if(bytesPerVoxel == 2)
+    {
+        compressedSize = compressRows(reinterpret_cast<const GLushort*>(pData), size / 2, rowSize / 2, &rOutput[start]);
+    }
+    else
+    {
+        // Bits of positive floats are ordered like their values, so prediction works for them, too
+        compressedSize = compressRows(reinterpret_cast<const GLuint*>(pData), size / 4, rowSize / 4, &rOutput[start]);
+    }
+
+    rOutput.resize(start + compressedSize);
+    return compressedSize;
+}
+
+GLboolean VolumeCodec::decompress(const GLubyte* pCompressed, size_t compressedSize, GLubyte* pData, size_t size, size_t rowSize, size_t bytesPerVoxel)
+{
+    if(bytesPerVoxel == 1)
+    {
+        return decompressRows(pCompressed, compressedSize, pData, size, rowSize);
+    }
+    else if(bytesPerVoxel == 2)
+    {
+        return decompressRows(pCompressed, compressedSize, reinterpret_cast<GLushort*>(pData), size / 2, rowSize / 2);
+    }
+    else
+    {
+        return decompressRows(pCompressed, compressedSize, reinterpret_cast<GLuint*>(pData), size / 4, rowSize / 4);
+    }
+}
+
+template<typename T> size_t VolumeCodec::compressRows(const T* pValues, size_t count, size_t rowLength, GLubyte* pOutput)
+{
+    const GLuint bits = sizeof(T) * 8;
+    GLubyte* pWrite = pOutput;
+    T residuals[VOLUMECODEC_GROUP_SIZE];
+
+    for(size_t group = 0; group < count; group += VOLUMECODEC_GROUP_SIZE)
+    {
+        size_t groupCount = (count - group < VOLUMECODEC_GROUP_SIZE) ? count - group : VOLUMECODEC_GROUP_SIZE;
+
+        // Zigzag encoded difference to left neighbour, first value of row is predicted by zero
+        T combined = 0;
+        size_t column = group % rowLength;
+        for(size_t i = 0; i < VOLUMECODEC_GROUP_SIZE; i++)
+        {
+            size_t index = group + i;
+            T residual = 0;
+            if(i < groupCount)
+            {
+                T prediction = (column == 0) ? 0 : pValues[index - 1];
+                T difference = static_cast<T>(pValues[index] - prediction);
+                residual = static_cast<T>((difference << 1) ^ (0 - (difference >> (bits - 1))));
+                column = (column + 1 == rowLength) ? 0 : column + 1;
+            }
+            residuals[i] = residual;
+            combined |= residual;
+        }
+
+        // Width of widest residual
+        GLuint width = 0;
+        while(width < bits && (combined >> width) != 0)
+        {
+            width++;
+        }
+        *pWrite++ = static_cast<GLubyte>(width);
+
+        // Pack residuals, group size times width is always a multiple of eight
+        GLuint64 buffer = 0;
+        GLuint bufferBits = 0;
+        for(size_t i = 0; i < VOLUMECODEC_GROUP_SIZE && width > 0; i++)
+        {
+            buffer |= static_cast<GLuint64>(residuals[i]) << bufferBits;
+            bufferBits += width;
+            while(bufferBits >= 8)
+            {
+                *pWrite++ = static_cast<GLubyte>(buffer);
+                buffer >>= 8;
+                bufferBits -= 8;
+            }
+        }
+    }
+
+    return static_cast<size_t>(pWrite - pOutput);
+}
+
+template<typename T> GLboolean VolumeCodec::decompressRows(const GLubyte* pCompressed, size_t compressedSize, T* pValues, size_t count, size_t rowLength)
+{
+    const GLuint bits = sizeof(T) * 8;
+    const GLubyte* pRead = pCompressed;
+    const GLubyte* pEnd = pCompressed + compressedSize;
+    T residuals[VOLUMECODEC_GROUP_SIZE];
+
+    for(size_t group = 0; group < count; group += VOLUMECODEC_GROUP_SIZE)
+    {
+        size_t groupCount = (count - group < VOLUMECODEC_GROUP_SIZE) ? count - group : VOLUMECODEC_GROUP_SIZE;
+
+        if(pRead >= pEnd)
+        {
+            return GL_FALSE;
+        }
+        GLuint width = *pRead++;
+        if(width > bits || pRead + (VOLUMECODEC_GROUP_SIZE * width) / 8 > pEnd)
+        {
+            return GL_FALSE;
+        }
+
+        // Unpack residuals
+        if(width == 0)
+        {
+            memset(residuals, 0, sizeof(residuals));
+        }
+        else
+        {
+            GLuint64 buffer = 0;
+            GLuint bufferBits = 0;
+            GLuint64 mask = (static_cast<GLuint64>(1) << width) - 1;
+            for(size_t i = 0; i < VOLUMECODEC_GROUP_SIZE; i++)
+            {
+                while(bufferBits < width)
+                {
+                    buffer |= static_cast<GLuint64>(*pRead++) << bufferBits;
+                    bufferBits += 8;
+                }
+                residuals[i] = static_cast<T>(buffer & mask);
+                buffer >>= width;
+                bufferBits -= width;
+            }
+        }
+
+        // Undo zigzag encoding and prediction
+        size_t column = group % rowLength;
+        for(size_t i = 0; i < groupCount; i++)
+        {
+            size_t index = group + i;
+            T residual = residuals[i];
+            T difference = static_cast<T>((residual >> 1) ^ (0 - (residual & 1)));
+            T prediction = (column == 0) ? 0 : pValues[index - 1];
+            pValues[index] = static_cast<T>(prediction + difference);
+            column = (column + 1 == rowLength) ? 0 : column + 1;
+        }
+    }
+
+    return GL_TRUE;
+}
@@ -0,0 +1,59 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VolumeCodec
+ *--------------
+ * Fast lossless codec for blocks of raw volume data.
+ * Values are predicted from their left neighbour in each
+ * row, residuals are zigzag encoded and bit packed in
+ * groups sharing one width.
+ *
+ */
+
+#ifndef VOLUMECODEC_H_
+#define VOLUMECODEC_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+
+#include <vector>
+#include <cstring>
+
+const GLuint VOLUMECODEC_GROUP_SIZE = 32;
+
+class VolumeCodec
+{
+public:
+    /** Maximal size of compressed block */
+    static size_t getCompressedBound(size_t size, size_t bytesPerVoxel);
+
+    /** Compresses block of complete rows, appends to output and returns compressed size */
+    static size_t compress(const GLubyte* pData, size_t size, size_t rowSize, size_t bytesPerVoxel, std::vector<GLubyte>& rOutput);
+
+    /** Decompresses block of complete rows, returns whether compressed data was consistent */
+    static GLboolean decompress(const GLubyte* pCompressed, size_t compressedSize, GLubyte* pData, size_t size, size_t rowSize, size_t bytesPerVoxel);
+
+private:
+    VolumeCodec();
+
+    template<typename T> static size_t compressRows(const T* pValues, size_t count, size_t rowLength, GLubyte* pOutput);
+    template<typename T> static GLboolean decompressRows(const GLubyte* pCompressed, size_t compressedSize, T* pValues, size_t count, size_t rowLength);
+};
+
+#endif
@@ -20,58 +20,50 @@
 
 VolumeCreator::VolumeCreator()
 {
+    pProgress = NULL;
+    maxTextureResolution = 0;
 }
 
 VolumeCreator::~VolumeCreator()
 {
 }
 
-Volume* VolumeCreator::importPVM(std::string name, GLint handle)
+VolumeData* VolumeCreator::preparePVM(std::string name)
 {
-    std::string path = VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm";
+    std::string path = findImportFile(VOLUMECREATOR_SUBDIR_PVM, name, ".pvm");
 
-    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+    FileReader reader;
 
     // Check whether file exisits
-    if(!in.is_open())
+    if(!reader.open(path))
     {
-        // Try it without ".pvm"
-        std::string path = VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name;
-        in.open(path.c_str(), std::ios::in|std::ios::binary);
-
-        // Ok, there is really no file
-        if(!in.is_open())
-        {
-            LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' was not found!");
-            return NULL;
-        }
+        LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' was not found!");
+        return NULL;
     }
 
     // *** READ HEADER ***
-    in.seekg(0, std::ios::beg);
-    GLchar buffer[5];
-    GLchar nextLineDummy;
+
+    // Header is short, so it is parsed from first bytes instead of read byte by byte
+    std::vector<GLubyte> header(static_cast<size_t>(glm::min(reader.getSize(), static_cast<GLuint64>(VOLUMECREATOR_PVM_HEADER_MAX_SIZE))));
+    header.resize(reader.read(header.data(), header.size()));
 
     // Format
-    in.read(buffer, 4*sizeof(GLchar));
-    buffer[4] = 0;
-    std::string format(buffer);
-    if(format != "PVM3")
+    std::string format(header.begin(), header.begin() + glm::min(header.size(), static_cast<size_t>(4)));
+    if(format == VOLUMECREATOR_DDS_ID_V3D.substr(0, 4))
     {
-        LogWarning("Cannot import anything else than PVM3");
-        return NULL;
+        return prepareCompressedPVM(&reader, name);
     }
-    in.read(&nextLineDummy, sizeof(GLchar));
 
     // *** READ INFORMATION ABOUT VOLUME ***
     glm::vec3 res;
     glm::vec3 scale;
     GLint bitDepth;
-
-    // Read resolution
-    res.x = static_cast<GLfloat>(extractIntFromCharArray(&in));
-    res.y = static_cast<GLfloat>(extractIntFromCharArray(&in));
-    res.z = static_cast<GLfloat>(extractIntFromCharArray(&in));
+    size_t headerSize;
+    if(!parsePVMHeader(header.data(), header.size(), res, scale, bitDepth, headerSize))
+    {
+        LogWarning("Cannot import anything else than PVM, PVM2 or PVM3 with one or two bytes per voxel");
+        return NULL;
+    }
 
     if(res.x < 4 || res.y < 4 || res.z < 4)
     {
@@ -79,76 +71,79 @@ Volume* VolumeCreator::importPVM(std::string name, GLint handle)
         return NULL;
     }
 
-    // Read scales
-    scale.x = extractFloatFromCharArray(&in);
-    scale.y = extractFloatFromCharArray(&in);
-    scale.z = extractFloatFromCharArray(&in);
-
-    // Read value resolution (bitDepth is 1 (8Bit) or 2 (16 bit))
-    bitDepth = extractIntFromCharArray(&in);
+    // Value resolution (bitDepth is 1 (8Bit) or 2 (16 bit))
+    VolumeValueResolution valueResolution = (bitDepth == 1) ? VOLUME_8BIT : VOLUME_16BIT;
 
     // *** READ RAW DATA ***
 
-    GLuint voxelCount = static_cast<GLuint>(res.x * res.y * res.z);
-    GLubyte* volumeData = (GLubyte*)calloc(voxelCount, bitDepth * sizeof(GLubyte));
-
-    // Read data
-    in.read((char*)volumeData, voxelCount * bitDepth * sizeof(GLubyte));
-
-    // Close file
-    in.close();
-
-    // Value resolution
-    VolumeValueResolution valueResolution;
-    if(bitDepth == 1)
+    VolumeData* pData = new VolumeData();
+    RawData* pRawData = NULL;
+    glm::ivec3 regionOffset, regionSize;
+    if(findRegion(res, regionOffset, regionSize))
     {
-        valueResolution = VOLUME_8BIT;
+        // Only rows of region are read
+        reader.close();
+        pRawData = readRegion(path, headerSize, res, getBytesPerVoxel(valueResolution), regionOffset, regionSize);
+        if(pRawData == NULL)
+        {
+            delete pData;
+            return NULL;
+        }
+        res = glm::vec3(regionSize);
+        pData->regionOffset = glm::vec3(regionOffset);
     }
     else
     {
-        valueResolution = VOLUME_16BIT;
-    }
-
-    GLuint textureHandle = createTexture(volumeData, res, valueResolution, VOLUMEPROPERTIES_USE_LINEAR_FILTERING);
-
-    // *** CREATE VOLUME ***
-    Volume* pVolume = new Volume();
+        GLuint64 voxelCount = getVoxelCount(res);
+        pRawData = new RawData();
+        if(!pRawData->allocate(static_cast<size_t>(voxelCount * bitDepth) * sizeof(GLubyte)))
+        {
+            delete pRawData;
+            delete pData;
+            return NULL;
+        }
 
-    // Initialize volume
-    pVolume->init(handle, name, textureHandle, res, scale, valueResolution, volumeData);
+        // Read data and accumulate statistics on the fly
+        reader.seek(headerSize);
+        if(!streamRawData(&reader, pRawData->getWritableData(), res, valueResolution, &(pData->statistics)))
+        {
+            if(!isCancelled())
+            {
+                LogError("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' ended before all voxels were read!");
+            }
+            delete pRawData;
+            delete pData;
+            return NULL;
+        }
+    }
+    pData->regionRead = GL_TRUE;
 
-    // Volume raw data is freed by volume object at destruction
+    pData->name = name;
+    pData->volumeResolution = res;
+    pData->voxelScale = scale;
+    pData->valueResolution = valueResolution;
+    pData->pRawData = pRawData;
 
-    return pVolume;
+    return pData;
 }
 
-Volume* VolumeCreator::importDAT(std::string name, GLint handle)
+VolumeData* VolumeCreator::prepareDAT(std::string name)
 {
-    std::string path = VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_DAT + name + ".dat";
+    std::string path = findImportFile(VOLUMECREATOR_SUBDIR_DAT, name, ".dat");
 
-    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+    FileReader reader;
 
     // Check whether file exisits
-    if(!in.is_open())
+    if(!reader.open(path))
     {
-        // Try it without ".dat"
-        std::string path = VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_DAT + name;
-        in.open(path.c_str(), std::ios::in|std::ios::binary);
-
-        // Ok, there is really no file
-        if(!in.is_open())
-        {
-            LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_DAT + name + ".dat' was not found!");
-            return NULL;
-        }
+        LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_DAT + name + ".dat' was not found!");
+        return NULL;
     }
 
     // *** READ HEADER ***
-    in.seekg(0, std::ios::beg);
-    GLushort xdim, ydim, zdim;
-    in.read((GLchar*)(&xdim), sizeof(GLushort));
-    in.read((GLchar*)(&ydim), sizeof(GLushort));
-    in.read((GLchar*)(&zdim), sizeof(GLushort));
+    GLushort dimensions[3] = {0, 0, 0};
+    reader.read(reinterpret_cast<GLubyte*>(dimensions), sizeof(dimensions));
+    GLushort xdim = dimensions[0], ydim = dimensions[1], zdim = dimensions[2];
     glm::vec3 res(xdim, ydim, zdim);
 
     if(res.x < 4 || res.y < 4 || res.z < 4)
@@ -159,38 +154,54 @@ Volume* VolumeCreator::importDAT(std::string name, GLint handle)
 
     // *** READ RAW DATA ***
 
-    GLuint voxelCount = static_cast<GLuint>(res.x * res.y * res.z);
-    GLubyte* volumeData = (GLubyte*)calloc(voxelCount, sizeof(GLushort));
-
-    // Read data
-    in.read((GLchar*)volumeData, voxelCount * sizeof(GLushort));
-
-    GLuint textureHandle = createTexture(volumeData, res, VOLUME_16BIT, VOLUMEPROPERTIES_USE_LINEAR_FILTERING);
-
-    /*
-    // Some hack to load giant volumes. 16Bit depth is too much, so let reduce it
-    GLushort value;
-    GLfloat tmpValue;
-    GLubyte* volumeData = (GLubyte*)calloc(voxelCount, sizeof(GLubyte));
-    GLuint iterations =  xdim*ydim*zdim;
-    for(GLuint i = 0; i < iterations; i++)
+    VolumeData* pData = new VolumeData();
+    RawData* pRawData = NULL;
+    glm::ivec3 regionOffset, regionSize;
+    if(findRegion(res, regionOffset, regionSize))
     {
-        in.read((GLchar*)(&value), sizeof(GLushort));
-        tmpValue = value/65535.0f * 20.0f * 255.0f;
-        volumeData[i] = static_cast<GLubyte>(tmpValue);
-
+        // Only rows of region are read, they follow the three dimensions
+        reader.close();
+        pRawData = readRegion(path, 3 * sizeof(GLushort), res, sizeof(GLushort), regionOffset, regionSize);
+        if(pRawData == NULL)
+        {
+            delete pData;
+            return NULL;
+        }
+        res = glm::vec3(regionSize);
+        pData->regionOffset = glm::vec3(regionOffset);
     }
-    GLuint textureHandle = createTexture(volumeData, res, VOLUME_8BIT, VOLUMEPROPERTIES_USE_LINEAR_FILTERING);*/
-
-    // *** CREATE VOLUME ***
-    Volume* pVolume = new Volume();
+    else
+    {
+        GLuint64 voxelCount = getVoxelCount(res);
+        pRawData = new RawData();
+        if(!pRawData->allocate(static_cast<size_t>(voxelCount) * sizeof(GLushort)))
+        {
+            delete pRawData;
+            delete pData;
+            return NULL;
+        }
 
-    // Initialize volume
-    pVolume->init(handle, name, textureHandle, res, glm::vec3(1,1,1), VOLUME_16BIT, volumeData);
+        // Read data and accumulate statistics on the fly
+        if(!streamRawData(&reader, pRawData->getWritableData(), res, VOLUME_16BIT, &(pData->statistics)))
+        {
+            if(!isCancelled())
+            {
+                LogError("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_DAT + name + ".dat' ended before all voxels were read!");
+            }
+            delete pRawData;
+            delete pData;
+            return NULL;
+        }
+    }
+    pData->regionRead = GL_TRUE;
 
-    // Volume raw data is freed by volume object at destruction
+    pData->name = name;
+    pData->volumeResolution = res;
+    pData->voxelScale = glm::vec3(1,1,1);
+    pData->valueResolution = VOLUME_16BIT;
+    pData->pRawData = pRawData;
 
-    return pVolume;
+    return pData;
 }
 
 Volume* VolumeCreator::createDefaultVolume(std::string name, GLint handle)
@@ -200,7 +211,9 @@ Volume* VolumeCreator::createDefaultVolume(std::string name, GLint handle)
     const GLuint zdim = 4;
 
     // Initialize
-    GLubyte* volumeData = (GLubyte*)calloc(xdim * ydim * zdim, sizeof(GLubyte));
+    RawData* pRawData = new RawData();
+    pRawData->allocate(xdim * ydim * zdim * sizeof(GLubyte));
+    GLubyte* volumeData = pRawData->getWritableData();
     for(GLint i = 0; i < xdim; i++)
     {
         for(GLint j = 0; j < ydim; j++)
@@ -212,231 +225,2530 @@ Volume* VolumeCreator::createDefaultVolume(std::string name, GLint handle)
         }
     }
 
-    GLuint textureHandle = createTexture(volumeData, glm::vec3(xdim, ydim, zdim), VOLUME_8BIT, VOLUMEPROPERTIES_USE_LINEAR_FILTERING);
+    SummedVolumeTable summedVolumeTable;
+    summedVolumeTable.build(volumeData, glm::vec3(xdim, ydim, zdim), VOLUME_8BIT);
+    VolumePyramid pyramid;
+    pyramid.build(volumeData, glm::vec3(xdim, ydim, zdim), VOLUME_8BIT, VOLUME_PYRAMID_REDUCTION);
+    GLuint textureHandle = createTexture(volumeData, glm::vec3(xdim, ydim, zdim), VOLUME_8BIT, VOLUMEPROPERTIES_USE_LINEAR_FILTERING, &pyramid);
 
     // Create volume object
     Volume* pVolume = new Volume();
 
     // Initialize volume
-    pVolume->init(handle, name, textureHandle, glm::vec3(xdim, ydim, zdim), glm::vec3(1.0f), VOLUME_8BIT, volumeData);
+    pVolume->init(handle, name, textureHandle, glm::vec3(xdim, ydim, zdim), glm::vec3(1.0f), VOLUME_8BIT, pRawData, NULL, summedVolumeTable, pyramid);
 
     return pVolume;
 }
 
-GLboolean VolumeCreator::writeToFile(Volume* pVolume, GLboolean overwriteExisting)
+VolumeData* VolumeCreator::prepareNRRD(std::string name)
 {
-    // Check whether there exists already a file with that name
-    if(!overwriteExisting)
+    std::string path = findImportFile(VOLUMECREATOR_SUBDIR_NRRD, name, ".nrrd");
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+
+    // Check whether file exisits
+    if(!in.is_open())
     {
-        // Read XML from file
-        std::ifstream in(std::string(VOLUMECREATOR_PATH + pVolume->getName() + ".xml").c_str());
+        LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_NRRD + name + ".nrrd' was not found!");
+        return NULL;
+    }
 
-        // Check whether file exisits
-        if(in.is_open())
-        {
-            LogError("'" + VOLUMECREATOR_PATH + pVolume->getName() + ".xml' already exists!");
-            return GL_FALSE;
-        }
+    // *** READ HEADER ***
+    std::string line;
+    std::getline(in, line);
+    if(line.compare(0, 4, "NRRD") != 0)
+    {
+        LogWarning("Cannot import anything else than NRRD");
+        return NULL;
     }
 
-    // Document object
-    rapidxml::xml_document<> doc;
+    VoxelType type = VOXEL_UNKNOWN;
+    GLint dimension = 0;
+    glm::vec3 res(0, 0, 0);
+    glm::vec3 scale(1, 1, 1);
+    GLboolean bigEndian = GL_FALSE;
+    std::string encoding = "raw";
+    std::string dataFile;
+    GLint byteSkip = 0;
+    GLint lineSkip = 0;
+
+    // Fields until empty line
+    while(std::getline(in, line))
+    {
+        line = trimHeaderValue(line);
+        if(line.empty())
+        {
+            break;
+        }
+        size_t separator = line.find(": ");
+        if(line[0] == '#' || separator == std::string::npos)
+        {
+            continue;
+        }
 
-    // XML declaration
-    rapidxml::xml_node<>* pDeclNode = doc.allocate_node(rapidxml::node_declaration);
-    pDeclNode->append_attribute(doc.allocate_attribute("version", "1.0"));
-    pDeclNode->append_attribute(doc.allocate_attribute("encoding", "utf-8"));
-    doc.append_node(pDeclNode);
+        std::string field = line.substr(0, separator);
+        std::string value = trimHeaderValue(line.substr(separator + 2));
+        std::istringstream values(value);
 
-    // Root node
-    rapidxml::xml_node<>* pRootNode = doc.allocate_node(rapidxml::node_element, "volume");
-    pRootNode->append_attribute(doc.allocate_attribute("version", "1.0"));
-    doc.append_node(pRootNode);
+        if(field == "type")
+        {
+            type = VoxelConverter::parseType(value);
+        }
+        else if(field == "dimension")
+        {
+            values >> dimension;
+        }
+        else if(field == "sizes")
+        {
+            values >> res.x >> res.y >> res.z;
+        }
+        else if(field == "spacings")
+        {
+            // Missing spacing is given as nan
+            std::string spacing;
+            for(GLint i = 0; i < 3 && (values >> spacing); i++)
+            {
+                GLfloat number = static_cast<GLfloat>(atof(spacing.c_str()));
+                scale[i] = (number > 0) ? number : 1.0f;
+            }
+        }
+        else if(field == "space directions")
+        {
+            // Length of each direction vector is spacing
+            std::string direction;
+            for(GLint i = 0; i < 3 && (values >> direction); i++)
+            {
+                glm::vec3 vector(0, 0, 0);
+                if(sscanf(direction.c_str(), "(%f,%f,%f)", &vector.x, &vector.y, &vector.z) == 3 && glm::length(vector) > 0)
+                {
+                    scale[i] = glm::length(vector);
+                }
+            }
+        }
+        else if(field == "endian")
+        {
+            bigEndian = (value == "big");
+        }
+        else if(field == "encoding")
+        {
+            encoding = value;
+        }
+        else if(field == "data file" || field == "datafile")
+        {
+            dataFile = value;
+        }
+        else if(field == "byte skip" || field == "byteskip")
+        {
+            values >> byteSkip;
+        }
+        else if(field == "line skip" || field == "lineskip")
+        {
+            values >> lineSkip;
+        }
+    }
 
-    // Get properties
-    VolumeProperties properties = pVolume->getProperties();
+    if(type == VOXEL_UNKNOWN || dimension != 3)
+    {
+        LogWarning("Cannot import anything else than three dimensional NRRD with scalar type");
+        return NULL;
+    }
+    if(encoding != "raw")
+    {
+        LogWarning("Cannot import NRRD with encoding '" + encoding + "', only raw is supported");
+        return NULL;
+    }
+    if(res.x < 4 || res.y < 4 || res.z < 4)
+    {
+        LogError("'" + path + "' resolution too low (under 4x4x4)!");
+        return NULL;
+    }
 
-    // Mirror
-    appendBool(properties.mirrorX, "mirrorX", &doc, pRootNode);
-    appendBool(properties.mirrorY, "mirrorY", &doc, pRootNode);
-    appendBool(properties.mirrorZ, "mirrorZ", &doc, pRootNode);
+    // Data is either attached after header or in separate file
+    std::string dataPath = path;
+    if(!dataFile.empty())
+    {
+        if(dataFile.find("LIST") == 0 || dataFile.find('%') != std::string::npos)
+        {
+            LogWarning("Cannot import NRRD with data split into multiple files");
+            return NULL;
+        }
+        in.close();
+        dataPath = resolveDataFile(path, dataFile);
+        in.open(dataPath.c_str(), std::ios::in|std::ios::binary);
+        if(!in.is_open())
+        {
+            LogWarning("'" + dataPath + "' was not found!");
+            return NULL;
+        }
+    }
 
-    // Filtering
-    appendBool(properties.useLinearFiltering, "useLinearFiltering", &doc, pRootNode);
+    // Skip lines and bytes before data
+    for(GLint i = 0; i < lineSkip; i++)
+    {
+        std::getline(in, line);
+    }
+    GLint64 offset = static_cast<GLint64>(in.tellg());
+    in.close();
 
-    // Volume resolution
-    appendVec3(pVolume->getVolumeResolution(), "volumeResolution", &doc, pRootNode);
+    return prepareForeignData(name, dataPath, offset, byteSkip, res, scale, type, bigEndian);
+}
 
-    // Voxel scale
-    appendVec3(pVolume->getVoxelScale(), "voxelScale", &doc, pRootNode);
+VolumeData* VolumeCreator::prepareMHD(std::string name)
+{
+    std::string path = findImportFile(VOLUMECREATOR_SUBDIR_MHD, name, ".mhd");
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
 
-    // Value resolution
-    GLfloat bitDepth = 8;
-    if (pVolume->getValueResolution() == VOLUME_16BIT)
+    // Check whether file exisits
+    if(!in.is_open())
     {
-        bitDepth = 16;
+        LogWarning("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_MHD + name + ".mhd' was not found!");
+        return NULL;
     }
-    appendFloat(bitDepth, "valueResolution", &doc, pRootNode);
-
-    // Voxel scale multiplier
-    appendVec3(properties.voxelScaleMultiplier, "voxelScaleMultiplier", &doc, pRootNode);
-
-    // Value offset
-    appendFloat(properties.valueOffset, "valueOffset", &doc, pRootNode);
 
-    // Value scale
-    appendFloat(properties.valueScale, "valueScale", &doc, pRootNode);
+    // *** READ HEADER ***
+    VoxelType type = VOXEL_UNKNOWN;
+    GLint dimension = 0;
+    GLint channels = 1;
+    glm::vec3 res(0, 0, 0);
+    glm::vec3 scale(1, 1, 1);
+    GLboolean spacingGiven = GL_FALSE;
+    GLboolean bigEndian = GL_FALSE;
+    GLboolean compressed = GL_FALSE;
+    std::string dataFile;
+    GLint headerSize = 0;
+    std::string line;
+
+    // Element data file is last entry
+    while(dataFile.empty() && std::getline(in, line))
+    {
+        size_t separator = line.find('=');
+        if(separator == std::string::npos)
+        {
+            continue;
+        }
 
-    // Rotation
-    appendVec3(properties.eulerZXZRotation, "eulerZXZRotation", &doc, pRootNode);
+        std::string field = trimHeaderValue(line.substr(0, separator));
+        std::string value = trimHeaderValue(line.substr(separator + 1));
+        std::istringstream values(value);
 
-    // Printing
-    std::string xml_as_string;
-    rapidxml::print(std::back_inserter(xml_as_string), doc);
+        if(field == "NDims")
+        {
+            values >> dimension;
+        }
+        else if(field == "DimSize")
+        {
+            values >> res.x >> res.y >> res.z;
+        }
+        else if(field == "ElementSpacing")
+        {
+            values >> scale.x >> scale.y >> scale.z;
+            spacingGiven = GL_TRUE;
+        }
+        else if(field == "ElementSize" && !spacingGiven)
+        {
+            values >> scale.x >> scale.y >> scale.z;
+        }
+        else if(field == "ElementType")
+        {
+            type = VoxelConverter::parseType(value);
+        }
+        else if(field == "ElementByteOrderMSB" || field == "BinaryDataByteOrderMSB")
+        {
+            bigEndian = (value == "True" || value == "true");
+        }
+        else if(field == "CompressedData")
+        {
+            compressed = (value == "True" || value == "true");
+        }
+        else if(field == "ElementNumberOfChannels")
+        {
+            values >> channels;
+        }
+        else if(field == "HeaderSize")
+        {
+            values >> headerSize;
+        }
+        else if(field == "ElementDataFile")
+        {
+            dataFile = value;
+        }
+    }
 
-    // Saving of xml
-    std::ofstream out(std::string(VOLUMECREATOR_PATH + pVolume->getName() + ".xml").c_str());
-    out << xml_as_string;
-    out.close();
+    if(type == VOXEL_UNKNOWN || dimension != 3 || channels != 1)
+    {
+        LogWarning("Cannot import anything else than three dimensional MetaImage with scalar type");
+        return NULL;
+    }
+    if(compressed)
+    {
+        LogWarning("Cannot import compressed MetaImage");
+        return NULL;
+    }
+    if(res.x < 4 || res.y < 4 || res.z < 4)
+    {
+        LogError("'" + path + "' resolution too low (under 4x4x4)!");
+        return NULL;
+    }
 
-    // Saving of raw data
-    glm::vec3 volumeResolution = pVolume->getVolumeResolution();
-    GLuint size = static_cast<GLuint>(volumeResolution.x * volumeResolution.y * volumeResolution.z);
-    FILE* pRawDataFile = UT::openFile(std::string(VOLUMECREATOR_PATH + pVolume->getName() + ".raw"));
-    fwrite(pVolume->pRawData, static_cast<size_t>(bitDepth/8)*sizeof(GLubyte), size, pRawDataFile);
-    fclose(pRawDataFile);
+    // Data is either attached after header or in separate file
+    std::string dataPath = path;
+    GLint64 offset = 0;
+    if(dataFile == "LOCAL")
+    {
+        offset = static_cast<GLint64>(in.tellg());
+    }
+    else if(dataFile.empty() || dataFile.find("LIST") == 0 || dataFile.find('%') != std::string::npos)
+    {
+        LogWarning("Cannot import MetaImage without data file or with data split into multiple files");
+        return NULL;
+    }
+    else
+    {
+        dataPath = resolveDataFile(path, dataFile);
+    }
+    in.close();
 
-    return GL_TRUE;
+    return prepareForeignData(name, dataPath, offset, headerSize, res, scale, type, bigEndian);
 }
 
-Volume* VolumeCreator::readFromFile(std::string name, GLint handle)
+VolumeData* VolumeCreator::prepareForeignData(std::string name, std::string path, GLint64 offset, GLint skip, glm::vec3 volumeResolution, glm::vec3 voxelScale, VoxelType type, GLboolean bigEndian)
 {
-    // First try to open raw data
-    std::string path = VOLUMECREATOR_PATH + name + ".raw";
-    std::ifstream rawDataFile(path.c_str(), std::ios::in|std::ios::binary);
+    GLdouble startTime = glfwGetTime();
 
-    // Check whether file exisits
-    if(!rawDataFile.is_open())
+    FileReader reader;
+    if(!reader.open(path))
     {
-        LogWarning("'" + VOLUMECREATOR_PATH + name + ".raw' was not found!");
+        LogWarning("'" + path + "' was not found!");
         return NULL;
     }
+    GLint64 fileSize = static_cast<GLint64>(reader.getSize());
 
-    // *** READ XML ***
+    size_t voxelCount = static_cast<size_t>(getVoxelCount(volumeResolution));
+    size_t payloadSize = voxelCount * VoxelConverter::getSize(type);
+    VolumeValueResolution valueResolution = VoxelConverter::getValueResolution(type);
+    size_t bytesPerVoxel = getBytesPerVoxel(valueResolution);
 
-    // Read XML from file
-    std::ifstream in(std::string(VOLUMECREATOR_PATH + name + ".xml").c_str());
+    // Skip of minus one means data is at end of file
+    offset = (skip < 0) ? fileSize - static_cast<GLint64>(payloadSize) : offset + skip;
+    if(offset < 0 || offset + static_cast<GLint64>(payloadSize) > fileSize)
+    {
+        LogError("'" + path + "' contains less voxels than expected!");
+        return NULL;
+    }
 
-    // Check whether file exisits
-    if(!in.is_open())
+    RawData* pRawData = new RawData();
+    if(!pRawData->allocate(voxelCount * bytesPerVoxel))
     {
-        LogWarning("'" + VOLUMECREATOR_PATH + name + ".xml' was not found!");
+        delete pRawData;
         return NULL;
+    }
 
+    // Read into target if types have same size, conversion works in place then
+    RawData payload;
+    GLubyte* pBuffer = pRawData->getWritableData();
+    if(VoxelConverter::getSize(type) != bytesPerVoxel)
+    {
+        if(!payload.allocate(payloadSize))
+        {
+            delete pRawData;
+            return NULL;
+        }
+        pBuffer = payload.getWritableData();
     }
 
-    // File exisits, lets hope the best
-    std::stringstream buffer;
-    buffer << in.rdbuf();
+    reportBytesTotal(payloadSize);
+    reader.seek(static_cast<GLuint64>(offset));
+    readChunked(&reader, pBuffer, payloadSize);
+    reader.close();
+    if(isCancelled())
+    {
+        delete pRawData;
+        return NULL;
+    }
+    reportProgress(0.5f);
+
+    GLdouble conversionStartTime = glfwGetTime();
+    VoxelConverter::convert(pBuffer, pRawData->getWritableData(), voxelCount, type, bigEndian);
+    GLdouble conversionDuration = glm::max(glfwGetTime() - conversionStartTime, 0.000001);
+
+    LogInfo("Conversion of " + UT::to_string(static_cast<GLdouble>(payloadSize) / 1048576.0) + " MB took "
+        + UT::to_string(conversionDuration) + " seconds (" + UT::to_string(static_cast<GLdouble>(payloadSize) / 1048576.0 / conversionDuration) + " MB/s)");
+    LogInfo("Reading and conversion took " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+
+    VolumeData* pData = new VolumeData();
+    pData->name = name;
+    pData->volumeResolution = volumeResolution;
+    pData->voxelScale = voxelScale;
+    pData->valueResolution = valueResolution;
+    pData->pRawData = pRawData;
+
+    // Signed normalized values are mapped from minus one to one onto transfer function
+    if(valueResolution == VOLUME_16BIT_SIGNED)
+    {
+        pData->properties.valueOffset = 0.5f;
+        pData->properties.valueScale = 0.5f;
+    }
+
+    return pData;
+}
+
+std::string VolumeCreator::findImportFile(std::string subdirectory, std::string name, std::string extension)
+{
+    std::string path = VOLUMECREATOR_PATH + subdirectory + name + extension;
+    std::ifstream in(path.c_str());
+
+    // Try it without extension
+    if(!in.is_open())
+    {
+        path = VOLUMECREATOR_PATH + subdirectory + name;
+    }
+    return path;
+}
+
+std::string VolumeCreator::resolveDataFile(std::string headerPath, std::string dataFile)
+{
+    // Relative paths start at directory of header
+    if(dataFile[0] == '/' || dataFile[0] == '\\' || dataFile.find(':') != std::string::npos)
+    {
+        return dataFile;
+    }
+    return headerPath.substr(0, headerPath.find_last_of("/\\") + 1) + dataFile;
+}
+
+std::string VolumeCreator::trimHeaderValue(std::string value)
+{
+    size_t first = value.find_first_not_of(" \t\r\n");
+    if(first == std::string::npos)
+    {
+        return "";
+    }
+    size_t last = value.find_last_not_of(" \t\r\n");
+    return value.substr(first, last - first + 1);
+}
+
+VolumeData* VolumeCreator::prepareGenerated(std::string specification)
+{
+    GLdouble startTime = glfwGetTime();
+
+    VolumeGeneratorSettings settings;
+    if(!VolumeGenerator::parseSpecification(specification, settings))
+    {
+        LogError("'" + specification + "' is no valid specification of generated volume!");
+        return NULL;
+    }
+
+    glm::vec3 volumeResolution(settings.resolution);
+    size_t bytesPerVoxel = getBytesPerVoxel(settings.valueResolution);
+    RawData* pRawData = new RawData();
+    if(!pRawData->allocate(static_cast<size_t>(getVoxelCount(volumeResolution)) * bytesPerVoxel))
+    {
+        delete pRawData;
+        return NULL;
+    }
+
+    VolumeGenerator::generate(settings, pRawData->getWritableData(), [this](GLfloat fraction) { reportProgress(fraction); });
+
+    GLdouble duration = glm::max(glfwGetTime() - startTime, 0.000001);
+    GLdouble megavoxels = static_cast<GLdouble>(getVoxelCount(volumeResolution)) / 1000000.0;
+    LogInfo("Generating " + VolumeGenerator::createName(settings) + " took " + UT::to_string(duration) + " seconds ("
+        + UT::to_string(megavoxels / duration) + " megavoxels/s)");
+
+    VolumeData* pData = new VolumeData();
+    pData->name = VolumeGenerator::createName(settings);
+    pData->volumeResolution = volumeResolution;
+    pData->voxelScale = glm::vec3(1, 1, 1);
+    pData->valueResolution = settings.valueResolution;
+    pData->pRawData = pRawData;
+
+    return pData;
+}
+
+VolumeData* VolumeCreator::prepareSliceStack(std::string name)
+{
+    GLdouble startTime = glfwGetTime();
+    std::string directory = VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PNG + name;
+
+    // Collect slices, numbers in names give order
+    std::vector<std::string> slices;
+    std::vector<std::string> names = UT::listDirectory(directory);
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        std::string extension = names[i].size() > 4 ? names[i].substr(names[i].size() - 4) : "";
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if(extension == ".png")
+        {
+            slices.push_back(directory + "/" + names[i]);
+        }
+    }
+    std::sort(slices.begin(), slices.end(), compareSliceNames);
+
+    if(slices.size() < 4)
+    {
+        LogWarning("'" + directory + "' was not found or contains less than four PNG slices!");
+        return NULL;
+    }
+
+    // First slice defines format of all others
+    PNGSliceFormat format;
+    if(!readPNGSliceFormat(slices[0], format))
+    {
+        return NULL;
+    }
+    if(format.width < 4 || format.height < 4)
+    {
+        LogError("'" + directory + "' resolution too low (under 4x4x4)!");
+        return NULL;
+    }
+
+    glm::vec3 volumeResolution(format.width, format.height, static_cast<GLfloat>(slices.size()));
+    VolumeValueResolution valueResolution = (format.bitDepth == 16) ? VOLUME_16BIT : VOLUME_8BIT;
+    size_t bytesPerVoxel = getBytesPerVoxel(valueResolution);
+    size_t sliceSize = static_cast<size_t>(format.width) * format.height * bytesPerVoxel;
+
+    RawData* pRawData = new RawData();
+    if(!pRawData->allocate(sliceSize * slices.size()))
+    {
+        delete pRawData;
+        return NULL;
+    }
+    GLubyte* pVoxels = pRawData->getWritableData();
+
+    // Workers take next slice until all are done, so slow slices do not stall others
+    std::atomic<size_t> nextSlice(0);
+    std::atomic<size_t> decodedSlices(0);
+    std::atomic<bool> failed(false);
+    GLdouble decodeStartTime = glfwGetTime();
+
+    UT::parallelFor(0, UT::getThreadCount(), [&](size_t, size_t)
+    {
+        // Buffers keep their capacity over slices of one worker
+        std::vector<GLubyte> file;
+        std::vector<unsigned char> decoded;
+
+        size_t slice;
+        while(!failed && !isCancelled() && (slice = nextSlice++) < slices.size())
+        {
+            if(!decodePNGSlice(slices[slice], format, file, decoded, pVoxels + slice * sliceSize))
+            {
+                failed = true;
+                break;
+            }
+            reportBytesRead(file.size());
+            reportProgress(static_cast<GLfloat>(++decodedSlices) / static_cast<GLfloat>(slices.size()));
+        }
+    });
+
+    if(failed || isCancelled())
+    {
+        delete pRawData;
+        return NULL;
+    }
+
+    GLdouble decodeDuration = glm::max(glfwGetTime() - decodeStartTime, 0.000001);
+    LogInfo("Decoding of " + UT::to_string(static_cast<GLuint>(slices.size())) + " slices took "
+        + UT::to_string(decodeDuration) + " seconds (" + UT::to_string(static_cast<GLdouble>(slices.size()) / decodeDuration) + " slices/s)");
+    LogInfo("Slice stack import took " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+
+    VolumeData* pData = new VolumeData();
+    pData->name = name;
+    pData->volumeResolution = volumeResolution;
+    pData->voxelScale = glm::vec3(1, 1, 1);
+    pData->valueResolution = valueResolution;
+    pData->pRawData = pRawData;
+
+    return pData;
+}
+
+GLboolean VolumeCreator::readPNGSliceFormat(std::string path, PNGSliceFormat& rFormat)
+{
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+    GLubyte header[VOLUMECREATOR_PNG_HEADER_SIZE];
+    if(!in.is_open() || !in.read(reinterpret_cast<char*>(header), VOLUMECREATOR_PNG_HEADER_SIZE))
+    {
+        LogError("'" + path + "' could not be read!");
+        return GL_FALSE;
+    }
+    return parsePNGSliceFormat(path, header, VOLUMECREATOR_PNG_HEADER_SIZE, rFormat);
+}
+
+GLboolean VolumeCreator::parsePNGSliceFormat(std::string path, const GLubyte* pFile, size_t size, PNGSliceFormat& rFormat)
+{
+    // Signature followed by IHDR chunk
+    if(size < VOLUMECREATOR_PNG_HEADER_SIZE || memcmp(pFile, VOLUMECREATOR_PNG_SIGNATURE, sizeof(VOLUMECREATOR_PNG_SIGNATURE)) != 0
+        || pFile[12] != 'I' || pFile[13] != 'H' || pFile[14] != 'D' || pFile[15] != 'R')
+    {
+        LogError("'" + path + "' is no PNG!");
+        return GL_FALSE;
+    }
+
+    rFormat.width = (pFile[16] << 24) | (pFile[17] << 16) | (pFile[18] << 8) | pFile[19];
+    rFormat.height = (pFile[20] << 24) | (pFile[21] << 16) | (pFile[22] << 8) | pFile[23];
+    rFormat.bitDepth = pFile[24];
+
+    // Only first channel of color types is used
+    switch(pFile[25])
+    {
+    case 0:
+        rFormat.channels = 1;
+        break;
+    case 2:
+        rFormat.channels = 3;
+        break;
+    case 4:
+        rFormat.channels = 2;
+        break;
+    case 6:
+        rFormat.channels = 4;
+        break;
+    default:
+        rFormat.channels = 0;
+        break;
+    }
+
+    if(rFormat.channels == 0 || (rFormat.bitDepth != 8 && rFormat.bitDepth != 16))
+    {
+        LogError("'" + path + "' has palette or less than 8 bit per channel, which is not supported!");
+        return GL_FALSE;
+    }
+    return GL_TRUE;
+}
+
+GLboolean VolumeCreator::decodePNGSlice(std::string path, const PNGSliceFormat& rFormat, std::vector<GLubyte>& rFile, std::vector<unsigned char>& rDecoded, GLubyte* pTarget)
+{
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+    in.seekg(0, std::ios::end);
+    std::streamoff fileSize = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    if(!in.is_open() || fileSize <= 0)
+    {
+        LogError("'" + path + "' could not be read!");
+        return GL_FALSE;
+    }
+    rFile.resize(static_cast<size_t>(fileSize));
+    in.read(reinterpret_cast<char*>(&rFile[0]), fileSize);
     in.close();
-    std::string content(buffer.str());
-    std::vector<GLchar> xml(content.begin(), content.end());
-    xml.push_back('\0');
 
-    // Parse it to a doc
-    rapidxml::xml_document<> doc;
-    doc.parse<rapidxml::parse_declaration_node | rapidxml::parse_no_data_nodes>(&xml[0]);
+    PNGSliceFormat format;
+    if(!parsePNGSliceFormat(path, &rFile[0], rFile.size(), format))
+    {
+        return GL_FALSE;
+    }
+    if(format.width != rFormat.width || format.height != rFormat.height
+        || format.bitDepth != rFormat.bitDepth || format.channels != rFormat.channels)
+    {
+        LogError("'" + path + "' differs in size or format from first slice!");
+        return GL_FALSE;
+    }
+
+    // Decoded scanlines keep format of file
+    unsigned long width, height;
+    if(decodePNG(rDecoded, width, height, &rFile[0], static_cast<int>(rFile.size()), false) != 0)
+    {
+        LogError("'" + path + "' could not be decoded!");
+        return GL_FALSE;
+    }
+
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    const unsigned char* pDecoded = &rDecoded[0];
+    if(rFormat.bitDepth == 8)
+    {
+        if(rFormat.channels == 1)
+        {
+            memcpy(pTarget, pDecoded, pixelCount);
+        }
+        else
+        {
+            for(size_t i = 0; i < pixelCount; i++)
+            {
+                pTarget[i] = pDecoded[i * rFormat.channels];
+            }
+        }
+    }
+    else
+    {
+        // PNG stores 16 bit big endian
+        GLushort* pShortTarget = reinterpret_cast<GLushort*>(pTarget);
+        size_t stride = 2 * rFormat.channels;
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            pShortTarget[i] = static_cast<GLushort>((pDecoded[i * stride] << 8) | pDecoded[i * stride + 1]);
+        }
+    }
+    return GL_TRUE;
+}
+
+bool VolumeCreator::compareSliceNames(const std::string& rA, const std::string& rB)
+{
+    // Runs of digits are compared by value
+    size_t i = 0;
+    size_t j = 0;
+    while(i < rA.size() && j < rB.size())
+    {
+        if(isdigit(rA[i]) && isdigit(rB[j]))
+        {
+            size_t endA = rA.find_first_not_of("0123456789", i);
+            size_t endB = rB.find_first_not_of("0123456789", j);
+            endA = (endA == std::string::npos) ? rA.size() : endA;
+            endB = (endB == std::string::npos) ? rB.size() : endB;
+
+            // Skip leading zeros, longer number is bigger
+            while(i + 1 < endA && rA[i] == '0') { i++; }
+            while(j + 1 < endB && rB[j] == '0') { j++; }
+            if(endA - i != endB - j)
+            {
+                return (endA - i) < (endB - j);
+            }
+            int comparison = rA.compare(i, endA - i, rB, j, endB - j);
+            if(comparison != 0)
+            {
+                return comparison < 0;
+            }
+            i = endA;
+            j = endB;
+        }
+        else
+        {
+            if(rA[i] != rB[j])
+            {
+                return rA[i] < rB[j];
+            }
+            i++;
+            j++;
+        }
+    }
+    return (rA.size() - i) < (rB.size() - j);
+}
+
+VolumeData* VolumeCreator::prepareVolume(VolumeSource source, std::string name)
+{
+    reportProgress(0);
+
+    VolumeData* pData = NULL;
+    switch(source)
+    {
+    case VOLUME_SOURCE_PVM:
+        pData = preparePVM(name);
+        break;
+    case VOLUME_SOURCE_DAT:
+        pData = prepareDAT(name);
+        break;
+    case VOLUME_SOURCE_NRRD:
+        pData = prepareNRRD(name);
+        break;
+    case VOLUME_SOURCE_MHD:
+        pData = prepareMHD(name);
+        break;
+    case VOLUME_SOURCE_PNG:
+        pData = prepareSliceStack(name);
+        break;
+    case VOLUME_SOURCE_GENERATOR:
+        pData = prepareGenerated(name);
+        break;
+    case VOLUME_SOURCE_FILE:
+        // Bricked file carries statistics, so it is faster to load
+        if(hasBrickedFile(name))
+        {
+            pData = prepareFromBrickedFile(name);
+            if(pData == NULL && !isCancelled())
+            {
+                LogWarning("Reading bricked file failed, trying XML");
+            }
+        }
+        if(pData == NULL && !isCancelled())
+        {
+            pData = prepareFromFile(name);
+        }
+        break;
+    }
+
+    // Partially read data is freed
+    if(isCancelled())
+    {
+        delete pData;
+        LogInfo("Preparation of " + name + " was cancelled");
+        return NULL;
+    }
+
+    // Readers which cannot skip voxels are cropped afterwards
+    glm::ivec3 regionOffset, regionSize;
+    if(pData != NULL && !pData->regionRead && findRegion(pData->volumeResolution, regionOffset, regionSize))
+    {
+        RawData* pRawData = cropRawData(pData->pRawData->getData(), 0, pData->volumeResolution, getBytesPerVoxel(pData->valueResolution), regionOffset, regionSize);
+        delete pData->pRawData;
+        pData->pRawData = pRawData;
+        if(pRawData == NULL)
+        {
+            delete pData;
+            pData = NULL;
+        }
+        else
+        {
+            pData->volumeResolution = glm::vec3(regionSize);
+            pData->regionOffset = glm::vec3(regionOffset);
+            pData->statistics = VolumeStatistics();
+        }
+    }
+
+    // Statistics in one pass if they were not accumulated while reading
+    if(pData != NULL && !pData->statistics.isComplete())
+    {
+        pData->statistics.init(pData->volumeResolution, pData->valueResolution);
+        pData->statistics.accumulate(pData->pRawData->getData(), 0, static_cast<GLuint>(pData->volumeResolution.z));
+    }
+
+    // Saved volumes were processed when imported
+    if(pData != NULL && source != VOLUME_SOURCE_FILE)
+    {
+        processImport(pData);
+    }
+
+    // Summed volume table for importance volumes of any resolution, bricked files leave it to first change of downscale
+    if(pData != NULL && !pData->bricked && !isCancelled())
+    {
+        GLdouble startTime = glfwGetTime();
+        pData->summedVolumeTable.build(pData->pRawData->getData(), pData->volumeResolution, pData->valueResolution);
+        LogInfo("Summed volume table with cells of " + UT::to_string(pData->summedVolumeTable.getCellSize()) + " voxels built in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+    }
+
+    // Texture is downsampled if it does not fit device or budget, full resolution stays on CPU
+    if(pData != NULL && !isCancelled())
+    {
+        size_t bytesPerVoxel = getBytesPerVoxel(pData->valueResolution);
+        glm::vec3 textureResolution = VolumeProcessor::findTextureResolution(pData->volumeResolution, bytesPerVoxel, maxTextureResolution, importOptions.textureByteBudget);
+        if(textureResolution != pData->volumeResolution)
+        {
+            GLdouble startTime = glfwGetTime();
+
+            RawData* pTextureData = new RawData();
+            if(!pTextureData->allocate(static_cast<size_t>(getVoxelCount(textureResolution)) * bytesPerVoxel))
+            {
+                delete pTextureData;
+                LogWarning("Downsampling of texture skipped, texture may not fit");
+            }
+            else
+            {
+                VolumeProcessor::resample(pData->pRawData->getData(), pData->volumeResolution, pTextureData->getWritableData(), textureResolution, pData->valueResolution);
+                pData->pTextureData = pTextureData;
+                pData->textureResolution = textureResolution;
+
+                // Filter of downsampling reaches beyond one voxel of bricks at full resolution, so raycaster skips bricks of texels
+                pData->textureStatistics.init(textureResolution, pData->valueResolution);
+                pData->textureStatistics.accumulate(pTextureData->getData(), 0, static_cast<GLuint>(textureResolution.z));
+
+                LogInfo("Texture downsampled from " + UT::to_string(pData->volumeResolution.x) + " x " + UT::to_string(pData->volumeResolution.y) + " x " + UT::to_string(pData->volumeResolution.z)
+                    + " to " + UT::to_string(textureResolution.x) + " x " + UT::to_string(textureResolution.y) + " x " + UT::to_string(textureResolution.z)
+                    + " with " + UT::to_string(static_cast<GLfloat>(VolumeProcessor::getTextureByteCount(textureResolution, bytesPerVoxel)) / (1024 * 1024)) + " MB in "
+                    + UT::to_string(glfwGetTime() - startTime) + " seconds");
+            }
+        }
+    }
+
+    // Mip levels for texture and level of detail, only values which are uploaded get them
+    if(pData != NULL && !isCancelled())
+    {
+        GLdouble startTime = glfwGetTime();
+        if(pData->pTextureData != NULL)
+        {
+            pData->pyramid.build(pData->pTextureData->getData(), pData->textureResolution, pData->valueResolution, importOptions.pyramidReduction);
+        }
+        else
+        {
+            pData->pyramid.build(pData->pRawData->getData(), pData->volumeResolution, pData->valueResolution, importOptions.pyramidReduction);
+        }
+        LogInfo("Mip pyramid with " + UT::to_string(pData->pyramid.getLevelCount()) + " levels of " + getVolumePyramidReductionName(importOptions.pyramidReduction) + " built in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+    }
+
+    // Gradient volume replaces six fetches per sample in raycaster by one, it has resolution of texture
+    if(pData != NULL && importOptions.precomputeGradients && !isCancelled())
+    {
+        GLdouble startTime = glfwGetTime();
+        pData->gradients16Bit = importOptions.gradients16Bit;
+        if(pData->pTextureData != NULL)
+        {
+            VolumeProcessor::computeGradients(pData->pTextureData->getData(), pData->textureResolution, pData->valueResolution, pData->gradients16Bit, pData->gradients);
+        }
+        else
+        {
+            VolumeProcessor::computeGradients(pData->pRawData->getData(), pData->volumeResolution, pData->valueResolution, pData->gradients16Bit, pData->gradients);
+        }
+        LogInfo("Gradients computed in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+    }
+
+    if(isCancelled())
+    {
+        delete pData;
+        LogInfo("Preparation of " + name + " was cancelled");
+        return NULL;
+    }
+
+    reportProgress(1);
+
+    return pData;
+}
+
+Volume* VolumeCreator::createVolume(VolumeData* pData, GLint handle)
+{
+    if(pData == NULL)
+    {
+        return NULL;
+    }
+
+    // Downsampled texture if volume did not fit
+    GLuint textureHandle;
+    if(pData->pTextureData != NULL)
+    {
+        textureHandle = createTexture(pData->pTextureData->getData(), pData->textureResolution, pData->valueResolution, pData->properties.useLinearFiltering, &(pData->pyramid));
+    }
+    else
+    {
+        textureHandle = createTexture(pData->pRawData->getData(), pData->volumeResolution, pData->valueResolution, pData->properties.useLinearFiltering, &(pData->pyramid));
+    }
+
+    // *** CREATE VOLUME ***
+    Volume* pVolume = new Volume();
+
+    // Initialize volume, raw data is owned by volume from now on
+    pVolume->init(handle, pData->name, textureHandle, pData->volumeResolution, pData->voxelScale, pData->valueResolution, pData->pRawData, &(pData->statistics), pData->summedVolumeTable, pData->pyramid);
+    pVolume->setProperties(pData->properties);
+    pVolume->regionOffset = pData->regionOffset;
+    if(pData->pTextureData != NULL)
+    {
+        pVolume->textureResolution = pData->textureResolution;
+        pVolume->createBrickExtremaVolume(pData->textureStatistics);
+    }
+    if(!pData->gradients.empty())
+    {
+        pVolume->createGradientVolume(pData->gradients, pData->gradients16Bit);
+    }
+    pData->pRawData = NULL;
+
+    delete pData;
+
+    return pVolume;
+}
+
+void VolumeCreator::setProgress(VolumeProgress* pProgress)
+{
+    this->pProgress = pProgress;
+}
+
+GLboolean VolumeCreator::writeToFile(Volume* pVolume, GLboolean overwriteExisting, GLboolean compressed)
+{
+    // Check whether there exists already a file with that name
+    if(!overwriteExisting)
+    {
+        // Read XML from file
+        std::ifstream in(std::string(VOLUMECREATOR_PATH + pVolume->getName() + ".xml").c_str());
+
+        // Check whether file exisits
+        if(in.is_open())
+        {
+            LogError("'" + VOLUMECREATOR_PATH + pVolume->getName() + ".xml' already exists!");
+            return GL_FALSE;
+        }
+    }
+
+    // Document object
+    rapidxml::xml_document<> doc;
+
+    // XML declaration
+    rapidxml::xml_node<>* pDeclNode = doc.allocate_node(rapidxml::node_declaration);
+    pDeclNode->append_attribute(doc.allocate_attribute("version", "1.0"));
+    pDeclNode->append_attribute(doc.allocate_attribute("encoding", "utf-8"));
+    doc.append_node(pDeclNode);
+
+    // Root node
+    rapidxml::xml_node<>* pRootNode = doc.allocate_node(rapidxml::node_element, "volume");
+    pRootNode->append_attribute(doc.allocate_attribute("version", "1.0"));
+    doc.append_node(pRootNode);
+
+    // Get properties
+    VolumeProperties properties = pVolume->getProperties();
+
+    // Mirror
+    appendBool(properties.mirrorX, "mirrorX", &doc, pRootNode);
+    appendBool(properties.mirrorY, "mirrorY", &doc, pRootNode);
+    appendBool(properties.mirrorZ, "mirrorZ", &doc, pRootNode);
+
+    // Filtering
+    appendBool(properties.useLinearFiltering, "useLinearFiltering", &doc, pRootNode);
+
+    // Volume resolution
+    appendVec3(pVolume->getVolumeResolution(), "volumeResolution", &doc, pRootNode);
+
+    // Voxel scale
+    appendVec3(pVolume->getVoxelScale(), "voxelScale", &doc, pRootNode);
+
+    // Value resolution
+    appendFloat(static_cast<GLfloat>(getValueResolutionBits(pVolume->getValueResolution())), "valueResolution", &doc, pRootNode);
+
+    // Voxel scale multiplier
+    appendVec3(properties.voxelScaleMultiplier, "voxelScaleMultiplier", &doc, pRootNode);
+
+    // Value offset
+    appendFloat(properties.valueOffset, "valueOffset", &doc, pRootNode);
+
+    // Value scale
+    appendFloat(properties.valueScale, "valueScale", &doc, pRootNode);
+
+    // Rotation
+    appendVec3(properties.eulerZXZRotation, "eulerZXZRotation", &doc, pRootNode);
+
+    // Compression of raw data
+    appendBool(compressed, "compressedRawData", &doc, pRootNode);
+
+    // Offset in volume it was read from
+    appendVec3(pVolume->getRegionOffset(), "regionOffset", &doc, pRootNode);
+
+    // Printing
+    std::string xml_as_string;
+    rapidxml::print(std::back_inserter(xml_as_string), doc);
+
+    // Saving of xml
+    std::ofstream out(std::string(VOLUMECREATOR_PATH + pVolume->getName() + ".xml").c_str());
+    out << xml_as_string;
+    out.close();
+
+    // Saving of raw data
+    std::string rawDataPath = VOLUMECREATOR_PATH + pVolume->getName() + ".raw";
+    std::string compressedRawDataPath = VOLUMECREATOR_PATH + pVolume->getName() + VOLUMECREATOR_COMPRESSED_EXTENSION;
+
+    if(compressed)
+    {
+        if(!writeCompressedRawData(pVolume, compressedRawDataPath))
+        {
+            return GL_FALSE;
+        }
+
+        // Uncompressed raw data is outdated
+        std::remove(rawDataPath.c_str());
+        return GL_TRUE;
+    }
+
+    // Compressed raw data is outdated
+    std::remove(compressedRawDataPath.c_str());
+
+    // Raw data mapped from that very file has not changed and must not be truncated
+    if(pVolume->pRawData->isMapped() && pVolume->pRawData->getMappedPath() == rawDataPath)
+    {
+        return GL_TRUE;
+    }
+
+    // Write to temporary file first, the existing one may be mapped by another volume
+    size_t size = static_cast<size_t>(getVoxelCount(pVolume->getVolumeResolution())) * getBytesPerVoxel(pVolume->getValueResolution());
+    std::string temporaryPath = rawDataPath + ".tmp";
+    FILE* pRawDataFile = UT::openFile(temporaryPath);
+    if(pRawDataFile == NULL)
+    {
+        LogError("'" + temporaryPath + "' could not be opened for writing!");
+        return GL_FALSE;
+    }
+    GLboolean written = writeChunked(pRawDataFile, pVolume->pRawData->getData(), size);
+    fclose(pRawDataFile);
+
+    if(!written)
+    {
+        LogError("'" + temporaryPath + "' could not be written!");
+        std::remove(temporaryPath.c_str());
+        return GL_FALSE;
+    }
+
+    // Replace old raw data
+    std::remove(rawDataPath.c_str());
+    if(std::rename(temporaryPath.c_str(), rawDataPath.c_str()) != 0)
+    {
+        LogError("'" + rawDataPath + "' could not be replaced!");
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean VolumeCreator::writeCompressedRawData(Volume* pVolume, std::string path)
+{
+    GLdouble startTime = glfwGetTime();
+
+    glm::vec3 volumeResolution = pVolume->getVolumeResolution();
+    size_t bytesPerVoxel = getBytesPerVoxel(pVolume->getValueResolution());
+    size_t rowSize = static_cast<size_t>(volumeResolution.x) * bytesPerVoxel;
+    size_t rawSize = static_cast<size_t>(getVoxelCount(volumeResolution)) * bytesPerVoxel;
+
+    // Blocks consist of complete rows, because prediction starts at each row
+    size_t blockSize = glm::max(VOLUMECREATOR_COMPRESSED_BLOCK_SIZE / rowSize, static_cast<size_t>(1)) * rowSize;
+    size_t blockCount = (rawSize + blockSize - 1) / blockSize;
+
+    VolumeCompressedHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, VOLUMECREATOR_COMPRESSED_MAGIC.c_str(), sizeof(header.magic));
+    header.version = VOLUMECREATOR_COMPRESSED_VERSION;
+    header.bytesPerVoxel = static_cast<GLuint>(bytesPerVoxel);
+    header.rawSize = rawSize;
+    header.rowSize = rowSize;
+    header.blockSize = blockSize;
+    header.blockCount = blockCount;
+
+    std::string temporaryPath = path + ".tmp";
+    FILE* pFile = UT::openFile(temporaryPath);
+    if(pFile == NULL)
+    {
+        LogError("'" + temporaryPath + "' could not be opened for writing!");
+        return GL_FALSE;
+    }
+
+    // Header is written again when index offset is known
+    GLboolean success = (fwrite(&header, sizeof(header), 1, pFile) == 1);
+
+    // Compress batches of blocks in parallel and write them in order
+    const GLubyte* pData = pVolume->pRawData->getData();
+    std::vector<GLuint64> offsets(1, sizeof(header));
+    size_t batchSize = UT::getThreadCount() * 4;
+    std::vector<std::vector<GLubyte> > compressedBlocks(batchSize);
+
+    for(size_t batch = 0; batch < blockCount && success; batch += batchSize)
+    {
+        size_t count = glm::min(batchSize, blockCount - batch);
+
+        UT::parallelFor(0, count, [&](size_t first, size_t last)
+        {
+            for(size_t i = first; i < last; i++)
+            {
+                size_t offset = (batch + i) * blockSize;
+                compressedBlocks[i].clear();
+                VolumeCodec::compress(pData + offset, glm::min(blockSize, rawSize - offset), rowSize, bytesPerVoxel, compressedBlocks[i]);
+            }
+        });
+
+        for(size_t i = 0; i < count && success; i++)
+        {
+            success = writeChunked(pFile, &compressedBlocks[i][0], compressedBlocks[i].size());
+            offsets.push_back(offsets.back() + compressedBlocks[i].size());
+        }
+    }
+
+    // Block index behind data allows random access
+    header.indexOffset = offsets.back();
+    success = success
+        && (fwrite(&offsets[0], sizeof(GLuint64), offsets.size(), pFile) == offsets.size())
+        && (fseek(pFile, 0, SEEK_SET) == 0)
+        && (fwrite(&header, sizeof(header), 1, pFile) == 1);
+    fclose(pFile);
+
+    if(!success)
+    {
+        LogError("'" + temporaryPath + "' could not be written!");
+        std::remove(temporaryPath.c_str());
+        return GL_FALSE;
+    }
+
+    // Replace old compressed raw data
+    std::remove(path.c_str());
+    if(std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        LogError("'" + path + "' could not be replaced!");
+        return GL_FALSE;
+    }
+
+    GLdouble duration = glfwGetTime() - startTime;
+    GLdouble megabytes = static_cast<GLdouble>(rawSize) / 1048576.0;
+    LogInfo("Compressing " + UT::to_string(megabytes) + " MB took " + UT::to_string(duration) + " seconds ("
+        + UT::to_string(megabytes / duration) + " MB/s, ratio " + UT::to_string(static_cast<GLdouble>(rawSize) / header.indexOffset) + ")");
+
+    return GL_TRUE;
+}
+
+RawData* VolumeCreator::readCompressedRawData(std::string path, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, size_t firstByte, size_t lastByte, size_t& rDecodedOffset)
+{
+    GLdouble startTime = glfwGetTime();
+
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+    if(!in.is_open())
+    {
+        LogWarning("'" + path + "' was not found!");
+        return NULL;
+    }
+
+    VolumeCompressedHeader header;
+    in.read(reinterpret_cast<GLchar*>(&header), sizeof(header));
+    in.close();
+
+    size_t bytesPerVoxel = getBytesPerVoxel(valueResolution);
+    size_t rawSize = static_cast<size_t>(getVoxelCount(volumeResolution)) * bytesPerVoxel;
+    if(memcmp(header.magic, VOLUMECREATOR_COMPRESSED_MAGIC.c_str(), sizeof(header.magic)) != 0
+        || header.version != VOLUMECREATOR_COMPRESSED_VERSION
+        || header.bytesPerVoxel != bytesPerVoxel
+        || header.rawSize != rawSize
+        || header.blockSize == 0
+        || header.blockCount != (rawSize + header.blockSize - 1) / header.blockSize)
+    {
+        LogError("'" + path + "' does not match volume!");
+        return NULL;
+    }
+
+    // Map compressed data and index
+    RawData file;
+    size_t fileSize = static_cast<size_t>(header.indexOffset + (header.blockCount + 1) * sizeof(GLuint64));
+    if(!file.map(path, 0, fileSize))
+    {
+        LogError("'" + path + "' is incomplete!");
+        return NULL;
+    }
+    file.advise(RAWDATA_ACCESS_SEQUENTIAL);
+    const GLuint64* pOffsets = reinterpret_cast<const GLuint64*>(file.getData() + header.indexOffset);
+
+    // Only blocks covering byte range are decompressed
+    size_t blockSize = static_cast<size_t>(header.blockSize);
+    size_t firstBlock = firstByte / blockSize;
+    size_t lastBlock = glm::min((lastByte + blockSize - 1) / blockSize, static_cast<size_t>(header.blockCount));
+    rDecodedOffset = firstBlock * blockSize;
+    size_t decodedSize = glm::min(lastBlock * blockSize, rawSize) - rDecodedOffset;
+
+    RawData* pRawData = new RawData();
+    if(!pRawData->allocate(decodedSize))
+    {
+        delete pRawData;
+        return NULL;
+    }
+
+    // Blocks are independent
+    GLubyte* pData = pRawData->getWritableData();
+    std::atomic<bool> consistent(true);
+    reportBytesTotal(pOffsets[lastBlock] - pOffsets[firstBlock]);
+    UT::parallelFor(firstBlock, lastBlock, [&](size_t first, size_t last)
+    {
+        for(size_t block = first; block < last && !isCancelled(); block++)
+        {
+            size_t offset = block * blockSize;
+            if(pOffsets[block] > pOffsets[block + 1] || pOffsets[block + 1] > header.indexOffset
+                || !VolumeCodec::decompress(
+                    file.getData() + pOffsets[block],
+                    static_cast<size_t>(pOffsets[block + 1] - pOffsets[block]),
+                    pData + offset - rDecodedOffset,
+                    glm::min(static_cast<size_t>(header.blockSize), rawSize - offset),
+                    static_cast<size_t>(header.rowSize),
+                    bytesPerVoxel))
+            {
+                consistent = false;
+            }
+            reportBytesRead(pOffsets[block + 1] - pOffsets[block]);
+        }
+    });
+
+    if(isCancelled())
+    {
+        delete pRawData;
+        return NULL;
+    }
+
+    if(!consistent)
+    {
+        LogError("'" + path + "' is corrupted!");
+        delete pRawData;
+        return NULL;
+    }
+
+    GLdouble duration = glfwGetTime() - startTime;
+    GLdouble megabytes = static_cast<GLdouble>(decodedSize) / 1048576.0;
+    LogInfo("Decompressing " + UT::to_string(megabytes) + " MB took " + UT::to_string(duration) + " seconds ("
+        + UT::to_string(megabytes / duration) + " MB/s, ratio " + UT::to_string(static_cast<GLdouble>(rawSize) / header.indexOffset) + ")");
+
+    return pRawData;
+}
+
+VolumeData* VolumeCreator::prepareFromFile(std::string name)
+{
+    GLdouble startTime = glfwGetTime();
+
+    // *** READ XML ***
+
+    // Read XML from file
+    std::ifstream in(std::string(VOLUMECREATOR_PATH + name + ".xml").c_str());
+
+    // Check whether file exisits
+    if(!in.is_open())
+    {
+        LogWarning("'" + VOLUMECREATOR_PATH + name + ".xml' was not found!");
+        return NULL;
+
+    }
+
+    // File exisits, lets hope the best
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    in.close();
+    std::string content(buffer.str());
+    std::vector<GLchar> xml(content.begin(), content.end());
+    xml.push_back('\0');
+
+    // Parse it to a doc
+    rapidxml::xml_document<> doc;
+    doc.parse<rapidxml::parse_declaration_node | rapidxml::parse_no_data_nodes>(&xml[0]);
+
+    // Volume (jump over declaration)
+    rapidxml::xml_node<>* pRootNode = doc.first_node()->next_sibling();
+    checkValue(std::string(pRootNode->name()), "volume", name);
+
+    // Get Version
+    rapidxml::xml_attribute<>* pRootNodeCurrentAttribute = pRootNode->first_attribute();
+    checkValue(std::string(pRootNodeCurrentAttribute->name()), "version", name);
+    GLfloat version = convertCharToFloat(pRootNodeCurrentAttribute->value());
+
+    // Pointer to nodes
+    rapidxml::xml_node<>* pChildNode = pRootNode->first_node();
+
+    // Create properties
+    VolumeProperties properties;
+
+    // Mirror
+    properties.useLinearFiltering = extractBool("mirrorX", name, pChildNode);
+
+    pChildNode = pChildNode->next_sibling();
+    properties.useLinearFiltering = extractBool("mirrorY", name, pChildNode);
+
+    pChildNode = pChildNode->next_sibling();
+    properties.useLinearFiltering = extractBool("mirrorZ", name, pChildNode);
+
+    // Filtering
+    pChildNode = pChildNode->next_sibling();
+    properties.useLinearFiltering = extractBool("useLinearFiltering", name, pChildNode);
+
+    // Volume resolution
+    pChildNode = pChildNode->next_sibling();
+    glm::vec3 volumeResolution = extractVec3("volumeResolution", name, pChildNode);
+
+    if(volumeResolution.x < 4 || volumeResolution.y < 4 || volumeResolution.z < 4)
+    {
+        LogError("'" +  VOLUMECREATOR_PATH + name + ".xml' resolution too low (under 4x4x4)!");
+        return NULL;
+    }
+
+    // Voxel scale
+    pChildNode = pChildNode->next_sibling();
+    glm::vec3 voxelScale = extractVec3("voxelScale", name, pChildNode);
+
+    // Value resolution
+    pChildNode = pChildNode->next_sibling();
+    VolumeValueResolution valueResolution;
+    if(!getValueResolutionFromBits(static_cast<GLint>(extractFloat("valueResolution", name, pChildNode)), valueResolution))
+    {
+        LogError("'" + name + "' has unsupported value resolution!");
+        return NULL;
+    }
+    size_t bytesPerVoxel = getBytesPerVoxel(valueResolution);
+
+    // Voxel scale
+    pChildNode = pChildNode->next_sibling();
+    properties.voxelScaleMultiplier = extractVec3("voxelScaleMultiplier", name, pChildNode);
+
+    // Value offset
+    pChildNode = pChildNode->next_sibling();
+    properties.valueOffset = extractFloat("valueOffset", name, pChildNode);
+
+    // Value scale
+    pChildNode = pChildNode->next_sibling();
+    properties.valueScale = extractFloat("valueScale", name, pChildNode);
+
+    // Rotation
+    pChildNode = pChildNode->next_sibling();
+    properties.eulerZXZRotation = extractVec3("eulerZXZRotation", name, pChildNode);
+
+    // Compression of raw data, older files do not have it
+    GLboolean compressed = GL_FALSE;
+    pChildNode = pChildNode->next_sibling();
+    if(pChildNode != NULL)
+    {
+        compressed = extractBool("compressedRawData", name, pChildNode);
+        pChildNode = pChildNode->next_sibling();
+    }
+
+    // Offset in volume it was read from, older files do not have it
+    glm::vec3 regionOffset(0, 0, 0);
+    if(pChildNode != NULL)
+    {
+        regionOffset = extractVec3("regionOffset", name, pChildNode);
+    }
+
+    // *** READ RAW DATA ***
+
+    VolumeData* pData = new VolumeData();
+    RawData* pRawData = NULL;
+    std::string path;
+
+    // Only rows of region are read
+    glm::ivec3 offset, size;
+    GLboolean useRegion = findRegion(volumeResolution, offset, size);
+    size_t firstByte = 0;
+    size_t lastByte = static_cast<size_t>(getVoxelCount(volumeResolution) * bytesPerVoxel);
+    if(useRegion)
+    {
+        getRegionByteRange(volumeResolution, bytesPerVoxel, offset, size, firstByte, lastByte);
+    }
+
+    if(compressed)
+    {
+        path = VOLUMECREATOR_PATH + name + VOLUMECREATOR_COMPRESSED_EXTENSION;
+        size_t decodedOffset;
+        pRawData = readCompressedRawData(path, volumeResolution, valueResolution, firstByte, lastByte, decodedOffset);
+        if(pRawData != NULL && useRegion)
+        {
+            RawData* pDecoded = pRawData;
+            pRawData = cropRawData(pDecoded->getData(), decodedOffset, volumeResolution, bytesPerVoxel, offset, size);
+            delete pDecoded;
+        }
+        if(pRawData == NULL)
+        {
+            delete pData;
+            return NULL;
+        }
+        pData->pRawData = pRawData;
+    }
+    else if(useRegion)
+    {
+        path = VOLUMECREATOR_PATH + name + ".raw";
+        pRawData = readRegion(path, 0, volumeResolution, bytesPerVoxel, offset, size);
+        if(pRawData == NULL)
+        {
+            delete pData;
+            return NULL;
+        }
+        pData->pRawData = pRawData;
+    }
+    else
+    {
+        path = VOLUMECREATOR_PATH + name + ".raw";
+        FileReader reader;
+
+        // Check whether file exisits
+        if(!reader.open(path))
+        {
+            LogWarning("'" + path + "' was not found!");
+            delete pData;
+            return NULL;
+        }
+
+        size_t rawDataSize = static_cast<size_t>(getVoxelCount(volumeResolution) * bytesPerVoxel) * sizeof(GLubyte);
+        pRawData = new RawData();
+        pData->pRawData = pRawData;
+
+        // Map raw data without copying, texture creation and preprocessing read it front to back
+        if(pRawData->map(path, 0, rawDataSize))
+        {
+            pRawData->advise(RAWDATA_ACCESS_SEQUENTIAL);
+        }
+        else
+        {
+            LogWarning("'" + path + "' could not be mapped, reading it instead");
+
+            if(!pRawData->allocate(rawDataSize))
+            {
+                delete pData;
+                return NULL;
+            }
+
+            // Read data and accumulate statistics on the fly
+            if(!streamRawData(&reader, pRawData->getWritableData(), volumeResolution, valueResolution, &(pData->statistics)))
+            {
+                if(!isCancelled())
+                {
+                    LogError("'" + path + "' ended before all voxels were read!");
+                }
+                delete pData;
+                return NULL;
+            }
+        }
+        reader.close();
+    }
+
+    if(useRegion)
+    {
+        volumeResolution = glm::vec3(size);
+        regionOffset += glm::vec3(offset);
+    }
+
+    pData->name = name;
+    pData->volumeResolution = volumeResolution;
+    pData->voxelScale = voxelScale;
+    pData->valueResolution = valueResolution;
+    pData->properties = properties;
+    pData->regionOffset = regionOffset;
+    pData->regionRead = GL_TRUE;
+
+    // Report for comparison of loading paths
+    LogInfo("Loading took " + UT::to_string(glfwGetTime() - startTime) + " seconds" + (compressed ? " (compressed)" : (pRawData->isMapped() ? " (mapped)" : " (read)")) + (useRegion ? " for region" : ""));
+    LogInfo("Peak memory usage: " + UT::to_string(UT::getPeakMemoryUsage()) + " MB");
+
+    return pData;
+}
+
+GLboolean VolumeCreator::writeToBrickedFile(Volume* pVolume, GLboolean overwriteExisting)
+{
+    GLdouble startTime = glfwGetTime();
+    std::string path = VOLUMECREATOR_PATH + pVolume->getName() + VOLUMECREATOR_BRICKED_EXTENSION;
+
+    // Check whether there exists already a file with that name
+    if(!overwriteExisting && hasBrickedFile(pVolume->getName()))
+    {
+        LogError("'" + path + "' already exists!");
+        return GL_FALSE;
+    }
+
+    const VolumeStatistics& statistics = pVolume->getStatistics();
+    VolumeProperties properties = pVolume->getProperties();
+    glm::ivec3 volumeResolution = glm::ivec3(pVolume->getVolumeResolution());
+    glm::vec3 voxelScale = pVolume->getVoxelScale();
+    glm::ivec3 brickCount = (volumeResolution + VOLUMECREATOR_BRICKED_BRICK_SIZE - 1) / VOLUMECREATOR_BRICKED_BRICK_SIZE;
+    glm::ivec3 importanceVolumeResolution = statistics.getImportanceVolumeResolution();
+    size_t bytesPerVoxel = getBytesPerVoxel(pVolume->getValueResolution());
+
+    // Fill header
+    VolumeBrickedHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, VOLUMECREATOR_BRICKED_MAGIC.c_str(), sizeof(header.magic));
+    header.version = VOLUMECREATOR_BRICKED_VERSION;
+    header.bytesPerVoxel = static_cast<GLuint>(bytesPerVoxel);
+    header.valueResolutionBits = getValueResolutionBits(pVolume->getValueResolution());
+    header.brickSize = VOLUMECREATOR_BRICKED_BRICK_SIZE;
+    header.histogramBinCount = static_cast<GLuint>(statistics.getFullHistogram().size());
+    header.valueOffset = properties.valueOffset;
+    header.valueScale = properties.valueScale;
+    header.mirror[0] = properties.mirrorX;
+    header.mirror[1] = properties.mirrorY;
+    header.mirror[2] = properties.mirrorZ;
+    header.useLinearFiltering = properties.useLinearFiltering;
+    for(GLint i = 0; i < 3; i++)
+    {
+        header.volumeResolution[i] = volumeResolution[i];
+        header.voxelScale[i] = voxelScale[i];
+        header.brickCount[i] = brickCount[i];
+        header.regionOffset[i] = static_cast<GLuint>(pVolume->getRegionOffset()[i]);
+        header.importanceVolumeResolution[i] = importanceVolumeResolution[i];
+        header.voxelScaleMultiplier[i] = properties.voxelScaleMultiplier[i];
+        header.eulerZXZRotation[i] = properties.eulerZXZRotation[i];
+    }
+
+    // Bricks start aligned after statistics, so they can be mapped directly
+    size_t statisticsSize =
+        statistics.getFullHistogram().size() * sizeof(GLuint64)
+        + statistics.getVariances().size() * sizeof(GLfloat)
+        + statistics.getBrickMinima().size() * sizeof(GLfloat)
+        + statistics.getBrickMaxima().size() * sizeof(GLfloat);
+    size_t dataOffset = sizeof(header) + statisticsSize;
+    dataOffset = ((dataOffset + VOLUMECREATOR_BRICKED_DATA_ALIGNMENT - 1) / VOLUMECREATOR_BRICKED_DATA_ALIGNMENT) * VOLUMECREATOR_BRICKED_DATA_ALIGNMENT;
+    header.dataOffset = dataOffset;
+
+    // Write to temporary file first, the existing one may be read by another volume
+    std::string temporaryPath = path + ".tmp";
+    FILE* pFile = UT::openFile(temporaryPath);
+    if(pFile == NULL)
+    {
+        LogError("'" + temporaryPath + "' could not be opened for writing!");
+        return GL_FALSE;
+    }
+
+    // Every write is checked, so a full disk does not leave a broken file which replaces a good one
+    GLboolean success =
+        fwrite(&header, sizeof(header), 1, pFile) == 1
+        && writeChunked(pFile, reinterpret_cast<const GLubyte*>(&(statistics.getFullHistogram()[0])), statistics.getFullHistogram().size() * sizeof(GLuint64))
+        && writeChunked(pFile, reinterpret_cast<const GLubyte*>(&(statistics.getVariances()[0])), statistics.getVariances().size() * sizeof(GLfloat))
+        && writeChunked(pFile, reinterpret_cast<const GLubyte*>(&(statistics.getBrickMinima()[0])), statistics.getBrickMinima().size() * sizeof(GLfloat))
+        && writeChunked(pFile, reinterpret_cast<const GLubyte*>(&(statistics.getBrickMaxima()[0])), statistics.getBrickMaxima().size() * sizeof(GLfloat));
+
+    std::vector<GLubyte> padding(dataOffset - sizeof(header) - statisticsSize, 0);
+    if(success && !padding.empty())
+    {
+        success = writeChunked(pFile, &padding[0], padding.size());
+    }
+
+    // Gather one layer of bricks at once, bricks at the border are filled with zeros
+    const GLubyte* pData = pVolume->pRawData->getData();
+    size_t brickRowSize = VOLUMECREATOR_BRICKED_BRICK_SIZE * bytesPerVoxel;
+    size_t brickSize = VOLUMECREATOR_BRICKED_BRICK_SIZE * brickRowSize * VOLUMECREATOR_BRICKED_BRICK_SIZE;
+    size_t rowSize = volumeResolution.x * bytesPerVoxel;
+    size_t sliceSize = rowSize * volumeResolution.y;
+    size_t bricksPerLayer = brickCount.x * brickCount.y;
+    std::vector<GLubyte> layer(bricksPerLayer * brickSize);
+
+    for(GLint brickZ = 0; brickZ < brickCount.z && success; brickZ++)
+    {
+        UT::parallelFor(0, bricksPerLayer, [&](size_t first, size_t last)
+        {
+            for(size_t brick = first; brick < last; brick++)
+            {
+                GLint brickX = static_cast<GLint>(brick % brickCount.x);
+                GLint brickY = static_cast<GLint>(brick / brickCount.x);
+                GLint width = glm::min(VOLUMECREATOR_BRICKED_BRICK_SIZE, volumeResolution.x - brickX * VOLUMECREATOR_BRICKED_BRICK_SIZE);
+                GLint height = glm::min(VOLUMECREATOR_BRICKED_BRICK_SIZE, volumeResolution.y - brickY * VOLUMECREATOR_BRICKED_BRICK_SIZE);
+                GLint depth = glm::min(VOLUMECREATOR_BRICKED_BRICK_SIZE, volumeResolution.z - brickZ * VOLUMECREATOR_BRICKED_BRICK_SIZE);
+
+                GLubyte* pBrick = &layer[brick * brickSize];
+                memset(pBrick, 0, brickSize);
+
+                for(GLint z = 0; z < depth; z++)
+                {
+                    for(GLint y = 0; y < height; y++)
+                    {
+                        const GLubyte* pSource = pData
+                            + (brickZ * VOLUMECREATOR_BRICKED_BRICK_SIZE + z) * sliceSize
+                            + (brickY * VOLUMECREATOR_BRICKED_BRICK_SIZE + y) * rowSize
+                            + brickX * brickRowSize;
+                        memcpy(pBrick + (z * VOLUMECREATOR_BRICKED_BRICK_SIZE + y) * brickRowSize, pSource, width * bytesPerVoxel);
+                    }
+                }
+            }
+        });
+
+        success = writeChunked(pFile, &layer[0], layer.size());
+    }
+
+    // Buffered bytes are only written when closing
+    if(fclose(pFile) != 0)
+    {
+        success = GL_FALSE;
+    }
+
+    if(!success)
+    {
+        LogError("'" + temporaryPath + "' could not be written!");
+        std::remove(temporaryPath.c_str());
+        return GL_FALSE;
+    }
+
+    // Replace old file
+    std::remove(path.c_str());
+    if(std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        LogError("'" + path + "' could not be replaced!");
+        std::remove(temporaryPath.c_str());
+        return GL_FALSE;
+    }
+
+    LogInfo("Saving bricked took " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+
+    return GL_TRUE;
+}
+
+GLboolean VolumeCreator::hasBrickedFile(std::string name)
+{
+    std::ifstream in(std::string(VOLUMECREATOR_PATH + name + VOLUMECREATOR_BRICKED_EXTENSION).c_str(), std::ios::in|std::ios::binary);
+
+    // Check magic only, header is validated when reading
+    GLchar magic[8];
+    in.read(magic, sizeof(magic));
+    return in.good() && (memcmp(magic, VOLUMECREATOR_BRICKED_MAGIC.c_str(), sizeof(magic)) == 0);
+}
+
+VolumeData* VolumeCreator::prepareFromBrickedFile(std::string name)
+{
+    GLdouble startTime = glfwGetTime();
+    std::string path = VOLUMECREATOR_PATH + name + VOLUMECREATOR_BRICKED_EXTENSION;
+
+    VolumeBrickedHeader header;
+    if(!readBrickedHeader(path, header))
+    {
+        return NULL;
+    }
+
+    glm::ivec3 volumeResolution(header.volumeResolution[0], header.volumeResolution[1], header.volumeResolution[2]);
+    glm::ivec3 brickCount(header.brickCount[0], header.brickCount[1], header.brickCount[2]);
+    VolumeValueResolution valueResolution = getBrickedValueResolution(header);
+    size_t bytesPerVoxel = header.bytesPerVoxel;
+    size_t brickRowSize = header.brickSize * bytesPerVoxel;
+    size_t brickSize = header.brickSize * brickRowSize * header.brickSize;
+    size_t brickTotal = static_cast<size_t>(brickCount.x) * brickCount.y * brickCount.z;
+    size_t importanceVolumeSize = static_cast<size_t>(header.importanceVolumeResolution[0]) * header.importanceVolumeResolution[1] * header.importanceVolumeResolution[2];
+    glm::ivec3 extremaCount = VolumeStatistics::computeBrickCount(glm::vec3(volumeResolution));
+    size_t extremaTotal = static_cast<size_t>(extremaCount.x) * extremaCount.y * extremaCount.z;
+
+    // Map complete file, bricks are only touched once
+    RawData file;
+    if(!file.map(path, 0, static_cast<size_t>(header.dataOffset) + brickTotal * brickSize))
+    {
+        LogError("'" + path + "' is incomplete!");
+        return NULL;
+    }
+    file.advise(RAWDATA_ACCESS_SEQUENTIAL);
+
+    // Restore statistics instead of accumulating them again
+    const GLuint64* pHistogram = reinterpret_cast<const GLuint64*>(file.getData() + sizeof(VolumeBrickedHeader));
+    const GLfloat* pVariances = reinterpret_cast<const GLfloat*>(pHistogram + header.histogramBinCount);
+    const GLfloat* pBrickMinima = pVariances + importanceVolumeSize;
+    const GLfloat* pBrickMaxima = pBrickMinima + extremaTotal;
+
+    // Statistics of region have to be accumulated again
+    glm::ivec3 regionOffset(0, 0, 0);
+    glm::ivec3 regionSize = volumeResolution;
+    GLboolean useRegion = findRegion(glm::vec3(volumeResolution), regionOffset, regionSize);
+
+    VolumeData* pData = new VolumeData();
+    if(!useRegion)
+    {
+        pData->statistics.restore(
+            glm::vec3(volumeResolution),
+            valueResolution,
+            std::vector<GLuint64>(pHistogram, pHistogram + header.histogramBinCount),
+            std::vector<GLfloat>(pVariances, pVariances + importanceVolumeSize),
+            std::vector<GLfloat>(pBrickMinima, pBrickMinima + extremaTotal),
+            std::vector<GLfloat>(pBrickMaxima, pBrickMaxima + extremaTotal));
+    }
+
+    // Unbrick into linear memory, every brick writes its own voxels
+    RawData* pRawData = new RawData();
+    pData->pRawData = pRawData;
+    size_t rowSize = regionSize.x * bytesPerVoxel;
+    size_t sliceSize = rowSize * regionSize.y;
+    if(!pRawData->allocate(sliceSize * regionSize.z))
+    {
+        delete pData;
+        return NULL;
+    }
+
+    const GLubyte* pBricks = file.getData() + header.dataOffset;
+    GLubyte* pVoxels = pRawData->getWritableData();
+    GLint edge = static_cast<GLint>(header.brickSize);
+
+    // Bricks outside of region are never touched
+    glm::ivec3 firstBrick = regionOffset / edge;
+    glm::ivec3 lastBrick = (regionOffset + regionSize + edge - 1) / edge;
+    glm::ivec3 usedBrickCount = lastBrick - firstBrick;
+    reportBytesTotal(static_cast<GLuint64>(usedBrickCount.x) * usedBrickCount.y * usedBrickCount.z * brickSize);
+
+    UT::parallelFor(0, static_cast<size_t>(usedBrickCount.x) * usedBrickCount.y * usedBrickCount.z, [&](size_t first, size_t last)
+    {
+        for(size_t usedBrick = first; usedBrick < last && !isCancelled(); usedBrick++)
+        {
+            glm::ivec3 brick(
+                firstBrick.x + static_cast<GLint>(usedBrick % usedBrickCount.x),
+                firstBrick.y + static_cast<GLint>((usedBrick / usedBrickCount.x) % usedBrickCount.y),
+                firstBrick.z + static_cast<GLint>(usedBrick / (static_cast<size_t>(usedBrickCount.x) * usedBrickCount.y)));
+
+            // Part of brick inside of region, in voxels of volume
+            glm::ivec3 begin = glm::max(brick * edge, regionOffset);
+            glm::ivec3 end = glm::min(glm::min(brick * edge + edge, volumeResolution), regionOffset + regionSize);
+
+            const GLubyte* pBrick = pBricks + ((static_cast<size_t>(brick.z) * brickCount.y + brick.y) * brickCount.x + brick.x) * brickSize;
+
+            for(GLint z = begin.z; z < end.z; z++)
+            {
+                for(GLint y = begin.y; y < end.y; y++)
+                {
+                    GLubyte* pDestination = pVoxels
+                        + (z - regionOffset.z) * sliceSize
+                        + (y - regionOffset.y) * rowSize
+                        + (begin.x - regionOffset.x) * bytesPerVoxel;
+                    const GLubyte* pSource = pBrick
+                        + ((z - brick.z * edge) * edge + (y - brick.y * edge)) * brickRowSize
+                        + (begin.x - brick.x * edge) * bytesPerVoxel;
+                    memcpy(pDestination, pSource, (end.x - begin.x) * bytesPerVoxel);
+                }
+            }
+            reportBytesRead(brickSize);
+        }
+    });
+
+    if(isCancelled())
+    {
+        delete pData;
+        return NULL;
+    }
+
+    // Properties
+    VolumeProperties& properties = pData->properties;
+    properties.mirrorX = header.mirror[0] != 0;
+    properties.mirrorY = header.mirror[1] != 0;
+    properties.mirrorZ = header.mirror[2] != 0;
+    properties.useLinearFiltering = header.useLinearFiltering != 0;
+    properties.voxelScaleMultiplier = glm::vec3(header.voxelScaleMultiplier[0], header.voxelScaleMultiplier[1], header.voxelScaleMultiplier[2]);
+    properties.valueOffset = header.valueOffset;
+    properties.valueScale = header.valueScale;
+    properties.eulerZXZRotation = glm::vec3(header.eulerZXZRotation[0], header.eulerZXZRotation[1], header.eulerZXZRotation[2]);
+
+    pData->name = name;
+    pData->volumeResolution = glm::vec3(regionSize);
+    pData->voxelScale = glm::vec3(header.voxelScale[0], header.voxelScale[1], header.voxelScale[2]);
+    pData->valueResolution = valueResolution;
+    pData->regionOffset = glm::vec3(header.regionOffset[0], header.regionOffset[1], header.regionOffset[2]) + glm::vec3(regionOffset);
+    pData->regionRead = GL_TRUE;
+    pData->bricked = GL_TRUE;
+
+    LogInfo("Loading took " + UT::to_string(glfwGetTime() - startTime) + " seconds (bricked" + (useRegion ? ", region)" : ")"));
+    LogInfo("Mip pyramid is still built for texture and joint histogram in background, summed volume table on first change of downscale");
+    LogInfo("Peak memory usage: " + UT::to_string(UT::getPeakMemoryUsage()) + " MB");
+
+    return pData;
+}
+
+VolumeData* VolumeCreator::prepareCompressedPVM(FileReader* pReader, std::string name)
+{
+    GLdouble startTime = glfwGetTime();
+
+    // Read complete compressed file, it is much smaller than the volume
+    size_t fileSize = static_cast<size_t>(pReader->getSize());
+    std::vector<GLubyte> compressed(fileSize);
+    reportBytesTotal(fileSize);
+    pReader->seek(0);
+    readChunked(pReader, &compressed[0], fileSize);
+    pReader->close();
+    if(isCancelled())
+    {
+        return NULL;
+    }
+
+    // Version decides about interleaving
+    size_t idLength = VOLUMECREATOR_DDS_ID_V3D.length();
+    std::string id(compressed.begin(), compressed.begin() + glm::min(idLength, fileSize));
+    size_t interleaveBlockSize;
+    if(id == VOLUMECREATOR_DDS_ID_V3D)
+    {
+        interleaveBlockSize = 0;
+    }
+    else if(id == VOLUMECREATOR_DDS_ID_V3E)
+    {
+        interleaveBlockSize = VOLUMECREATOR_DDS_INTERLEAVE;
+    }
+    else
+    {
+        LogWarning("Cannot import anything else than DDS v3d or v3e compressed PVM");
+        return NULL;
+    }
+
+    // Decode
+    size_t decodedSize;
+    GLubyte* pDecoded = decodeDDS(&compressed[idLength], fileSize - idLength, interleaveBlockSize, decodedSize);
+    std::vector<GLubyte>().swap(compressed);
+
+    if(pDecoded == NULL)
+    {
+        if(isCancelled())
+        {
+            return NULL;
+        }
+        LogError("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' could not be decompressed!");
+        return NULL;
+    }
+
+    LogInfo("Decompression of " + UT::to_string(static_cast<GLdouble>(fileSize) / 1048576.0) + " MB to "
+        + UT::to_string(static_cast<GLdouble>(decodedSize) / 1048576.0) + " MB took " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+
+    // Decoded data is a PVM file itself
+    glm::vec3 res;
+    glm::vec3 scale;
+    GLint bitDepth;
+    size_t headerSize;
+    if(!parsePVMHeader(pDecoded, decodedSize, res, scale, bitDepth, headerSize))
+    {
+        LogWarning("Cannot import anything else than PVM, PVM2 or PVM3 with one or two bytes per voxel");
+        free(pDecoded);
+        return NULL;
+    }
+
+    if(res.x < 4 || res.y < 4 || res.z < 4)
+    {
+        LogError("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' resolution too low (under 4x4x4)!");
+        free(pDecoded);
+        return NULL;
+    }
+
+    size_t rawDataSize = static_cast<size_t>(getVoxelCount(res)) * bitDepth;
+    if(headerSize + rawDataSize > decodedSize)
+    {
+        LogError("'" +  VOLUMECREATOR_PATH + VOLUMECREATOR_SUBDIR_PVM + name + ".pvm' contains less voxels than expected!");
+        free(pDecoded);
+        return NULL;
+    }
+
+    // Use decoded memory directly as raw data
+    RawData* pRawData = new RawData();
+    pRawData->adopt(pDecoded, headerSize, rawDataSize);
+
+    VolumeValueResolution valueResolution = (bitDepth == 1) ? VOLUME_8BIT : VOLUME_16BIT;
+
+    VolumeData* pData = new VolumeData();
+    pData->name = name;
+    pData->volumeResolution = res;
+    pData->voxelScale = scale;
+    pData->valueResolution = valueResolution;
+    pData->pRawData = pRawData;
+
+    return pData;
+}
+
+GLubyte* VolumeCreator::decodeDDS(const GLubyte* pCompressed, size_t compressedSize, size_t interleaveBlockSize, size_t& decodedSize)
+{
+    // Stream consists of big-endian words, incomplete last word is ignored
+    compressedSize -= compressedSize % 4;
+
+    // Bits are read most significant first
+    size_t position = 0;
+    GLuint64 bitBuffer = 0;
+    GLuint bitCount = 0;
+    auto readBits = [&](GLuint bits) -> GLint
+    {
+        while(bitCount < bits)
+        {
+            GLuint64 byte = (position < compressedSize) ? pCompressed[position] : 0;
+            bitBuffer = (bitBuffer << 8) | byte;
+            bitCount += 8;
+            position++;
+        }
+        bitCount -= bits;
+        return static_cast<GLint>((bitBuffer >> bitCount) & ((static_cast<GLuint64>(1) << bits) - 1));
+    };
+
+    GLuint skip = static_cast<GLuint>(readBits(2)) + 1;
+    size_t strip = static_cast<size_t>(readBits(16)) + 1;
+
+    // Decoded size is unknown, so grow memory when necessary
+    size_t capacity = glm::max(static_cast<size_t>(4) * compressedSize, static_cast<size_t>(1 << 20));
+    GLubyte* pData = (GLubyte*)malloc(capacity);
+    if(pData == NULL)
+    {
+        return NULL;
+    }
+
+    size_t count = 0;
+    GLint value = 0;
+    GLuint runLength;
+
+    // Runs of differences which share the same count of bits
+    size_t reportedPosition = 0;
+    while((runLength = static_cast<GLuint>(readBits(VOLUMECREATOR_DDS_RUN_LENGTH_BITS))) != 0)
+    {
+        // Decoding is the bigger part of importing compressed volumes
+        if(position - reportedPosition > VOLUMECREATOR_STREAMING_SLAB_SIZE / 16)
+        {
+            reportedPosition = position;
+            reportProgress(0.9f * static_cast<GLfloat>(position) / compressedSize);
+            if(isCancelled())
+            {
+                free(pData);
+                return NULL;
+            }
+        }
+
+        GLint code = readBits(3);
+        GLuint bits = (code >= 1) ? code + 1 : code;
+        GLint bias = (1 << bits) / 2;
+
+        if(count + runLength > capacity)
+        {
+            capacity *= 2;
+            GLubyte* pGrown = (GLubyte*)realloc(pData, capacity);
+            if(pGrown == NULL)
+            {
+                free(pData);
+                return NULL;
+            }
+            pData = pGrown;
+        }
+
+        for(GLuint i = 0; i < runLength; i++)
+        {
+            // Predict from value one strip before, if there is one
+            if(strip == 1 || count <= strip)
+            {
+                value += readBits(bits) - bias;
+            }
+            else
+            {
+                value += static_cast<GLint>(pData[count - strip]) - static_cast<GLint>(pData[count - strip - 1]) + readBits(bits) - bias;
+            }
+
+            value &= 255;
+            pData[count++] = static_cast<GLubyte>(value);
+        }
+    }
+
+    if(count == 0)
+    {
+        free(pData);
+        return NULL;
+    }
+
+    deinterleaveDDS(pData, count, skip, interleaveBlockSize);
+
+    decodedSize = count;
+    return pData;
+}
+
+void VolumeCreator::deinterleaveDDS(GLubyte* pData, size_t size, GLuint skip, size_t blockSize)
+{
+    if(skip <= 1)
+    {
+        return;
+    }
+
+    // Encoder interleaves chunks of skip times block size, last chunk may be shorter
+    size_t chunkSize = (blockSize == 0) ? size : blockSize * skip;
+
+    // Chunks are independent, each one is restored by all threads
+    std::vector<GLubyte> restored(glm::min(chunkSize, size));
+    for(size_t blockStart = 0; blockStart < size; blockStart += chunkSize)
+    {
+        GLubyte* pBlock = pData + blockStart;
+        size_t blockBytes = glm::min(chunkSize, size - blockStart);
+
+        // Encoder stored every skip-th byte consecutively, find start of each group
+        std::vector<size_t> groupStarts(skip, 0);
+        for(GLuint i = 1; i < skip; i++)
+        {
+            size_t previousGroupSize = (blockBytes > i - 1) ? (blockBytes - (i - 1) + skip - 1) / skip : 0;
+            groupStarts[i] = groupStarts[i - 1] + previousGroupSize;
+        }
+
+        UT::parallelFor(0, blockBytes, [&](size_t begin, size_t end)
+        {
+            for(size_t j = begin; j < end; j++)
+            {
+                restored[j] = pBlock[groupStarts[j % skip] + j / skip];
+            }
+        });
+
+        memcpy(pBlock, &restored[0], blockBytes);
+    }
+}
+
+GLboolean VolumeCreator::parsePVMHeader(const GLubyte* pData, size_t size, glm::vec3& resolution, glm::vec3& scale, GLint& bitDepth, size_t& headerSize)
+{
+    size_t position = 0;
+    std::string line;
+
+    // Header consists of short lines
+    auto nextLine = [&]() -> GLboolean
+    {
+        line.clear();
+        while(position < size && pData[position] != '\n' && line.length() < 256)
+        {
+            line += static_cast<GLchar>(pData[position++]);
+        }
+        if(position >= size || pData[position] != '\n')
+        {
+            return GL_FALSE;
+        }
+        position++;
+        return GL_TRUE;
+    };
+
+    // Format
+    if(!nextLine())
+    {
+        return GL_FALSE;
+    }
+    GLint version = 0;
+    if(line == "PVM")
+    {
+        version = 1;
+    }
+    else if(line == "PVM2")
+    {
+        version = 2;
+    }
+    else if(line == "PVM3")
+    {
+        version = 3;
+    }
+    else
+    {
+        return GL_FALSE;
+    }
+
+    // Resolution, first version allows comments in front of it
+    do
+    {
+        if(!nextLine())
+        {
+            return GL_FALSE;
+        }
+    }
+    while(version == 1 && !line.empty() && line[0] == '#');
 
-    // Volume (jump over declaration)
-    rapidxml::xml_node<>* pRootNode = doc.first_node()->next_sibling();
-    checkValue(std::string(pRootNode->name()), "volume", name);
+    GLint x, y, z;
+    if(sscanf(line.c_str(), "%d %d %d", &x, &y, &z) != 3)
+    {
+        return GL_FALSE;
+    }
+    resolution = glm::vec3(x, y, z);
 
-    // Get Version
-    rapidxml::xml_attribute<>* pRootNodeCurrentAttribute = pRootNode->first_attribute();
-    checkValue(std::string(pRootNodeCurrentAttribute->name()), "version", name);
-    GLfloat version = convertCharToFloat(pRootNodeCurrentAttribute->value());
+    // Scale is not available in first version
+    scale = glm::vec3(1, 1, 1);
+    if(version > 1)
+    {
+        if(!nextLine() || sscanf(line.c_str(), "%f %f %f", &scale.x, &scale.y, &scale.z) != 3)
+        {
+            return GL_FALSE;
+        }
+    }
 
-    // Pointer to nodes
-    rapidxml::xml_node<>* pChildNode = pRootNode->first_node();
+    // Bytes per voxel
+    if(!nextLine() || sscanf(line.c_str(), "%d", &bitDepth) != 1 || bitDepth < 1 || bitDepth > 2)
+    {
+        return GL_FALSE;
+    }
 
-    // Create properties
-    VolumeProperties properties;
+    headerSize = position;
+    return GL_TRUE;
+}
 
-    // Mirror
-    properties.useLinearFiltering = extractBool("mirrorX", name, pChildNode);
+GLboolean VolumeCreator::streamRawData(FileReader* pReader, GLubyte* pRawData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, VolumeStatistics* pStatistics)
+{
+    GLdouble startTime = glfwGetTime();
+
+    pStatistics->init(volumeResolution, valueResolution);
+
+    // Slabs consist of complete blocks of the importance volume
+    size_t sliceSize = static_cast<size_t>(volumeResolution.x) * static_cast<size_t>(volumeResolution.y) * getBytesPerVoxel(valueResolution);
+    GLuint sliceCount = static_cast<GLuint>(volumeResolution.z);
+    GLuint slicesPerBlock = pStatistics->getSlicesPerBlock();
+    GLuint blocksPerSlab = static_cast<GLuint>(VOLUMECREATOR_STREAMING_SLAB_SIZE / (sliceSize * slicesPerBlock));
+    GLuint slicesPerSlab = glm::max(blocksPerSlab, 1u) * slicesPerBlock;
+    reportBytesTotal(static_cast<GLuint64>(sliceSize) * sliceCount);
+
+    // Shared state of reader and worker
+    std::mutex mutex;
+    std::condition_variable condition;
+    GLuint readSlices = 0;
+    GLboolean stopped = GL_FALSE;
+
+    // Worker folds every completely read slab into the statistics
+    std::thread worker([&]()
+    {
+        GLuint accumulatedSlices = 0;
+        GLuint availableSlices = 0;
 
-    pChildNode = pChildNode->next_sibling();
-    properties.useLinearFiltering = extractBool("mirrorY", name, pChildNode);
+        while(accumulatedSlices < sliceCount)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return readSlices > accumulatedSlices || stopped; });
+                if(readSlices == accumulatedSlices)
+                {
+                    break;
+                }
+                availableSlices = readSlices;
+            }
 
-    pChildNode = pChildNode->next_sibling();
-    properties.useLinearFiltering = extractBool("mirrorZ", name, pChildNode);
+            pStatistics->accumulate(pRawData + static_cast<size_t>(accumulatedSlices) * sliceSize, accumulatedSlices, availableSlices - accumulatedSlices);
+            accumulatedSlices = availableSlices;
+        }
+    });
 
-    // Filtering
-    pChildNode = pChildNode->next_sibling();
-    properties.useLinearFiltering = extractBool("useLinearFiltering", name, pChildNode);
+    // Read next slab while worker is busy with previous one
+    GLboolean complete = GL_TRUE;
+    for(GLuint slice = 0; slice < sliceCount && !isCancelled(); slice += slicesPerSlab)
+    {
+        GLuint count = glm::min(slicesPerSlab, sliceCount - slice);
 
-    // Volume resolution
-    pChildNode = pChildNode->next_sibling();
-    glm::vec3 volumeResolution = extractVec3("volumeResolution", name, pChildNode);
+        size_t slabSize = static_cast<size_t>(count) * sliceSize;
+        if(readChunked(pReader, pRawData + static_cast<size_t>(slice) * sliceSize, slabSize) != slabSize)
+        {
+            complete = GL_FALSE;
+            break;
+        }
 
-    if(volumeResolution.x < 4 || volumeResolution.y < 4 || volumeResolution.z < 4)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            readSlices = slice + count;
+        }
+        condition.notify_one();
+        reportProgress(static_cast<GLfloat>(slice + count) / sliceCount);
+    }
+
+    // Worker stops early if reading was cancelled
     {
-        LogError("'" +  VOLUMECREATOR_PATH + name + ".xml' resolution too low (under 4x4x4)!");
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = GL_TRUE;
+    }
+    condition.notify_one();
+    worker.join();
+
+    if(isCancelled())
+    {
+        return GL_FALSE;
+    }
+
+    if(!complete)
+    {
+        return GL_FALSE;
+    }
+
+    GLdouble duration = glfwGetTime() - startTime;
+    GLdouble megabytes = static_cast<GLdouble>(sliceSize) * sliceCount / 1048576.0;
+    LogInfo("Reading and statistics took " + UT::to_string(duration) + " seconds (" + UT::to_string(megabytes / duration) + " MB/s)");
+
+
+    return GL_TRUE;
+}
+
+GLboolean VolumeCreator::readBrickedHeader(std::string path, VolumeBrickedHeader& header)
+{
+    std::ifstream in(path.c_str(), std::ios::in|std::ios::binary);
+
+    // Check whether file exisits
+    if(!in.is_open())
+    {
+        LogWarning("'" + path + "' was not found!");
+        return GL_FALSE;
+    }
+
+    in.read(reinterpret_cast<GLchar*>(&header), sizeof(header));
+    if(!in.good() || memcmp(header.magic, VOLUMECREATOR_BRICKED_MAGIC.c_str(), sizeof(header.magic)) != 0)
+    {
+        LogError("'" + path + "' is no bricked volume!");
+        return GL_FALSE;
+    }
+
+    if(header.version != VOLUMECREATOR_BRICKED_VERSION)
+    {
+        LogError("'" + path + "' has unsupported version " + UT::to_string(header.version) + "!");
+        return GL_FALSE;
+    }
+
+    // Layout must match the one statistics of this build use
+    VolumeStatistics statistics;
+    glm::vec3 volumeResolution(header.volumeResolution[0], header.volumeResolution[1], header.volumeResolution[2]);
+    VolumeValueResolution valueResolution = getBrickedValueResolution(header);
+    statistics.init(volumeResolution, valueResolution);
+    glm::ivec3 brickCount = (glm::ivec3(volumeResolution) + VOLUMECREATOR_BRICKED_BRICK_SIZE - 1) / VOLUMECREATOR_BRICKED_BRICK_SIZE;
+    glm::ivec3 importanceVolumeResolution = statistics.getImportanceVolumeResolution();
+
+    if(header.bytesPerVoxel != getBytesPerVoxel(valueResolution)
+        || (header.valueResolutionBits != 0 && header.valueResolutionBits != getValueResolutionBits(valueResolution))
+        || header.brickSize != static_cast<GLuint>(VOLUMECREATOR_BRICKED_BRICK_SIZE)
+        || header.histogramBinCount != statistics.getFullHistogram().size()
+        || brickCount != glm::ivec3(header.brickCount[0], header.brickCount[1], header.brickCount[2])
+        || importanceVolumeResolution != glm::ivec3(header.importanceVolumeResolution[0], header.importanceVolumeResolution[1], header.importanceVolumeResolution[2])
+        || volumeResolution.x < 4 || volumeResolution.y < 4 || volumeResolution.z < 4)
+    {
+        LogError("'" + path + "' has incompatible layout!");
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+VolumeValueResolution VolumeCreator::getBrickedValueResolution(const VolumeBrickedHeader& header) const
+{
+    VolumeValueResolution valueResolution = (header.bytesPerVoxel == 2) ? VOLUME_16BIT : VOLUME_8BIT;
+    if(header.valueResolutionBits != 0)
+    {
+        getValueResolutionFromBits(header.valueResolutionBits, valueResolution);
+    }
+    return valueResolution;
+}
+
+void VolumeCreator::setImportOptions(VolumeImportOptions importOptions)
+{
+    this->importOptions = importOptions;
+}
+
+void VolumeCreator::setMaxTextureResolution(GLint maxTextureResolution)
+{
+    this->maxTextureResolution = maxTextureResolution;
+}
+
+void VolumeCreator::processImport(VolumeData* pData)
+{
+    // Resampling to isotropic grid, extent of volume is kept
+    if(importOptions.resample)
+    {
+        glm::vec3 resolution = VolumeProcessor::findResampledResolution(pData->volumeResolution, pData->voxelScale, importOptions.resampleSpacing, importOptions.resampleVoxelBudget);
+        if(resolution != pData->volumeResolution)
+        {
+            GLdouble startTime = glfwGetTime();
+
+            RawData* pRawData = new RawData();
+            if(!pRawData->allocate(static_cast<size_t>(getVoxelCount(resolution)) * getBytesPerVoxel(pData->valueResolution)))
+            {
+                delete pRawData;
+                LogWarning("Resampling skipped, volume keeps its grid");
+            }
+            else
+            {
+                VolumeProcessor::resample(pData->pRawData->getData(), pData->volumeResolution, pRawData->getWritableData(), resolution, pData->valueResolution);
+
+                delete pData->pRawData;
+                pData->pRawData = pRawData;
+                pData->voxelScale = pData->volumeResolution * pData->voxelScale / resolution;
+                pData->volumeResolution = resolution;
+
+                pData->statistics.init(pData->volumeResolution, pData->valueResolution);
+                pData->statistics.accumulate(pData->pRawData->getData(), 0, static_cast<GLuint>(pData->volumeResolution.z));
+
+                LogInfo("Resampled to " + UT::to_string(resolution.x) + " x " + UT::to_string(resolution.y) + " x " + UT::to_string(resolution.z)
+                    + " with voxel scale " + UT::to_string(pData->voxelScale.x) + " in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+            }
+        }
+    }
+
+    // Denoising before quantization filters values with full precision
+    if(importOptions.denoising != VOLUMEPROCESSOR_DENOISE_NONE)
+    {
+        GLdouble startTime = glfwGetTime();
+
+        RawData* pRawData = new RawData();
+        if(!pRawData->allocate(static_cast<size_t>(getVoxelCount(pData->volumeResolution)) * getBytesPerVoxel(pData->valueResolution)))
+        {
+            delete pRawData;
+            LogWarning("Denoising skipped, volume keeps its noise");
+        }
+        else
+        {
+            VolumeProcessor::denoise(pData->pRawData->getData(), pData->volumeResolution, pRawData->getWritableData(), pData->valueResolution, importOptions.denoising, importOptions.denoisingSigma, importOptions.denoisingRangeSigma);
+
+            delete pData->pRawData;
+            pData->pRawData = pRawData;
+
+            pData->statistics.init(pData->volumeResolution, pData->valueResolution);
+            pData->statistics.accumulate(pData->pRawData->getData(), 0, static_cast<GLuint>(pData->volumeResolution.z));
+
+            LogInfo(std::string("Filtered with ") + getVolumeDenoisingName(importOptions.denoising) + " denoising in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+        }
+    }
+
+    // Quantization to 8 bit with window which keeps value offset and scale meaningful
+    if(importOptions.quantize && pData->valueResolution == VOLUME_16BIT)
+    {
+        GLdouble startTime = glfwGetTime();
+
+        GLushort low, high;
+        VolumeProcessor::findValueWindow(pData->statistics, importOptions.quantizationClipPercentage, low, high);
+
+        // Narrower window would map with value scale below minimum of editor, which snaps mapping at first edit
+        GLint minimumWidth = static_cast<GLint>(glm::ceil(VOLUMEPROPERTIES_VALUE_SCALE_MIN * 65535.0f));
+        if(high - low < minimumWidth)
+        {
+            GLint center = (static_cast<GLint>(low) + static_cast<GLint>(high)) / 2;
+            GLint widenedLow = glm::clamp(center - minimumWidth / 2, 0, 65535 - minimumWidth);
+            LogWarning("Window from " + UT::to_string(static_cast<GLuint>(low)) + " to " + UT::to_string(static_cast<GLuint>(high))
+                + " is widened to " + UT::to_string(widenedLow) + " to " + UT::to_string(widenedLow + minimumWidth) + ", so value scale stays editable");
+            low = static_cast<GLushort>(widenedLow);
+            high = static_cast<GLushort>(widenedLow + minimumWidth);
+        }
+
+        size_t voxelCount = static_cast<size_t>(getVoxelCount(pData->volumeResolution));
+        RawData* pRawData = new RawData();
+        if(!pRawData->allocate(voxelCount))
+        {
+            delete pRawData;
+            LogWarning("Quantization skipped, volume stays 16 bit");
+            return;
+        }
+        VolumeProcessor::quantize(reinterpret_cast<const GLushort*>(pData->pRawData->getData()), pRawData->getWritableData(), voxelCount, low, high);
+
+        delete pData->pRawData;
+        pData->pRawData = pRawData;
+        pData->valueResolution = VOLUME_8BIT;
+
+        // Value of texture is mapped back into range of 16 bit values
+        pData->properties.valueOffset = static_cast<GLfloat>(low) / 65535.0f;
+        pData->properties.valueScale = static_cast<GLfloat>(high - low) / 65535.0f;
+
+        pData->statistics.init(pData->volumeResolution, pData->valueResolution);
+        pData->statistics.accumulate(pData->pRawData->getData(), 0, static_cast<GLuint>(pData->volumeResolution.z));
+
+        LogInfo("Quantized to 8 bit with window from " + UT::to_string(static_cast<GLuint>(low)) + " to " + UT::to_string(static_cast<GLuint>(high))
+            + " in " + UT::to_string(glfwGetTime() - startTime) + " seconds");
+    }
+}
+
+GLboolean VolumeCreator::findRegion(glm::vec3 volumeResolution, glm::ivec3& rOffset, glm::ivec3& rSize) const
+{
+    if(!importOptions.useRegion)
+    {
+        return GL_FALSE;
+    }
+
+    // Region keeps at least four voxels per axis
+    glm::ivec3 resolution(volumeResolution);
+    rOffset = glm::clamp(importOptions.regionOffset, glm::ivec3(0), resolution - 4);
+    rSize = importOptions.regionSize;
+    for(GLint i = 0; i < 3; i++)
+    {
+        if(rSize[i] <= 0)
+        {
+            rSize[i] = resolution[i] - rOffset[i];
+        }
+    }
+    rSize = glm::clamp(rSize, glm::ivec3(4), resolution - rOffset);
+
+    if(rSize == resolution)
+    {
+        return GL_FALSE;
+    }
+
+    LogInfo("Region: " + UT::to_string(rSize.x) + " x " + UT::to_string(rSize.y) + " x " + UT::to_string(rSize.z)
+        + " at " + UT::to_string(rOffset.x) + ", " + UT::to_string(rOffset.y) + ", " + UT::to_string(rOffset.z));
+    return GL_TRUE;
+}
+
+void VolumeCreator::getRegionByteRange(glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size, size_t& rFirst, size_t& rLast) const
+{
+    size_t rowSize = static_cast<size_t>(volumeResolution.x) * bytesPerVoxel;
+    size_t sliceSize = rowSize * static_cast<size_t>(volumeResolution.y);
+
+    // From first row of first slice to end of last row of last slice
+    rFirst = offset.z * sliceSize + offset.y * rowSize;
+    rLast = (offset.z + size.z - 1) * sliceSize + (offset.y + size.y) * rowSize;
+}
+
+RawData* VolumeCreator::readRegion(std::string path, size_t dataOffset, glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size)
+{
+    GLdouble startTime = glfwGetTime();
+
+    size_t firstByte, lastByte;
+    getRegionByteRange(volumeResolution, bytesPerVoxel, offset, size, firstByte, lastByte);
+
+    // Mapping only loads pages of rows which are copied
+    RawData file;
+    if(file.map(path, dataOffset + firstByte, lastByte - firstByte))
+    {
+        file.advise(RAWDATA_ACCESS_SEQUENTIAL);
+        RawData* pRawData = cropRawData(file.getData(), firstByte, volumeResolution, bytesPerVoxel, offset, size);
+        LogInfo("Reading region took " + UT::to_string(glfwGetTime() - startTime) + " seconds (mapped)");
+        return pRawData;
+    }
+
+    FileReader reader;
+    if(!reader.open(path))
+    {
+        LogWarning("'" + path + "' was not found!");
         return NULL;
     }
 
-    // Voxel scale
-    pChildNode = pChildNode->next_sibling();
-    glm::vec3 voxelScale = extractVec3("voxelScale", name, pChildNode);
+    RawData* pRawData = new RawData();
+    size_t regionRowSize = size.x * bytesPerVoxel;
+    size_t regionSliceSize = regionRowSize * size.y;
+    if(!pRawData->allocate(regionSliceSize * size.z))
+    {
+        delete pRawData;
+        return NULL;
+    }
 
-    // Value resolution
-    pChildNode = pChildNode->next_sibling();
-    GLuint bitDepth = static_cast<GLuint>(extractFloat("valueResolution", name, pChildNode))/8;
-    VolumeValueResolution valueResolution = VOLUME_8BIT;
-    if(bitDepth == 2)
+    // Rows of region are contiguous in each slice, complete rows are read at once
+    size_t rowSize = static_cast<size_t>(volumeResolution.x) * bytesPerVoxel;
+    size_t sliceSize = rowSize * static_cast<size_t>(volumeResolution.y);
+    GLboolean fullRows = (regionRowSize == rowSize);
+    std::vector<GLubyte> rows(fullRows ? 0 : rowSize * size.y);
+    GLboolean complete = GL_TRUE;
+    reportBytesTotal(static_cast<GLuint64>(fullRows ? regionSliceSize : rows.size()) * size.z);
+
+    for(GLint z = 0; z < size.z && complete && !isCancelled(); z++)
     {
-        valueResolution = VOLUME_16BIT;
+        GLubyte* pSlice = pRawData->getWritableData() + z * regionSliceSize;
+        reader.seek(dataOffset + (offset.z + z) * sliceSize + offset.y * rowSize);
+
+        if(fullRows)
+        {
+            complete = (readChunked(&reader, pSlice, regionSliceSize) == regionSliceSize);
+        }
+        else
+        {
+            complete = (readChunked(&reader, &rows[0], rows.size()) == rows.size());
+            for(GLint y = 0; y < size.y && complete; y++)
+            {
+                memcpy(pSlice + y * regionRowSize, &rows[y * rowSize + offset.x * bytesPerVoxel], regionRowSize);
+            }
+        }
+        reportProgress(static_cast<GLfloat>(z + 1) / size.z);
     }
 
-    // Voxel scale
-    pChildNode = pChildNode->next_sibling();
-    properties.voxelScaleMultiplier = extractVec3("voxelScaleMultiplier", name, pChildNode);
+    if(!complete || isCancelled())
+    {
+        if(!complete)
+        {
+            LogError("'" + path + "' ended before all voxels were read!");
+        }
+        delete pRawData;
+        return NULL;
+    }
 
-    // Value offset
-    pChildNode = pChildNode->next_sibling();
-    properties.valueOffset = extractFloat("valueOffset", name, pChildNode);
+    LogInfo("Reading region took " + UT::to_string(glfwGetTime() - startTime) + " seconds (read)");
+    return pRawData;
+}
 
-    // Value scale
-    pChildNode = pChildNode->next_sibling();
-    properties.valueScale = extractFloat("valueScale", name, pChildNode);
+RawData* VolumeCreator::cropRawData(const GLubyte* pSource, size_t sourceOffset, glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size)
+{
+    RawData* pRawData = new RawData();
+    size_t regionRowSize = size.x * bytesPerVoxel;
+    size_t regionSliceSize = regionRowSize * size.y;
+    if(!pRawData->allocate(regionSliceSize * size.z))
+    {
+        delete pRawData;
+        return NULL;
+    }
 
-    // Rotation
-    pChildNode = pChildNode->next_sibling();
-    properties.eulerZXZRotation = extractVec3("eulerZXZRotation", name, pChildNode);
+    size_t rowSize = static_cast<size_t>(volumeResolution.x) * bytesPerVoxel;
+    size_t sliceSize = rowSize * static_cast<size_t>(volumeResolution.y);
+    GLubyte* pTarget = pRawData->getWritableData();
 
-    // *** READ RAW DATA ***
+    UT::parallelFor(0, size.z, [&](size_t first, size_t last)
+    {
+        for(size_t z = first; z < last; z++)
+        {
+            for(GLint y = 0; y < size.y; y++)
+            {
+                memcpy(
+                    pTarget + z * regionSliceSize + y * regionRowSize,
+                    pSource + (offset.z + z) * sliceSize + (offset.y + y) * rowSize + offset.x * bytesPerVoxel - sourceOffset,
+                    regionRowSize);
+            }
+        }
+    });
 
-    GLuint voxelCount = static_cast<GLuint>(volumeResolution.x * volumeResolution.y * volumeResolution.z);
-    GLubyte* volumeData = (GLubyte*)calloc(voxelCount,  static_cast<GLuint>(bitDepth) * sizeof(GLubyte));
+    return pRawData;
+}
 
-    // Read data
-    rawDataFile.read((char*)volumeData, static_cast<GLuint>(voxelCount * bitDepth) * sizeof(GLubyte));
+void VolumeCreator::reportProgress(GLfloat fraction)
+{
+    if(pProgress != NULL)
+    {
+        pProgress->fraction = fraction;
+    }
+}
 
-    GLuint textureHandle = createTexture(volumeData, volumeResolution, valueResolution, properties.useLinearFiltering);
+void VolumeCreator::reportBytesTotal(GLuint64 bytes)
+{
+    if(pProgress != NULL)
+    {
+        pProgress->bytesTotal += bytes;
+    }
+}
 
-    // Volume raw data is freed by volume object at destruction
+void VolumeCreator::reportBytesRead(GLuint64 bytes)
+{
+    if(pProgress != NULL)
+    {
+        pProgress->bytesRead += bytes;
+    }
+}
 
-    // *** CREATE VOLUME ***
-    Volume* pVolume = new Volume();
+GLboolean VolumeCreator::isCancelled() const
+{
+    return pProgress != NULL && pProgress->cancelled;
+}
 
-    // Initialize volume
-    pVolume->init(handle, name, textureHandle, volumeResolution, voxelScale, valueResolution, volumeData);
-    pVolume->setProperties(properties);
+GLboolean VolumeCreator::writeChunked(FILE* pFile, const GLubyte* pData, size_t size)
+{
+    for(size_t offset = 0; offset < size; offset += VOLUMECREATOR_IO_CHUNK_SIZE)
+    {
+        size_t chunk = glm::min(VOLUMECREATOR_IO_CHUNK_SIZE, size - offset);
+        if(fwrite(pData + offset, 1, chunk, pFile) != chunk)
+        {
+            return GL_FALSE;
+        }
+    }
+    return GL_TRUE;
+}
 
-    return pVolume;
+size_t VolumeCreator::readChunked(FileReader* pReader, GLubyte* pData, size_t size)
+{
+    // Cancellation is checked after every block
+    return pReader->read(pData, size, [this](size_t blockSize)
+    {
+        reportBytesRead(blockSize);
+        return !isCancelled();
+    });
 }
 
-GLint VolumeCreator::createTexture(GLubyte* volumeData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, GLboolean useLinearFiltering)
+GLint VolumeCreator::createTexture(const GLubyte* volumeData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, GLboolean useLinearFiltering, const VolumePyramid* pPyramid)
 {
     // Assign to handle and set parameters
     GLuint textureHandle;
@@ -446,24 +2758,37 @@ GLint VolumeCreator::createTexture(GLubyte* volumeData, glm::vec3 volumeResoluti
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
 
+    // Minified values come from mip levels
     if(useLinearFiltering)
     {
         glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     }
     else
     {
         glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     }
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, 0);
 
-    if(valueResolution == VOLUME_8BIT)
+    // Formats matching value resolutions
+    GLint internalFormat;
+    GLenum type;
+    getTextureFormat(valueResolution, internalFormat, type);
+
+    // Errors of earlier calls must not be taken for failed upload
+    while(glGetError() != GL_NO_ERROR) {}
+
+    glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, static_cast<GLuint>(volumeResolution.x), static_cast<GLuint>(volumeResolution.y), static_cast<GLuint>(volumeResolution.z), 0, GL_RED, type, volumeData);
+    if(pPyramid != NULL)
     {
-        glTexImage3D(GL_TEXTURE_3D, 0, GL_R8, static_cast<GLuint>(volumeResolution.x), static_cast<GLuint>(volumeResolution.y), static_cast<GLuint>(volumeResolution.z), 0, GL_RED, GL_UNSIGNED_BYTE, volumeData);
+        pPyramid->uploadLevels(internalFormat, type);
     }
-    else
+
+    // Limits were checked while preparing, but driver may still run out of memory
+    if(glGetError() != GL_NO_ERROR)
     {
-        glTexImage3D(GL_TEXTURE_3D, 0, GL_R16, static_cast<GLuint>(volumeResolution.x), static_cast<GLuint>(volumeResolution.y), static_cast<GLuint>(volumeResolution.z), 0, GL_RED, GL_UNSIGNED_SHORT, volumeData);
+        LogError("Texture of " + UT::to_string(volumeResolution.x) + " x " + UT::to_string(volumeResolution.y) + " x " + UT::to_string(volumeResolution.z) + " voxels could not be created, lower the texture budget");
     }
 
     // Unbind texture
@@ -471,37 +2796,3 @@ GLint VolumeCreator::createTexture(GLubyte* volumeData, glm::vec3 volumeResoluti
 
     return textureHandle;
 }
-
-GLint VolumeCreator::extractIntFromCharArray(std::ifstream* pIn)
-{
-    GLchar value[20];
-    GLchar helper = 'A';
-    pIn->read(&helper, sizeof(GLchar));
-    GLint i = 0;
-    while(helper != ' ' && helper != '\n')
-    {
-        value[i] =helper;
-        pIn->read(&helper, sizeof(GLchar));
-        i++;
-    }
-    value[i] = 0;
-
-    return atoi(value);
-}
-
-GLfloat VolumeCreator::extractFloatFromCharArray(std::ifstream* pIn)
-{
-    GLchar value[20];
-    GLchar helper = 'A';
-    pIn->read(&helper, sizeof(GLchar));
-    GLint i = 0;
-    while(helper != ' ' && helper != '\n')
-    {
-        value[i] =helper;
-        pIn->read(&helper, sizeof(GLchar));
-        i++;
-    }
-    value[i] = 0;
-
-    return static_cast<GLfloat>(atof(value));
-}
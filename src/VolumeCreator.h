@@ -37,14 +37,203 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
 
 #include "Logger.h"
 #include "Volume.h"
+#include "RawData.h"
+#include "FileReader.h"
+#include "VolumeCodec.h"
+#include "VoxelConverter.h"
+#include "VolumeProcessor.h"
+#include "VolumeGenerator.h"
 #include "CreatorHelper.h"
+#include "PicoPNG/picopng.h"
 
 const std::string VOLUMECREATOR_PATH = std::string(DATA_PATH) + "/Volumes/";
 const std::string VOLUMECREATOR_SUBDIR_PVM = "PVM/";
 const std::string VOLUMECREATOR_SUBDIR_DAT = "DAT/";
+const std::string VOLUMECREATOR_SUBDIR_NRRD = "NRRD/";
+const std::string VOLUMECREATOR_SUBDIR_MHD = "MHD/";
+const std::string VOLUMECREATOR_SUBDIR_PNG = "PNG/";
+const size_t VOLUMECREATOR_STREAMING_SLAB_SIZE = 64 * 1024 * 1024;
+const size_t VOLUMECREATOR_IO_CHUNK_SIZE = 64 * 1024 * 1024;
+const size_t VOLUMECREATOR_PVM_HEADER_MAX_SIZE = 4096;
+const std::string VOLUMECREATOR_DDS_ID_V3D = "DDS v3d\n";
+const std::string VOLUMECREATOR_DDS_ID_V3E = "DDS v3e\n";
+const size_t VOLUMECREATOR_DDS_INTERLEAVE = 1 << 24;
+const GLuint VOLUMECREATOR_DDS_RUN_LENGTH_BITS = 7;
+const std::string VOLUMECREATOR_BRICKED_EXTENSION = ".bricked";
+const std::string VOLUMECREATOR_BRICKED_MAGIC = "VORACABR";
+const GLuint VOLUMECREATOR_BRICKED_VERSION = 4;
+const GLint VOLUMECREATOR_BRICKED_BRICK_SIZE = 32;
+const size_t VOLUMECREATOR_BRICKED_DATA_ALIGNMENT = 4096;
+
+/** Header of bricked volume file, followed by full histogram (GLuint64), variances,
+    brick minima and brick maxima (GLfloat) and bricks starting at data offset.
+    Extrema have bricks of statistics, stored bricks are larger for fewer copies */
+struct VolumeBrickedHeader
+{
+    GLchar magic[8];
+    GLuint version;
+    GLuint bytesPerVoxel;
+    GLuint volumeResolution[3];
+    GLfloat voxelScale[3];
+    GLuint brickSize;
+    GLuint brickCount[3];
+    GLuint importanceVolumeResolution[3];
+    GLuint histogramBinCount;
+    GLfloat voxelScaleMultiplier[3];
+    GLfloat valueOffset;
+    GLfloat valueScale;
+    GLfloat eulerZXZRotation[3];
+    GLuint mirror[3];
+    GLuint useLinearFiltering;
+    GLuint regionOffset[3];
+    GLint valueResolutionBits;
+    GLuint64 dataOffset;
+};
+
+static_assert(sizeof(VolumeBrickedHeader) == 144, "Bricked header must have fixed layout");
+
+const std::string VOLUMECREATOR_COMPRESSED_EXTENSION = ".rawc";
+const std::string VOLUMECREATOR_COMPRESSED_MAGIC = "VORACARC";
+const GLuint VOLUMECREATOR_COMPRESSED_VERSION = 1;
+const size_t VOLUMECREATOR_COMPRESSED_BLOCK_SIZE = 1024 * 1024;
+const size_t VOLUMECREATOR_PNG_HEADER_SIZE = 26;
+const GLubyte VOLUMECREATOR_PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+/** Header of compressed raw data, followed by compressed blocks and
+    index of their file offsets (GLuint64, block count plus one) */
+struct VolumeCompressedHeader
+{
+    GLchar magic[8];
+    GLuint version;
+    GLuint bytesPerVoxel;
+    GLuint64 rawSize;
+    GLuint64 rowSize;
+    GLuint64 blockSize;
+    GLuint64 blockCount;
+    GLuint64 indexOffset;
+};
+
+static_assert(sizeof(VolumeCompressedHeader) == 56, "Compressed header must have fixed layout");
+
+/** Sources volumes can be prepared from */
+enum VolumeSource
+{
+    VOLUME_SOURCE_PVM, VOLUME_SOURCE_DAT, VOLUME_SOURCE_NRRD, VOLUME_SOURCE_MHD, VOLUME_SOURCE_PNG, VOLUME_SOURCE_GENERATOR, VOLUME_SOURCE_FILE
+};
+
+/** Processing applied to imported volumes, not to saved ones. Region is read from saved ones, too,
+    and gradients are computed for them as well */
+struct VolumeImportOptions
+{
+    VolumeImportOptions() : useRegion(GL_FALSE), regionOffset(0, 0, 0), regionSize(0, 0, 0), quantize(GL_FALSE), quantizationClipPercentage(0), resample(GL_FALSE), resampleSpacing(0), resampleVoxelBudget(0), denoising(VOLUMEPROCESSOR_DENOISE_NONE), denoisingSigma(1), denoisingRangeSigma(0.05f), precomputeGradients(GL_FALSE), gradients16Bit(GL_FALSE), pyramidReduction(VOLUME_PYRAMID_REDUCTION), textureByteBudget(0) {}
+
+    /** Read only region of volume, size of zero reaches to end of volume */
+    GLboolean useRegion;
+    glm::ivec3 regionOffset;
+    glm::ivec3 regionSize;
+
+    /** Quantize 16 bit volumes to 8 bit */
+    GLboolean quantize;
+
+    /** Percentage of voxels clipped at each end of value window, zero uses range of values */
+    GLfloat quantizationClipPercentage;
+
+    /** Resample to isotropic grid, spacing of zero takes finest axis */
+    GLboolean resample;
+    GLfloat resampleSpacing;
+
+    /** Maximum count of voxels after resampling, zero means no limit */
+    GLuint64 resampleVoxelBudget;
+
+    /** Filter against noise, sigma in voxels and range sigma of bilateral filter relative to values */
+    VolumeDenoising denoising;
+    GLfloat denoisingSigma;
+    GLfloat denoisingRangeSigma;
+
+    /** Compute gradient volume for raycaster while loading, with 16 instead of 8 bit per component */
+    GLboolean precomputeGradients;
+    GLboolean gradients16Bit;
+
+    /** Reduction of blocks for mip levels, minimum or maximum keep extrema of values */
+    VolumePyramidReduction pyramidReduction;
+
+    /** Maximum of bytes for texture of volume with its mip levels, zero means no limit */
+    GLuint64 textureByteBudget;
+};
+
+/** Format of PNG slice, taken from IHDR chunk */
+struct PNGSliceFormat
+{
+    GLuint width;
+    GLuint height;
+    GLuint bitDepth;
+    GLuint channels;
+};
+
+/** Progress of preparation, written by worker thread and read by render thread */
+struct VolumeProgress
+{
+    VolumeProgress() : fraction(0), bytesRead(0), bytesTotal(0), cancelled(false) {}
+
+    std::atomic<GLfloat> fraction;
+
+    /** Bytes read from files, total is zero as long as it is unknown */
+    std::atomic<GLuint64> bytesRead;
+    std::atomic<GLuint64> bytesTotal;
+
+    /** Set by other threads, preparation stops and frees what it has read */
+    std::atomic<bool> cancelled;
+};
+
+/** Volume prepared without OpenGL, owns raw data until volume is created from it */
+struct VolumeData
+{
+    VolumeData() : pRawData(NULL), regionOffset(0, 0, 0), regionRead(GL_FALSE), bricked(GL_FALSE), pTextureData(NULL), gradients16Bit(GL_FALSE) {}
+    ~VolumeData() { delete pRawData; delete pTextureData; }
+
+    std::string name;
+    glm::vec3 volumeResolution;
+    glm::vec3 voxelScale;
+    VolumeValueResolution valueResolution;
+    RawData* pRawData;
+    VolumeStatistics statistics;
+    SummedVolumeTable summedVolumeTable;
+    VolumeProperties properties;
+
+    /** Offset of voxels in volume they were read from */
+    glm::vec3 regionOffset;
+
+    /** Whether reader already took region of import options into account */
+    GLboolean regionRead;
+
+    /** Whether volume was read from bricked file, which carries statistics */
+    GLboolean bricked;
+
+    /** Downsampled values for texture, NULL if volume fits as it is */
+    RawData* pTextureData;
+    glm::vec3 textureResolution;
+
+    /** Statistics of downsampled values, only their bricks are used for empty space skipping */
+    VolumeStatistics textureStatistics;
+
+    /** Mip levels of texture, so they are built over downsampled values if there are some */
+    VolumePyramid pyramid;
+
+    /** Packed gradients in resolution of texture, empty if they were not precomputed */
+    std::vector<GLubyte> gradients;
+    GLboolean gradients16Bit;
+};
 
 class VolumeCreator
 {
@@ -52,25 +241,154 @@ public:
     VolumeCreator();
     ~VolumeCreator();
 
-    /** Imports PVM */
-    Volume* importPVM(std::string name, GLint handle);
+    /** Reads volume and does preprocessing without OpenGL, so it may run on worker thread. Returns NULL if it fails */
+    VolumeData* prepareVolume(VolumeSource source, std::string name);
 
-    /** Imports DAT*/
-    Volume* importDAT(std::string name, GLint handle);
+    /** Creates textures and volume on render thread, deletes prepared data. Returns NULL for NULL */
+    Volume* createVolume(VolumeData* pData, GLint handle);
 
     /** Creates default volume */
     Volume* createDefaultVolume(std::string name, GLint handle);
 
-    /** Writes volume to XML-File and Raw-File */
-    GLboolean writeToFile(Volume* pVolume, GLboolean overwriteExisting);
+    /** Writes volume to XML-File and Raw-File, which is optionally block compressed */
+    GLboolean writeToFile(Volume* pVolume, GLboolean overwriteExisting, GLboolean compressed);
 
-    /** Reads volume from XML-File and Raw-File, assigns handle to it */
-    Volume* readFromFile(std::string name, GLint handle);
+    /** Writes volume as bricks together with statistics and properties to single file */
+    GLboolean writeToBrickedFile(Volume* pVolume, GLboolean overwriteExisting);
+
+    /** Checks whether there is a bricked file for volume with that name */
+    GLboolean hasBrickedFile(std::string name);
+
+    /** Set progress which is updated while preparing, may be NULL */
+    void setProgress(VolumeProgress* pProgress);
+
+    /** Set options for processing of imported volumes */
+    void setImportOptions(VolumeImportOptions importOptions);
+
+    /** Set maximum resolution per axis of textures on device, zero means no limit */
+    void setMaxTextureResolution(GLint maxTextureResolution);
 
 protected:
-    GLint createTexture(GLubyte* volumeData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, GLboolean useLinearFiltering);
-    GLint extractIntFromCharArray(std::ifstream* pIn);
-    GLfloat extractFloatFromCharArray(std::ifstream* pIn);
+    /** Applies import options to prepared data */
+    void processImport(VolumeData* pData);
+
+    /** Region of import options clamped to volume, returns whether region is smaller than volume */
+    GLboolean findRegion(glm::vec3 volumeResolution, glm::ivec3& rOffset, glm::ivec3& rSize) const;
+
+    /** Reads only rows of region of uncompressed raw data at offset of file, mapped or by positioned reads. Fails if file ends early or reading is cancelled */
+    RawData* readRegion(std::string path, size_t dataOffset, glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size);
+
+    /** Copies region out of raw data. Source points to byte of volume given by source offset */
+    RawData* cropRawData(const GLubyte* pSource, size_t sourceOffset, glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size);
+
+    /** Byte range of volume covering rows of region */
+    void getRegionByteRange(glm::vec3 volumeResolution, size_t bytesPerVoxel, glm::ivec3 offset, glm::ivec3 size, size_t& rFirst, size_t& rLast) const;
+
+    /** Imports PVM */
+    VolumeData* preparePVM(std::string name);
+
+    /** Imports DAT*/
+    VolumeData* prepareDAT(std::string name);
+
+    /** Imports NRRD with raw encoding */
+    VolumeData* prepareNRRD(std::string name);
+
+    /** Imports uncompressed MetaImage */
+    VolumeData* prepareMHD(std::string name);
+
+    /** Generates volume from specification of VolumeGenerator */
+    VolumeData* prepareGenerated(std::string specification);
+
+    /** Imports directory of PNG slices, decoded in parallel into their place in volume */
+    VolumeData* prepareSliceStack(std::string name);
+
+    /** Reads format of PNG slice from its header */
+    GLboolean readPNGSliceFormat(std::string path, PNGSliceFormat& rFormat);
+
+    /** Parses format from signature and IHDR chunk */
+    GLboolean parsePNGSliceFormat(std::string path, const GLubyte* pFile, size_t size, PNGSliceFormat& rFormat);
+
+    /** Decodes PNG slice and writes first channel to target, buffers are reused by caller */
+    GLboolean decodePNGSlice(std::string path, const PNGSliceFormat& rFormat, std::vector<GLubyte>& rFile, std::vector<unsigned char>& rDecoded, GLubyte* pTarget);
+
+    /** Orders slice names with numbers by value */
+    static bool compareSliceNames(const std::string& rA, const std::string& rB);
+
+    /** Reads voxels of foreign type at offset of file and converts them, skip of minus one means data is at end */
+    VolumeData* prepareForeignData(std::string name, std::string path, GLint64 offset, GLint skip, glm::vec3 volumeResolution, glm::vec3 voxelScale, VoxelType type, GLboolean bigEndian);
+
+    /** Path of file to import, extension is optional */
+    std::string findImportFile(std::string subdirectory, std::string name, std::string extension);
+
+    /** Path of data file given relative to header */
+    std::string resolveDataFile(std::string headerPath, std::string dataFile);
+
+    /** Removes whitespace around value of header */
+    std::string trimHeaderValue(std::string value);
+
+    /** Reads volume from XML-File and Raw-File */
+    VolumeData* prepareFromFile(std::string name);
+
+    /** Compresses blocks of raw data in parallel and writes them with index */
+    GLboolean writeCompressedRawData(Volume* pVolume, std::string path);
+
+    /** Decompresses blocks covering byte range of raw data in parallel, returns NULL if it fails.
+        Returned data starts at decoded offset of volume */
+    RawData* readCompressedRawData(std::string path, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, size_t firstByte, size_t lastByte, size_t& rDecodedOffset);
+
+    /** Reads volume from bricked file without recomputing statistics */
+    VolumeData* prepareFromBrickedFile(std::string name);
+
+    /** Imports PVM compressed by DDS */
+    VolumeData* prepareCompressedPVM(FileReader* pReader, std::string name);
+
+    /** Decodes DDS stream into memory allocated by malloc, returns NULL if it fails */
+    GLubyte* decodeDDS(const GLubyte* pCompressed, size_t compressedSize, size_t interleaveBlockSize, size_t& decodedSize);
+
+    /** Restores order of bytes interleaved by DDS encoder in chunks of skip times block size, zero block size for whole data */
+    void deinterleaveDDS(GLubyte* pData, size_t size, GLuint skip, size_t blockSize);
+
+    /** Parses header of PVM in memory, returns whether successful */
+    GLboolean parsePVMHeader(const GLubyte* pData, size_t size, glm::vec3& resolution, glm::vec3& scale, GLint& bitDepth, size_t& headerSize);
+
+    /** Reads raw data slab by slab while a worker accumulates statistics of read slabs. Fails if file ends early or reading is cancelled */
+    GLboolean streamRawData(FileReader* pReader, GLubyte* pRawData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, VolumeStatistics* pStatistics);
+
+    /** Reads and validates header of bricked file, returns whether successful */
+    GLboolean readBrickedHeader(std::string path, VolumeBrickedHeader& header);
+
+    /** Value resolution of bricked volume, older files only know bytes per voxel */
+    VolumeValueResolution getBrickedValueResolution(const VolumeBrickedHeader& header) const;
+
+    /** Writes data in chunks, single calls of fwrite fail for huge sizes on some platforms */
+    GLboolean writeChunked(FILE* pFile, const GLubyte* pData, size_t size);
+
+    /** Reads data in blocks and counts read bytes. Stops when cancelled, returns count of bytes actually read */
+    size_t readChunked(FileReader* pReader, GLubyte* pData, size_t size);
+
+    /** Updates progress if there is one */
+    void reportProgress(GLfloat fraction);
+
+    /** Adds to bytes expected to be read */
+    void reportBytesTotal(GLuint64 bytes);
+
+    /** Adds to bytes read */
+    void reportBytesRead(GLuint64 bytes);
+
+    /** Whether preparation was cancelled */
+    GLboolean isCancelled() const;
+
+    /** Texture with value resolution, levels of pyramid are uploaded as mip levels if it is not NULL */
+    GLint createTexture(const GLubyte* volumeData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, GLboolean useLinearFiltering, const VolumePyramid* pPyramid);
+
+    /** Progress of current preparation */
+    VolumeProgress* pProgress;
+
+    /** Options for imports */
+    VolumeImportOptions importOptions;
+
+    /** Limit of device for textures */
+    GLint maxTextureResolution;
 };
 
 #endif
@@ -0,0 +1,307 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "VolumeGenerator.h"
+
+GLboolean VolumeGenerator::isSpecification(std::string name)
+{
+    return name.compare(0, VOLUMEGENERATOR_SPECIFICATION_PREFIX.size(), VOLUMEGENERATOR_SPECIFICATION_PREFIX) == 0;
+}
+
+GLboolean VolumeGenerator::parseSpecification(std::string specification, VolumeGeneratorSettings& rSettings)
+{
+    if(!isSpecification(specification))
+    {
+        return GL_FALSE;
+    }
+
+    // Split parts
+    std::vector<std::string> parts;
+    std::stringstream stream(specification.substr(VOLUMEGENERATOR_SPECIFICATION_PREFIX.size()));
+    std::string part;
+    while(std::getline(stream, part, ':'))
+    {
+        parts.push_back(part);
+    }
+    if(parts.empty())
+    {
+        return GL_FALSE;
+    }
+
+    // Field
+    GLint field = 0;
+    while(field < FIELD_COUNT && getFieldName(static_cast<VolumeField>(field)) != parts[0])
+    {
+        field++;
+    }
+    if(field == FIELD_COUNT)
+    {
+        return GL_FALSE;
+    }
+    rSettings.field = static_cast<VolumeField>(field);
+
+    // Resolution
+    if(parts.size() > 1)
+    {
+        GLint x = 0, y = 0, z = 0;
+        GLint count = sscanf(parts[1].c_str(), "%dx%dx%d", &x, &y, &z);
+        if(count == 1)
+        {
+            rSettings.resolution = glm::ivec3(x, x, x);
+        }
+        else if(count == 3)
+        {
+            rSettings.resolution = glm::ivec3(x, y, z);
+        }
+        else
+        {
+            return GL_FALSE;
+        }
+        if(glm::any(glm::lessThan(rSettings.resolution, glm::ivec3(4))))
+        {
+            return GL_FALSE;
+        }
+    }
+
+    // Bits
+    if(parts.size() > 2)
+    {
+        // Fields are never negative, so signed values are not offered
+        GLint bits = atoi(parts[2].c_str());
+        if(bits < 0 || !getValueResolutionFromBits(bits, rSettings.valueResolution))
+        {
+            return GL_FALSE;
+        }
+    }
+
+    // Empty fraction
+    if(parts.size() > 3)
+    {
+        rSettings.emptyFraction = glm::clamp(static_cast<GLfloat>(atof(parts[3].c_str())), 0.0f, 1.0f);
+    }
+
+    // Seed
+    if(parts.size() > 4)
+    {
+        rSettings.seed = static_cast<GLuint>(strtoul(parts[4].c_str(), NULL, 10));
+    }
+
+    return GL_TRUE;
+}
+
+std::string VolumeGenerator::createSpecification(const VolumeGeneratorSettings& rSettings)
+{
+    std::stringstream stream;
+    stream << VOLUMEGENERATOR_SPECIFICATION_PREFIX << getFieldName(rSettings.field) << ":"
+        << rSettings.resolution.x << "x" << rSettings.resolution.y << "x" << rSettings.resolution.z << ":"
+        << getValueResolutionBits(rSettings.valueResolution) << ":"
+        << rSettings.emptyFraction << ":" << rSettings.seed;
+    return stream.str();
+}
+
+std::string VolumeGenerator::createName(const VolumeGeneratorSettings& rSettings)
+{
+    std::stringstream stream;
+    stream << getFieldName(rSettings.field) << "_"
+        << rSettings.resolution.x << "x" << rSettings.resolution.y << "x" << rSettings.resolution.z << "_"
+        << getValueResolutionBits(rSettings.valueResolution) << "bit";
+    if(rSettings.field == FIELD_SPARSE_BLOBS)
+    {
+        stream << "_" << static_cast<GLint>(rSettings.emptyFraction * 100.0f + 0.5f) << "empty";
+    }
+    return stream.str();
+}
+
+std::string VolumeGenerator::getFieldName(VolumeField field)
+{
+    switch(field)
+    {
+    case FIELD_MARSCHNER_LOBB:
+        return "marschnerlobb";
+    case FIELD_NESTED_SPHERES:
+        return "spheres";
+    case FIELD_FRACTAL_NOISE:
+        return "noise";
+    case FIELD_SPARSE_BLOBS:
+        return "blobs";
+    default:
+        return "";
+    }
+}
+
+void VolumeGenerator::generate(const VolumeGeneratorSettings& rSettings, GLubyte* pTarget, std::function<void(GLfloat)> progress)
+{
+    // Decide type once instead of per voxel
+    switch(rSettings.valueResolution)
+    {
+    case VOLUME_8BIT:
+        generateSlices(rSettings, pTarget, progress);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        generateSlices(rSettings, reinterpret_cast<GLfloat*>(pTarget), progress);
+        break;
+    default:
+        generateSlices(rSettings, reinterpret_cast<GLushort*>(pTarget), progress);
+        break;
+    }
+}
+
+template<typename T> void VolumeGenerator::generateSlices(const VolumeGeneratorSettings& rSettings, T* pTarget, std::function<void(GLfloat)> progress)
+{
+    // Integer types use their full range, floats stay between zero and one
+    const GLfloat maxValue = std::numeric_limits<T>::is_integer ? static_cast<GLfloat>(std::numeric_limits<T>::max()) : 1.0f;
+    const GLfloat rounding = std::numeric_limits<T>::is_integer ? 0.5f : 0.0f;
+    glm::ivec3 resolution = rSettings.resolution;
+    size_t sliceVoxelCount = static_cast<size_t>(resolution.x) * resolution.y;
+    std::atomic<GLint> generatedSlices(0);
+
+    UT::parallelFor(0, resolution.z, [&](size_t first, size_t last)
+    {
+        for(GLint z = static_cast<GLint>(first); z < static_cast<GLint>(last); z++)
+        {
+            size_t index = z * sliceVoxelCount;
+            for(GLint y = 0; y < resolution.y; y++)
+            {
+                for(GLint x = 0; x < resolution.x; x++, index++)
+                {
+                    // Voxel centers in normalized coordinates
+                    glm::ivec3 voxel(x, y, z);
+                    glm::vec3 position = (glm::vec3(voxel) + 0.5f) / glm::vec3(resolution) * 2.0f - 1.0f;
+
+                    GLfloat value = 0;
+                    switch(rSettings.field)
+                    {
+                    case FIELD_MARSCHNER_LOBB:
+                        value = marschnerLobb(position);
+                        break;
+                    case FIELD_NESTED_SPHERES:
+                        value = nestedSpheres(position);
+                        break;
+                    case FIELD_FRACTAL_NOISE:
+                        value = fractalNoise(position, rSettings.seed);
+                        break;
+                    default:
+                        value = sparseBlobs(voxel, rSettings.emptyFraction, rSettings.seed);
+                        break;
+                    }
+
+                    pTarget[index] = static_cast<T>(glm::clamp(value, 0.0f, 1.0f) * maxValue + rounding);
+                }
+            }
+            progress(static_cast<GLfloat>(++generatedSlices) / resolution.z);
+        }
+    });
+}
+
+GLfloat VolumeGenerator::marschnerLobb(glm::vec3 position)
+{
+    // Marschner and Lobb, An Evaluation of Reconstruction Filters for Volume Rendering, 1994
+    GLfloat pi = glm::pi<GLfloat>();
+    GLfloat r = glm::sqrt(position.x * position.x + position.y * position.y);
+    GLfloat rhoR = glm::cos(2.0f * pi * VOLUMEGENERATOR_MARSCHNER_LOBB_FREQUENCY * glm::cos(pi * r / 2.0f));
+    return (1.0f - glm::sin(pi * position.z / 2.0f) + VOLUMEGENERATOR_MARSCHNER_LOBB_ALPHA * (1.0f + rhoR))
+        / (2.0f * (1.0f + VOLUMEGENERATOR_MARSCHNER_LOBB_ALPHA));
+}
+
+GLfloat VolumeGenerator::nestedSpheres(glm::vec3 position)
+{
+    // Shells with constant values, innermost is brightest
+    GLfloat radius = glm::length(position);
+    if(radius >= 1.0f)
+    {
+        return 0;
+    }
+    GLint shell = static_cast<GLint>(radius * VOLUMEGENERATOR_SPHERE_COUNT);
+    return static_cast<GLfloat>(VOLUMEGENERATOR_SPHERE_COUNT - shell) / VOLUMEGENERATOR_SPHERE_COUNT;
+}
+
+GLfloat VolumeGenerator::fractalNoise(glm::vec3 position, GLuint seed)
+{
+    // Octaves of value noise with halved amplitude and doubled frequency
+    glm::vec3 lattice = (position + 1.0f) * 0.5f * static_cast<GLfloat>(VOLUMEGENERATOR_NOISE_BASE_CELLS);
+    GLfloat value = 0;
+    GLfloat amplitude = 0.5f;
+    GLfloat amplitudeSum = 0;
+    for(GLint octave = 0; octave < VOLUMEGENERATOR_NOISE_OCTAVES; octave++)
+    {
+        value += amplitude * valueNoise(lattice, seed + octave);
+        amplitudeSum += amplitude;
+        lattice *= 2.0f;
+        amplitude *= 0.5f;
+    }
+    return value / amplitudeSum;
+}
+
+GLfloat VolumeGenerator::sparseBlobs(glm::ivec3 voxel, GLfloat emptyFraction, GLuint seed)
+{
+    // Each cell holds at most one blob which does not leave it
+    glm::ivec3 cell = voxel / VOLUMEGENERATOR_BLOB_CELL_SIZE;
+    if(random(cell, seed) < emptyFraction)
+    {
+        return 0;
+    }
+
+    // Radius and amplitude vary per blob
+    GLfloat halfSize = 0.5f * VOLUMEGENERATOR_BLOB_CELL_SIZE;
+    glm::vec3 center = glm::vec3(cell * VOLUMEGENERATOR_BLOB_CELL_SIZE) + halfSize;
+    GLfloat radius = halfSize * (0.5f + 0.5f * random(cell, seed + 1));
+    GLfloat distance = glm::length(glm::vec3(voxel) + 0.5f - center) / radius;
+    if(distance >= 1.0f)
+    {
+        return 0;
+    }
+    GLfloat amplitude = 0.5f + 0.5f * random(cell, seed + 2);
+    return amplitude * (1.0f - distance * distance * (3.0f - 2.0f * distance));
+}
+
+GLfloat VolumeGenerator::valueNoise(glm::vec3 position, GLuint seed)
+{
+    glm::vec3 floored = glm::floor(position);
+    glm::ivec3 point(floored);
+    glm::vec3 t = position - floored;
+    t = t * t * (3.0f - 2.0f * t);
+
+    // Trilinear interpolation of corners
+    GLfloat corners[8];
+    for(GLint i = 0; i < 8; i++)
+    {
+        corners[i] = random(point + glm::ivec3(i & 1, (i >> 1) & 1, (i >> 2) & 1), seed);
+    }
+    GLfloat x00 = glm::mix(corners[0], corners[1], t.x);
+    GLfloat x10 = glm::mix(corners[2], corners[3], t.x);
+    GLfloat x01 = glm::mix(corners[4], corners[5], t.x);
+    GLfloat x11 = glm::mix(corners[6], corners[7], t.x);
+    return glm::mix(glm::mix(x00, x10, t.y), glm::mix(x01, x11, t.y), t.z);
+}
+
+GLfloat VolumeGenerator::random(glm::ivec3 point, GLuint seed)
+{
+    // Integer hash, independent of platform and thread
+    GLuint hash = seed * 0x9E3779B9u;
+    hash ^= static_cast<GLuint>(point.x) * 0x85EBCA6Bu;
+    hash = (hash << 13) | (hash >> 19);
+    hash ^= static_cast<GLuint>(point.y) * 0xC2B2AE35u;
+    hash = (hash << 13) | (hash >> 19);
+    hash ^= static_cast<GLuint>(point.z) * 0x27D4EB2Fu;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return static_cast<GLfloat>(hash >> 8) / 16777216.0f;
+}
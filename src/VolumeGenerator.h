@@ -0,0 +1,118 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VolumeGenerator
+ *--------------
+ * Fills volumes of any resolution and value resolution
+ * with procedural fields, deterministic for given seed.
+ * Specifications like "generate:marschnerlobb:512:16"
+ * describe generated volumes in launch file and editor.
+ *
+ */
+
+#ifndef VOLUMEGENERATOR_H_
+#define VOLUMEGENERATOR_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <limits>
+
+#include "VolumeProperties.h"
+#include "VolumeStatistics.h"
+#include "Utilities.h"
+
+const std::string VOLUMEGENERATOR_SPECIFICATION_PREFIX = "generate:";
+const GLfloat VOLUMEGENERATOR_MARSCHNER_LOBB_FREQUENCY = 6.0f;
+const GLfloat VOLUMEGENERATOR_MARSCHNER_LOBB_ALPHA = 0.25f;
+const GLint VOLUMEGENERATOR_SPHERE_COUNT = 4;
+const GLint VOLUMEGENERATOR_NOISE_OCTAVES = 5;
+const GLint VOLUMEGENERATOR_NOISE_BASE_CELLS = 4;
+const GLint VOLUMEGENERATOR_BLOB_CELL_SIZE = 4 * VOLUME_BRICK_SIZE;
+
+enum VolumeField
+{
+    FIELD_MARSCHNER_LOBB, FIELD_NESTED_SPHERES, FIELD_FRACTAL_NOISE, FIELD_SPARSE_BLOBS, FIELD_COUNT
+};
+
+/** Everything which determines generated volume */
+struct VolumeGeneratorSettings
+{
+    VolumeGeneratorSettings() : field(FIELD_MARSCHNER_LOBB), resolution(256, 256, 256), valueResolution(VOLUME_8BIT), emptyFraction(0.9f), seed(1) {}
+
+    VolumeField field;
+    glm::ivec3 resolution;
+    VolumeValueResolution valueResolution;
+
+    /** Fraction of blob cells without blob, cells have size of bricks */
+    GLfloat emptyFraction;
+    GLuint seed;
+};
+
+class VolumeGenerator
+{
+public:
+    /** Whether name is specification of generated volume */
+    static GLboolean isSpecification(std::string name);
+
+    /** Parses "generate:field:resolution:bits:emptyFraction:seed", trailing parts are optional.
+        Resolution is either one edge or XxYxZ */
+    static GLboolean parseSpecification(std::string specification, VolumeGeneratorSettings& rSettings);
+
+    /** Specification which is parsed to settings */
+    static std::string createSpecification(const VolumeGeneratorSettings& rSettings);
+
+    /** Name of generated volume */
+    static std::string createName(const VolumeGeneratorSettings& rSettings);
+
+    /** Name of field used in specification */
+    static std::string getFieldName(VolumeField field);
+
+    /** Fills target with values of field, slices in parallel. Progress is called by all threads */
+    static void generate(const VolumeGeneratorSettings& rSettings, GLubyte* pTarget, std::function<void(GLfloat)> progress);
+
+private:
+    VolumeGenerator();
+
+    /** Generation for one type of voxels */
+    template<typename T> static void generateSlices(const VolumeGeneratorSettings& rSettings, T* pTarget, std::function<void(GLfloat)> progress);
+
+    /** Fields in normalized coordinates between minus one and one, values between zero and one */
+    static GLfloat marschnerLobb(glm::vec3 position);
+    static GLfloat nestedSpheres(glm::vec3 position);
+    static GLfloat fractalNoise(glm::vec3 position, GLuint seed);
+    static GLfloat sparseBlobs(glm::ivec3 voxel, GLfloat emptyFraction, GLuint seed);
+
+    /** Smoothly interpolated random values at integer lattice */
+    static GLfloat valueNoise(glm::vec3 position, GLuint seed);
+
+    /** Random value between zero and one for lattice point */
+    static GLfloat random(glm::ivec3 point, GLuint seed);
+};
+
+#endif
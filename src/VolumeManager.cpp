@@ -22,10 +22,24 @@ VolumeManager::VolumeManager()
 {
 	volumeHandleCounter = 0;
 	newVolumeCounter = 0;
+	maxTextureResolution = 0;
 }
 
 VolumeManager::~VolumeManager()
 {
+	// Cancel requests still running, so all of them stop at once
+	for(GLuint i = 0; i < jobs.size(); i++)
+	{
+		jobs[i]->progress.cancelled = true;
+	}
+	for(GLuint i = 0; i < jobs.size(); i++)
+	{
+		jobs[i]->worker.join();
+		delete jobs[i]->pData;
+		delete jobs[i];
+	}
+	jobs.clear();
+
 	// Delete all volumes
 	for(std::map<GLint, Volume*>::iterator it = volumes.begin(); it != volumes.end(); ++it)
 	{
@@ -41,56 +55,10 @@ VolumeManager::~VolumeManager()
 	volumes.clear();
 }
 
-void VolumeManager::init()
+void VolumeManager::init(GLint maxTextureResolution)
 {
-}
-
-GLint VolumeManager::importPVM(std::string name)
-{
-	// Logging
-	LogInfo("Import volume: " + name);
-
-	// Let the creator do the work
-	Volume* pVolume = volumeCreator.importPVM(name, volumeHandleCounter);
-
-	// Check wether importing was successful
-	if(pVolume != NULL)
-	{
-		// Add to map
-		volumes[volumeHandleCounter] = pVolume;
-
-		// Set latest handle
-		latestVolumeHandle = volumeHandleCounter;
-
-		// Increment handle counter
-		volumeHandleCounter++;
-	}
-
-	return latestVolumeHandle;
-}
-
-GLint VolumeManager::importDAT(std::string name)
-{
-	// Logging
-	LogInfo("Import volume: " + name);
-
-	// Let the creator do the work
-	Volume* pVolume = volumeCreator.importDAT(name, volumeHandleCounter);
-
-	// Check wether importing was successful
-	if(pVolume != NULL)
-	{
-		// Add to map
-		volumes[volumeHandleCounter] = pVolume;
-
-		// Set latest handle
-		latestVolumeHandle = volumeHandleCounter;
-
-		// Increment handle counter
-		volumeHandleCounter++;
-	}
-
-	return latestVolumeHandle;
+	this->maxTextureResolution = maxTextureResolution;
+	volumeCreator.setMaxTextureResolution(maxTextureResolution);
 }
 
 GLint VolumeManager::createDefaultVolume()
@@ -114,41 +82,64 @@ GLint VolumeManager::createDefaultVolume()
 	return latestVolumeHandle;
 }
 
-void VolumeManager::reloadVolume(GLint handle)
+GLboolean VolumeManager::saveVolume(GLint handle, GLboolean overwriteExisting, GLboolean bricked, GLboolean compressed)
 {
 	// Logging
-	LogInfo("Reload volume: " + getVolume(handle)->getName());
-
-	Volume* pOldVolume = getVolume(handle);
+	LogInfo("Save volume: " + getVolume(handle)->getName());
 
-	Volume* pReloadedVolume = volumeCreator.readFromFile(pOldVolume->getName(), handle);
+	// Forward to creator
+	if(bricked)
+	{
+		return volumeCreator.writeToBrickedFile(getVolume(handle), overwriteExisting);
+	}
 
-	// If there exists a XML-File with same name as volume, proceed
-	if(pReloadedVolume != NULL)
+	// Bricked file would be preferred at loading, so remove outdated one
+	GLboolean success = volumeCreator.writeToFile(getVolume(handle), overwriteExisting, compressed);
+	if(success && volumeCreator.hasBrickedFile(getVolume(handle)->getName()))
 	{
-		delete pOldVolume;
-		volumes[handle] = pReloadedVolume;
+		std::remove(std::string(VOLUMECREATOR_PATH + getVolume(handle)->getName() + VOLUMECREATOR_BRICKED_EXTENSION).c_str());
 	}
+	return success;
 }
 
-GLboolean VolumeManager::saveVolume(GLint handle, GLboolean overwriteExisting)
+GLint VolumeManager::loadVolume(std::string name)
 {
 	// Logging
-	LogInfo("Save volume: " + getVolume(handle)->getName());
+	LogInfo("Load volume: " + name);
 
-	// Forward to creator
-	return volumeCreator.writeToFile(getVolume(handle), overwriteExisting);
+	// Read volume from file
+	Volume* pVolume = volumeCreator.createVolume(volumeCreator.prepareVolume(VOLUME_SOURCE_FILE, name), volumeHandleCounter);
+
+	// Check wether loading was successful
+	if(pVolume != NULL)
+	{
+		// Add to map
+		volumes[volumeHandleCounter] = pVolume;
+
+		// Set latest volumeHandle
+		latestVolumeHandle = volumeHandleCounter;
+
+		// Increment volumeHandle counter
+		volumeHandleCounter++;
+
+		// Return handle
+		return latestVolumeHandle;
+	}
+	else
+	{
+		return -1;
+	}
 }
 
-GLint VolumeManager::loadVolume(std::string name)
+GLint VolumeManager::generateVolume(std::string specification)
 {
 	// Logging
-	LogInfo("Load volume: " + name);
+	LogInfo("Generate volume: " + specification);
 
-	// Read volume from file
-	Volume* pVolume = volumeCreator.readFromFile(name, volumeHandleCounter);
+	// Generate volume
+	Volume* pVolume = volumeCreator.createVolume(volumeCreator.prepareVolume(VOLUME_SOURCE_GENERATOR, specification), volumeHandleCounter);
 
-	// Check wether loading was successful
+	// Check wether generation was successful
 	if(pVolume != NULL)
 	{
 		// Add to map
@@ -171,10 +162,11 @@ GLint VolumeManager::loadVolume(std::string name)
 
 Volume* VolumeManager::getVolume(GLint handle)
 {
-	// Only possible because volumes may not be deleted
-	if(volumes.size() > static_cast<GLuint>(handle))
+	// Handles of pending or failed requests have no volume
+	std::map<GLint, Volume*>::iterator it = volumes.find(handle);
+	if(it != volumes.end())
 	{
-		return volumes.at(handle);
+		return it->second;
 	}
 	else
 	{
@@ -187,3 +179,166 @@ GLint VolumeManager::getLatestVolumeHandle()
 {
 	return latestVolumeHandle;
 }
+
+GLint VolumeManager::requestVolume(VolumeSource source, std::string name, VolumeImportOptions importOptions)
+{
+	// Logging
+	LogInfo("Request volume: " + name);
+
+	// Reserve handle
+	VolumeJob* pJob = new VolumeJob();
+	pJob->handle = volumeHandleCounter;
+	pJob->name = name;
+	pJob->creator.setImportOptions(importOptions);
+	volumeHandleCounter++;
+
+	startJob(pJob, source);
+
+	return pJob->handle;
+}
+
+void VolumeManager::requestReload(GLint handle)
+{
+	// Logging
+	LogInfo("Request reload of volume: " + getVolume(handle)->getName());
+
+	// Old volume is used until reloaded one is ready
+	VolumeJob* pJob = new VolumeJob();
+	pJob->handle = handle;
+	pJob->name = getVolume(handle)->getName();
+
+	startJob(pJob, VOLUME_SOURCE_FILE);
+}
+
+std::vector<GLint> VolumeManager::update()
+{
+	std::vector<GLint> finishedHandles;
+
+	for(GLuint i = 0; i < jobs.size();)
+	{
+		VolumeJob* pJob = jobs[i];
+		if(!pJob->done)
+		{
+			i++;
+			continue;
+		}
+		pJob->worker.join();
+
+		// Only texture creation is left for render thread
+		Volume* pVolume = volumeCreator.createVolume(pJob->pData, pJob->handle);
+		pJob->pData = NULL;
+
+		if(pVolume != NULL)
+		{
+			// Replace volume if it was reloaded
+			Volume* pOldVolume = getVolume(pJob->handle);
+			if(pOldVolume != NULL)
+			{
+				delete pOldVolume;
+			}
+			else
+			{
+				// Set latest handle
+				latestVolumeHandle = pJob->handle;
+			}
+			volumes[pJob->handle] = pVolume;
+
+			finishedHandles.push_back(pJob->handle);
+		}
+		else if(pJob->progress.cancelled)
+		{
+			LogInfo("Loading of volume cancelled: " + pJob->name);
+		}
+		else
+		{
+			LogError("Loading of volume failed: " + pJob->name);
+		}
+
+		delete pJob;
+		jobs.erase(jobs.begin() + i);
+	}
+
+	return finishedHandles;
+}
+
+GLboolean VolumeManager::isLoading() const
+{
+	return !jobs.empty();
+}
+
+GLfloat VolumeManager::getLoadingProgress() const
+{
+	if(jobs.empty())
+	{
+		return 0;
+	}
+	return jobs.front()->progress.fraction;
+}
+
+std::string VolumeManager::getLoadingName() const
+{
+	if(jobs.empty())
+	{
+		return "";
+	}
+	return jobs.front()->name;
+}
+
+void VolumeManager::getLoadingBytes(GLuint64& rBytesRead, GLuint64& rBytesTotal) const
+{
+	rBytesRead = 0;
+	rBytesTotal = 0;
+	if(!jobs.empty())
+	{
+		rBytesRead = jobs.front()->progress.bytesRead;
+		rBytesTotal = jobs.front()->progress.bytesTotal;
+	}
+}
+
+GLdouble VolumeManager::getLoadingTimeLeft() const
+{
+	if(jobs.empty())
+	{
+		return -1;
+	}
+	const VolumeJob* pJob = jobs.front();
+
+	// Bytes are more precise while reading, fraction covers the rest
+	GLdouble done = pJob->progress.fraction;
+	GLuint64 bytesRead = pJob->progress.bytesRead;
+	GLuint64 bytesTotal = pJob->progress.bytesTotal;
+	if(bytesTotal > 0 && bytesRead < bytesTotal)
+	{
+		done = static_cast<GLdouble>(bytesRead) / static_cast<GLdouble>(bytesTotal);
+	}
+
+	if(done <= 0)
+	{
+		return -1;
+	}
+	GLdouble elapsed = glfwGetTime() - pJob->startTime;
+	return elapsed * (1.0 - done) / done;
+}
+
+void VolumeManager::cancelLoading()
+{
+	for(GLuint i = 0; i < jobs.size(); i++)
+	{
+		jobs[i]->progress.cancelled = true;
+	}
+}
+
+void VolumeManager::startJob(VolumeJob* pJob, VolumeSource source)
+{
+	pJob->creator.setProgress(&(pJob->progress));
+	pJob->creator.setMaxTextureResolution(maxTextureResolution);
+	pJob->startTime = glfwGetTime();
+	jobs.push_back(pJob);
+
+	// Worker does everything except OpenGL calls
+	pJob->worker = std::thread([pJob, source]()
+	{
+		pJob->pData = pJob->creator.prepareVolume(source, pJob->name);
+		pJob->done = true;
+	});
+}
@@ -20,8 +20,9 @@
  * VolumeMananger
  *--------------
  * Manages volumes. It is not allowed to delete
- * volumes. Otherwise one has to change the implementation
- * of getVolume().
+ * volumes. Volumes can be loaded in background,
+ * their handles are reserved at request and filled
+ * when update() finishes them on the render thread.
  *
  */
 
@@ -33,6 +34,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
 
 #include "Logger.h"
 #include "Volume.h"
@@ -40,33 +44,69 @@
 
 const std::string VOLUMEMANAGER_NEW_VOLUME_NAME = "newVolume";
 
+/** Volume prepared by worker thread */
+struct VolumeJob
+{
+    VolumeJob() : pData(NULL), done(false), startTime(0) {}
+
+    GLint handle;
+    std::string name;
+    VolumeCreator creator;
+    VolumeProgress progress;
+    VolumeData* pData;
+    std::atomic<bool> done;
+    std::thread worker;
+    GLdouble startTime;
+};
+
 class VolumeManager
 {
 public:
     VolumeManager();
     ~VolumeManager();
 
-    /** Initialization */
-    void init();
-
-    /** Import PVM */
-    GLint importPVM(std::string name);
-
-    /** Import DAT */
-    GLint importDAT(std::string name);
+    /** Initialization, textures of volumes are downsampled to maximum resolution per axis of device */
+    void init(GLint maxTextureResolution);
 
     /** Create simple default volume */
     GLint createDefaultVolume();
 
-    /** Reload already loaded volume */
-    void reloadVolume(GLint handle);
+    /** Request volume to be prepared in background, only region of import options is used for saved volumes. Returns pending handle */
+    GLint requestVolume(VolumeSource source, std::string name, VolumeImportOptions importOptions = VolumeImportOptions());
+
+    /** Request reload of already loaded volume in background, volume is replaced when done */
+    void requestReload(GLint handle);
+
+    /** Creates volumes of finished requests, must be called by render thread. Returns their handles */
+    std::vector<GLint> update();
+
+    /** Whether there are requests in background */
+    GLboolean isLoading() const;
+
+    /** Progress of oldest request between zero and one */
+    GLfloat getLoadingProgress() const;
 
-    /** Save volume */
-    GLboolean saveVolume(GLint handle, GLboolean overwriteExisting);
+    /** Name of volume of oldest request */
+    std::string getLoadingName() const;
 
-    /** Load volume. Returns -1 if it fails */
+    /** Bytes read and expected by oldest request, total is zero while unknown */
+    void getLoadingBytes(GLuint64& rBytesRead, GLuint64& rBytesTotal) const;
+
+    /** Estimated seconds until oldest request is done, negative while unknown */
+    GLdouble getLoadingTimeLeft() const;
+
+    /** Cancel all requests, their partial data is freed by the workers */
+    void cancelLoading();
+
+    /** Save volume, either bricked or as XML and (compressed) raw data */
+    GLboolean saveVolume(GLint handle, GLboolean overwriteExisting, GLboolean bricked, GLboolean compressed);
+
+    /** Load volume synchronously, only for launch file before first frame. Returns -1 if it fails */
     GLint loadVolume(std::string name);
 
+    /** Generate volume synchronously, only for launch file before first frame. Returns -1 if it fails */
+    GLint generateVolume(std::string specification);
+
     /** Returns pointer to volume, for one-time-use only! */
     Volume* getVolume(GLint handle);
 
@@ -74,6 +114,9 @@ public:
     GLint getLatestVolumeHandle();
 
 protected:
+    /** Starts worker thread for job */
+    void startJob(VolumeJob* pJob, VolumeSource source);
+
     /** Latest used handle */
     GLint latestVolumeHandle;
 
@@ -88,6 +131,12 @@ protected:
 
     /** Counter for new volumes */
     GLint newVolumeCounter;
+
+    /** Requests running in background */
+    std::vector<VolumeJob*> jobs;
+
+    /** Limit of device, handed to creators of requests */
+    GLint maxTextureResolution;
 };
 
 #endif
@@ -0,0 +1,736 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "VolumeProcessor.h"
+
+void VolumeProcessor::findValueWindow(const VolumeStatistics& rStatistics, GLfloat clipPercentage, GLushort& rLow, GLushort& rHigh)
+{
+    // Used range is exact in brick extrema
+    const std::vector<GLfloat>& brickMinima = rStatistics.getBrickMinima();
+    const std::vector<GLfloat>& brickMaxima = rStatistics.getBrickMaxima();
+    GLfloat minimum = 65535;
+    GLfloat maximum = 0;
+    for(size_t i = 0; i < brickMinima.size(); i++)
+    {
+        minimum = glm::min(minimum, brickMinima[i]);
+        maximum = glm::max(maximum, brickMaxima[i]);
+    }
+    GLdouble low = minimum;
+    GLdouble high = maximum;
+
+    // Percentiles are interpolated inside of buckets of histogram
+    if(clipPercentage > 0)
+    {
+        const std::vector<GLuint64>& histogram = rStatistics.getFullHistogram();
+        GLuint64 total = 0;
+        for(size_t i = 0; i < histogram.size(); i++)
+        {
+            total += histogram[i];
+        }
+
+        GLdouble bucketWidth = 65535.0 / static_cast<GLdouble>(histogram.size() - 1);
+        GLdouble lowCount = static_cast<GLdouble>(total) * glm::clamp(clipPercentage, 0.0f, 50.0f) / 100.0;
+        GLdouble highCount = static_cast<GLdouble>(total) - lowCount;
+        GLdouble cumulated = 0;
+        GLboolean lowFound = GL_FALSE;
+        for(size_t i = 0; i < histogram.size(); i++)
+        {
+            GLdouble count = static_cast<GLdouble>(histogram[i]);
+            if(count == 0)
+            {
+                continue;
+            }
+            if(!lowFound && cumulated + count > lowCount)
+            {
+                low = glm::max(low, (i + (lowCount - cumulated) / count) * bucketWidth);
+                lowFound = GL_TRUE;
+            }
+            if(cumulated + count >= highCount)
+            {
+                high = glm::min(high, (i + (highCount - cumulated) / count) * bucketWidth);
+                break;
+            }
+            cumulated += count;
+        }
+    }
+
+    rLow = static_cast<GLushort>(glm::clamp(glm::floor(low), 0.0, 65534.0));
+    rHigh = static_cast<GLushort>(glm::clamp(glm::ceil(high), static_cast<GLdouble>(rLow) + 1.0, 65535.0));
+}
+
+void VolumeProcessor::quantize(const GLushort* pSource, GLubyte* pTarget, size_t count, GLushort low, GLushort high)
+{
+    GLfloat scale = 255.0f / static_cast<GLfloat>(high - low);
+    GLfloat offset = 0.5f - static_cast<GLfloat>(low) * scale;
+
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        size_t i = first;
+#ifdef VOLUMEPROCESSOR_USE_SSE2
+        // Saturating packs do clamping
+        const __m128 scales = _mm_set1_ps(scale);
+        const __m128 offsets = _mm_set1_ps(offset);
+        const __m128i zero = _mm_setzero_si128();
+        for(; i + 16 <= last; i += 16)
+        {
+            __m128i values[2] = { _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i + 8)) };
+            __m128i words[2];
+            for(GLint j = 0; j < 2; j++)
+            {
+                __m128 lower = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(values[j], zero)), scales), offsets);
+                __m128 upper = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(values[j], zero)), scales), offsets);
+
+                // Truncation of negative values rounds towards zero, which is clamped anyway
+                words[j] = _mm_packs_epi32(_mm_cvttps_epi32(lower), _mm_cvttps_epi32(upper));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pTarget + i), _mm_packus_epi16(words[0], words[1]));
+        }
+#endif
+        for(; i < last; i++)
+        {
+            GLfloat value = static_cast<GLfloat>(pSource[i]) * scale + offset;
+            pTarget[i] = static_cast<GLubyte>(glm::clamp(value, 0.0f, 255.0f));
+        }
+    });
+}
+
+template<typename S> void VolumeProcessor::addRow(const S* pRow, GLfloat weight, GLfloat* pAccumulated, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        pAccumulated[i] += weight * static_cast<GLfloat>(pRow[i]);
+    }
+}
+
+template<> void VolumeProcessor::addRow<GLfloat>(const GLfloat* pRow, GLfloat weight, GLfloat* pAccumulated, size_t count)
+{
+    size_t i = 0;
+#ifdef VOLUMEPROCESSOR_USE_SSE2
+    const __m128 weights = _mm_set1_ps(weight);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 values = _mm_mul_ps(_mm_loadu_ps(pRow + i), weights);
+        _mm_storeu_ps(pAccumulated + i, _mm_add_ps(_mm_loadu_ps(pAccumulated + i), values));
+    }
+#endif
+    for(; i < count; i++)
+    {
+        pAccumulated[i] += weight * pRow[i];
+    }
+}
+
+template<typename T> T VolumeProcessor::storeValue(GLfloat value)
+{
+    value = glm::floor(value + 0.5f);
+    return static_cast<T>(glm::clamp(value, static_cast<GLfloat>(std::numeric_limits<T>::min()), static_cast<GLfloat>(std::numeric_limits<T>::max())));
+}
+
+template<> GLfloat VolumeProcessor::storeValue<GLfloat>(GLfloat value)
+{
+    return value;
+}
+
+glm::vec3 VolumeProcessor::findResampledResolution(glm::vec3 volumeResolution, glm::vec3 voxelScale, GLfloat spacing, GLuint64 voxelBudget)
+{
+    glm::vec3 extent = volumeResolution * voxelScale;
+    if(spacing <= 0)
+    {
+        spacing = glm::min(voxelScale.x, glm::min(voxelScale.y, voxelScale.z));
+    }
+
+    // First guess from budget, rounding may need some more steps
+    if(voxelBudget > 0)
+    {
+        GLdouble voxelCount = static_cast<GLdouble>(extent.x / spacing) * static_cast<GLdouble>(extent.y / spacing) * static_cast<GLdouble>(extent.z / spacing);
+        if(voxelCount > static_cast<GLdouble>(voxelBudget))
+        {
+            spacing *= static_cast<GLfloat>(glm::pow(voxelCount / static_cast<GLdouble>(voxelBudget), 1.0 / 3.0));
+        }
+    }
+
+    glm::vec3 resolution;
+    while(true)
+    {
+        resolution = glm::max(glm::floor(extent / spacing + 0.5f), glm::vec3(4, 4, 4));
+        if(voxelBudget == 0 || getVoxelCount(resolution) <= voxelBudget || resolution == glm::vec3(4, 4, 4))
+        {
+            break;
+        }
+        spacing *= 1.01f;
+    }
+    return resolution;
+}
+
+GLuint64 VolumeProcessor::getTextureByteCount(glm::vec3 resolution, size_t bytesPerVoxel)
+{
+    // Levels are halved like in volume pyramid
+    glm::ivec3 levelResolution = glm::ivec3(resolution);
+    GLuint64 byteCount = getVoxelCount(resolution) * bytesPerVoxel;
+    while(glm::any(glm::greaterThan(levelResolution, glm::ivec3(1))))
+    {
+        levelResolution = glm::max(levelResolution / 2, glm::ivec3(1));
+        byteCount += getVoxelCount(glm::vec3(levelResolution)) * bytesPerVoxel;
+    }
+    return byteCount;
+}
+
+glm::vec3 VolumeProcessor::findTextureResolution(glm::vec3 volumeResolution, size_t bytesPerVoxel, GLint maxResolution, GLuint64 byteBudget)
+{
+    GLfloat scale = 1;
+    GLfloat largestAxis = glm::max(volumeResolution.x, glm::max(volumeResolution.y, volumeResolution.z));
+    if(maxResolution > 0 && largestAxis > maxResolution)
+    {
+        scale = static_cast<GLfloat>(maxResolution) / largestAxis;
+    }
+
+    // First guess from budget, rounding may need some more steps
+    if(byteBudget > 0)
+    {
+        GLdouble byteCount = static_cast<GLdouble>(getTextureByteCount(glm::floor(volumeResolution * scale), bytesPerVoxel));
+        if(byteCount > static_cast<GLdouble>(byteBudget))
+        {
+            scale *= static_cast<GLfloat>(glm::pow(static_cast<GLdouble>(byteBudget) / byteCount, 1.0 / 3.0));
+        }
+    }
+
+    glm::vec3 resolution;
+    while(true)
+    {
+        // Small epsilon keeps largest axis at maximum despite rounding of scale
+        resolution = glm::clamp(glm::floor(volumeResolution * scale + 0.001f), glm::vec3(1, 1, 1), volumeResolution);
+        if(maxResolution > 0)
+        {
+            resolution = glm::min(resolution, glm::vec3(static_cast<GLfloat>(maxResolution)));
+        }
+        if(byteBudget == 0 || getTextureByteCount(resolution, bytesPerVoxel) <= byteBudget || resolution == glm::vec3(1, 1, 1))
+        {
+            break;
+        }
+        scale *= 0.99f;
+    }
+    return resolution;
+}
+
+void VolumeProcessor::resample(const GLubyte* pSource, glm::vec3 sourceResolution, GLubyte* pTarget, glm::vec3 targetResolution, VolumeValueResolution valueResolution)
+{
+    glm::uvec3 source(sourceResolution);
+    glm::uvec3 target(targetResolution);
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        resampleVolume(pSource, source, pTarget, target);
+        break;
+    case VOLUME_16BIT:
+        resampleVolume(reinterpret_cast<const GLushort*>(pSource), source, reinterpret_cast<GLushort*>(pTarget), target);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        resampleVolume(reinterpret_cast<const GLshort*>(pSource), source, reinterpret_cast<GLshort*>(pTarget), target);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        resampleVolume(reinterpret_cast<const GLfloat*>(pSource), source, reinterpret_cast<GLfloat*>(pTarget), target);
+        break;
+    }
+}
+
+VolumeProcessor::AxisFilter VolumeProcessor::createAxisFilter(GLuint sourceCount, GLuint targetCount)
+{
+    // Tent covers neighbours when enlarging and all covered source samples when shrinking
+    GLdouble step = static_cast<GLdouble>(sourceCount) / static_cast<GLdouble>(targetCount);
+    GLdouble radius = glm::max(step, 1.0);
+
+    AxisFilter filter;
+    filter.taps = static_cast<GLuint>(glm::ceil(2.0 * radius)) + 1;
+    filter.indices.resize(static_cast<size_t>(targetCount) * filter.taps);
+    filter.weights.resize(static_cast<size_t>(targetCount) * filter.taps);
+
+    for(GLuint i = 0; i < targetCount; i++)
+    {
+        // Centers of voxels are aligned
+        GLdouble center = (i + 0.5) * step - 0.5;
+        GLint first = static_cast<GLint>(glm::floor(center - radius)) + 1;
+        GLdouble sum = 0;
+        for(GLuint j = 0; j < filter.taps; j++)
+        {
+            GLint index = first + static_cast<GLint>(j);
+            GLdouble weight = glm::max(0.0, 1.0 - glm::abs(index - center) / radius);
+            filter.indices[i * filter.taps + j] = static_cast<GLuint>(glm::clamp(index, 0, static_cast<GLint>(sourceCount) - 1));
+            filter.weights[i * filter.taps + j] = static_cast<GLfloat>(weight);
+            sum += weight;
+        }
+        for(GLuint j = 0; j < filter.taps; j++)
+        {
+            filter.weights[i * filter.taps + j] = static_cast<GLfloat>(filter.weights[i * filter.taps + j] / sum);
+        }
+    }
+    return filter;
+}
+
+template<typename T> void VolumeProcessor::resampleVolume(const T* pSource, glm::uvec3 sourceResolution, T* pTarget, glm::uvec3 targetResolution)
+{
+    // Only axes with changed resolution are filtered, in order of storage
+    std::vector<GLint> axes;
+    for(GLint axis = 0; axis < 3; axis++)
+    {
+        if(sourceResolution[axis] != targetResolution[axis])
+        {
+            axes.push_back(axis);
+        }
+    }
+    if(axes.empty())
+    {
+        std::copy(pSource, pSource + getVoxelCount(glm::vec3(sourceResolution)), pTarget);
+        return;
+    }
+
+    // Intermediate results are kept as floats
+    std::vector<GLfloat> buffers[2];
+    glm::uvec3 resolution = sourceResolution;
+    for(size_t i = 0; i < axes.size(); i++)
+    {
+        GLint axis = axes[i];
+        AxisFilter filter = createAxisFilter(resolution[axis], targetResolution[axis]);
+        GLboolean first = (i == 0);
+        GLboolean last = (i + 1 == axes.size());
+
+        if(first && last)
+        {
+            filterAxis(pSource, resolution, pTarget, axis, filter);
+        }
+        else if(first)
+        {
+            glm::uvec3 filtered = resolution;
+            filtered[axis] = targetResolution[axis];
+            buffers[0].resize(static_cast<size_t>(getVoxelCount(glm::vec3(filtered))));
+            filterAxis(pSource, resolution, &(buffers[0][0]), axis, filter);
+        }
+        else if(last)
+        {
+            filterAxis(&(buffers[(i + 1) % 2][0]), resolution, pTarget, axis, filter);
+        }
+        else
+        {
+            glm::uvec3 filtered = resolution;
+            filtered[axis] = targetResolution[axis];
+            buffers[i % 2].resize(static_cast<size_t>(getVoxelCount(glm::vec3(filtered))));
+            filterAxis(&(buffers[(i + 1) % 2][0]), resolution, &(buffers[i % 2][0]), axis, filter);
+        }
+        resolution[axis] = targetResolution[axis];
+    }
+}
+
+template<typename S, typename T> void VolumeProcessor::filterAxis(const S* pSource, glm::uvec3 sourceResolution, T* pTarget, GLint axis, const AxisFilter& rFilter)
+{
+    glm::uvec3 targetResolution = sourceResolution;
+    targetResolution[axis] = static_cast<GLuint>(rFilter.indices.size() / rFilter.taps);
+    size_t width = targetResolution.x;
+    size_t sourceSliceSize = static_cast<size_t>(sourceResolution.x) * sourceResolution.y;
+
+    // Each thread takes rows of target
+    UT::parallelFor(0, static_cast<size_t>(targetResolution.y) * targetResolution.z, [&](size_t firstRow, size_t lastRow)
+    {
+        std::vector<GLfloat> accumulated(width);
+        for(size_t row = firstRow; row < lastRow; row++)
+        {
+            size_t y = row % targetResolution.y;
+            size_t z = row / targetResolution.y;
+            T* pTargetRow = pTarget + row * width;
+
+            if(axis == 0)
+            {
+                // Taps are neighbours in row
+                const S* pSourceRow = pSource + z * sourceSliceSize + y * sourceResolution.x;
+                for(size_t x = 0; x < width; x++)
+                {
+                    GLfloat value = 0;
+                    for(GLuint j = 0; j < rFilter.taps; j++)
+                    {
+                        size_t tap = x * rFilter.taps + j;
+                        value += rFilter.weights[tap] * static_cast<GLfloat>(pSourceRow[rFilter.indices[tap]]);
+                    }
+                    pTargetRow[x] = storeValue<T>(value);
+                }
+            }
+            else
+            {
+                // Taps are whole rows, which are added up along row
+                std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+                size_t position = (axis == 1) ? y : z;
+                for(GLuint j = 0; j < rFilter.taps; j++)
+                {
+                    size_t tap = position * rFilter.taps + j;
+                    size_t index = rFilter.indices[tap];
+                    const S* pSourceRow = (axis == 1)
+                        ? pSource + z * sourceSliceSize + index * sourceResolution.x
+                        : pSource + index * sourceSliceSize + y * sourceResolution.x;
+                    addRow(pSourceRow, rFilter.weights[tap], &(accumulated[0]), width);
+                }
+                for(size_t x = 0; x < width; x++)
+                {
+                    pTargetRow[x] = storeValue<T>(accumulated[x]);
+                }
+            }
+        }
+    });
+}
+
+void VolumeProcessor::computeGradients(const GLubyte* pSource, glm::vec3 resolution, VolumeValueResolution valueResolution, GLboolean use16Bit, std::vector<GLubyte>& rGradients)
+{
+    size_t voxelCount = static_cast<size_t>(getVoxelCount(resolution));
+    if(use16Bit)
+    {
+        rGradients.resize(voxelCount * 4 * sizeof(GLushort));
+        gradientsOfType(pSource, glm::uvec3(resolution), valueResolution, reinterpret_cast<GLushort*>(&rGradients[0]));
+    }
+    else
+    {
+        rGradients.resize(voxelCount * 4);
+        gradientsOfType(pSource, glm::uvec3(resolution), valueResolution, &rGradients[0]);
+    }
+}
+
+template<typename G> void VolumeProcessor::gradientsOfType(const GLubyte* pSource, glm::uvec3 resolution, VolumeValueResolution valueResolution, G* pTarget)
+{
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        gradientsOfVolume(pSource, resolution, pTarget);
+        break;
+    case VOLUME_16BIT:
+        gradientsOfVolume(reinterpret_cast<const GLushort*>(pSource), resolution, pTarget);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        gradientsOfVolume(reinterpret_cast<const GLshort*>(pSource), resolution, pTarget);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        gradientsOfVolume(reinterpret_cast<const GLfloat*>(pSource), resolution, pTarget);
+        break;
+    }
+}
+
+template<typename T, typename G> void VolumeProcessor::gradientsOfVolume(const T* pSource, glm::uvec3 resolution, G* pTarget)
+{
+    size_t rowSize = resolution.x;
+    size_t sliceSize = rowSize * resolution.y;
+
+    // Each thread takes slices, neighbours at border are clamped like texture coordinates
+    UT::parallelFor(0, resolution.z, [&](size_t firstSlice, size_t lastSlice)
+    {
+        for(size_t z = firstSlice; z < lastSlice; z++)
+        {
+            const T* pSlice = pSource + z * sliceSize;
+            const T* pPreviousSlice = pSource + (z > 0 ? z - 1 : z) * sliceSize;
+            const T* pNextSlice = pSource + (z + 1 < resolution.z ? z + 1 : z) * sliceSize;
+
+            for(size_t y = 0; y < resolution.y; y++)
+            {
+                size_t rowOffset = y * rowSize;
+                const T* pRow = pSlice + rowOffset;
+                const T* pPreviousRow = pSlice + (y > 0 ? y - 1 : y) * rowSize;
+                const T* pNextRow = pSlice + (y + 1 < resolution.y ? y + 1 : y) * rowSize;
+                G* pTargetRow = pTarget + 4 * (z * sliceSize + rowOffset);
+
+                for(size_t x = 0; x < resolution.x; x++)
+                {
+                    size_t previousX = x > 0 ? x - 1 : x;
+                    size_t nextX = x + 1 < resolution.x ? x + 1 : x;
+                    glm::vec3 gradient(
+                        static_cast<GLfloat>(VoxelTraits<T>::value(pRow[nextX]) - VoxelTraits<T>::value(pRow[previousX])),
+                        static_cast<GLfloat>(VoxelTraits<T>::value(pNextRow[x]) - VoxelTraits<T>::value(pPreviousRow[x])),
+                        static_cast<GLfloat>(VoxelTraits<T>::value(pNextSlice[rowOffset + x]) - VoxelTraits<T>::value(pPreviousSlice[rowOffset + x])));
+
+                    // Zero gradient is packed as zero vector, raycaster divides magnitude by sqrt(3) as well
+                    GLfloat magnitude = glm::length(gradient);
+                    glm::vec3 normal = (magnitude > 0) ? gradient / magnitude : glm::vec3(0, 0, 0);
+                    pTargetRow[4 * x] = packComponent<G>(normal.x * 0.5f + 0.5f);
+                    pTargetRow[4 * x + 1] = packComponent<G>(normal.y * 0.5f + 0.5f);
+                    pTargetRow[4 * x + 2] = packComponent<G>(normal.z * 0.5f + 0.5f);
+                    pTargetRow[4 * x + 3] = packComponent<G>(magnitude / 1.7320508f);
+                }
+            }
+        }
+    });
+}
+
+template<typename G> G VolumeProcessor::packComponent(GLfloat value)
+{
+    return static_cast<G>(glm::clamp(value, 0.0f, 1.0f) * static_cast<GLfloat>(std::numeric_limits<G>::max()) + 0.5f);
+}
+
+template<> GLfloat VolumeProcessor::textureValue<GLubyte>(GLubyte voxel)
+{
+    return static_cast<GLfloat>(voxel) / 255.0f;
+}
+
+template<> GLfloat VolumeProcessor::textureValue<GLushort>(GLushort voxel)
+{
+    return static_cast<GLfloat>(voxel) / 65535.0f;
+}
+
+template<> GLfloat VolumeProcessor::textureValue<GLshort>(GLshort voxel)
+{
+    return glm::max(static_cast<GLfloat>(voxel) / 32767.0f, -1.0f);
+}
+
+template<> GLfloat VolumeProcessor::textureValue<GLfloat>(GLfloat voxel)
+{
+    return voxel;
+}
+
+void VolumeProcessor::denoise(const GLubyte* pSource, glm::vec3 resolution, GLubyte* pTarget, VolumeValueResolution valueResolution, VolumeDenoising denoising, GLfloat sigma, GLfloat rangeSigma)
+{
+    glm::uvec3 volumeResolution(resolution);
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        denoiseVolume(pSource, volumeResolution, pTarget, denoising, sigma, rangeSigma);
+        break;
+    case VOLUME_16BIT:
+        denoiseVolume(reinterpret_cast<const GLushort*>(pSource), volumeResolution, reinterpret_cast<GLushort*>(pTarget), denoising, sigma, rangeSigma);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        denoiseVolume(reinterpret_cast<const GLshort*>(pSource), volumeResolution, reinterpret_cast<GLshort*>(pTarget), denoising, sigma, rangeSigma);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        denoiseVolume(reinterpret_cast<const GLfloat*>(pSource), volumeResolution, reinterpret_cast<GLfloat*>(pTarget), denoising, sigma, rangeSigma);
+        break;
+    }
+}
+
+VolumeProcessor::AxisFilter VolumeProcessor::createGaussianFilter(GLuint count, GLfloat sigma)
+{
+    // Three sigma cover nearly all of the weight, indices are clamped at border
+    GLint radius = glm::max(1, static_cast<GLint>(glm::ceil(3.0f * sigma)));
+
+    AxisFilter filter;
+    filter.taps = static_cast<GLuint>(2 * radius + 1);
+    filter.indices.resize(static_cast<size_t>(count) * filter.taps);
+    filter.weights.resize(static_cast<size_t>(count) * filter.taps);
+
+    std::vector<GLfloat> weights(filter.taps);
+    GLfloat sum = 0;
+    for(GLint j = -radius; j <= radius; j++)
+    {
+        weights[j + radius] = glm::exp(-0.5f * static_cast<GLfloat>(j * j) / (sigma * sigma));
+        sum += weights[j + radius];
+    }
+
+    for(GLuint i = 0; i < count; i++)
+    {
+        for(GLuint j = 0; j < filter.taps; j++)
+        {
+            GLint index = static_cast<GLint>(i + j) - radius;
+            filter.indices[i * filter.taps + j] = static_cast<GLuint>(glm::clamp(index, 0, static_cast<GLint>(count) - 1));
+            filter.weights[i * filter.taps + j] = weights[j] / sum;
+        }
+    }
+    return filter;
+}
+
+template<typename T> void VolumeProcessor::denoiseVolume(const T* pSource, glm::uvec3 resolution, T* pTarget, VolumeDenoising denoising, GLfloat sigma, GLfloat rangeSigma)
+{
+    size_t voxelCount = static_cast<size_t>(getVoxelCount(glm::vec3(resolution)));
+    switch(denoising)
+    {
+    case VOLUMEPROCESSOR_DENOISE_GAUSSIAN:
+    case VOLUMEPROCESSOR_DENOISE_BILATERAL:
+    {
+        // Range sigma is converted from values like texture returns them to values of voxel type
+        GLfloat rangeFactor = 0;
+        if(denoising == VOLUMEPROCESSOR_DENOISE_BILATERAL)
+        {
+            GLfloat valueStep = textureValue<T>(static_cast<T>(1)) - textureValue<T>(static_cast<T>(0));
+            GLfloat voxelRangeSigma = glm::max(rangeSigma, 0.0001f) / valueStep;
+            rangeFactor = -0.5f / (voxelRangeSigma * voxelRangeSigma);
+        }
+
+        // Passes along axes in order of storage, intermediate results are kept as floats
+        std::vector<GLfloat> buffers[2];
+        buffers[0].resize(voxelCount);
+        buffers[1].resize(voxelCount);
+        denoiseAxis(pSource, resolution, &(buffers[0][0]), 0, createGaussianFilter(resolution.x, sigma), rangeFactor);
+        denoiseAxis(&(buffers[0][0]), resolution, &(buffers[1][0]), 1, createGaussianFilter(resolution.y, sigma), rangeFactor);
+        denoiseAxis(&(buffers[1][0]), resolution, pTarget, 2, createGaussianFilter(resolution.z, sigma), rangeFactor);
+        break;
+    }
+    case VOLUMEPROCESSOR_DENOISE_MEDIAN:
+        medianOfVolume(pSource, resolution, pTarget);
+        break;
+    default:
+        std::copy(pSource, pSource + voxelCount, pTarget);
+        break;
+    }
+}
+
+template<typename S, typename T> void VolumeProcessor::denoiseAxis(const S* pSource, glm::uvec3 resolution, T* pTarget, GLint axis, const AxisFilter& rFilter, GLfloat rangeFactor)
+{
+    if(rangeFactor != 0)
+    {
+        bilateralAxis(pSource, resolution, pTarget, axis, rFilter, rangeFactor);
+    }
+    else
+    {
+        filterAxis(pSource, resolution, pTarget, axis, rFilter);
+    }
+}
+
+template<typename S, typename T> void VolumeProcessor::bilateralAxis(const S* pSource, glm::uvec3 resolution, T* pTarget, GLint axis, const AxisFilter& rFilter, GLfloat rangeFactor)
+{
+    size_t width = resolution.x;
+    size_t sliceSize = width * resolution.y;
+
+    // Each thread takes rows, neighbours of all voxels in row are gathered per tap so inner loops run along row
+    UT::parallelFor(0, static_cast<size_t>(resolution.y) * resolution.z, [&](size_t firstRow, size_t lastRow)
+    {
+        std::vector<GLfloat> centers(width);
+        std::vector<GLfloat> neighbours(width);
+        std::vector<GLfloat> accumulated(width);
+        std::vector<GLfloat> weightSums(width);
+        for(size_t row = firstRow; row < lastRow; row++)
+        {
+            size_t y = row % resolution.y;
+            size_t z = row / resolution.y;
+            const S* pSourceRow = pSource + row * width;
+            for(size_t x = 0; x < width; x++)
+            {
+                centers[x] = static_cast<GLfloat>(pSourceRow[x]);
+            }
+            std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+            std::fill(weightSums.begin(), weightSums.end(), 0.0f);
+
+            for(GLuint j = 0; j < rFilter.taps; j++)
+            {
+                if(axis == 0)
+                {
+                    for(size_t x = 0; x < width; x++)
+                    {
+                        neighbours[x] = static_cast<GLfloat>(pSourceRow[rFilter.indices[x * rFilter.taps + j]]);
+                    }
+                }
+                else
+                {
+                    size_t position = (axis == 1) ? y : z;
+                    size_t index = rFilter.indices[position * rFilter.taps + j];
+                    const S* pNeighbourRow = (axis == 1)
+                        ? pSource + z * sliceSize + index * width
+                        : pSource + index * sliceSize + y * width;
+                    for(size_t x = 0; x < width; x++)
+                    {
+                        neighbours[x] = static_cast<GLfloat>(pNeighbourRow[x]);
+                    }
+                }
+
+                // Weight falls off with difference to value of center
+                GLfloat spatialWeight = rFilter.weights[j];
+                for(size_t x = 0; x < width; x++)
+                {
+                    GLfloat difference = neighbours[x] - centers[x];
+                    GLfloat weight = spatialWeight * glm::exp(rangeFactor * difference * difference);
+                    accumulated[x] += weight * neighbours[x];
+                    weightSums[x] += weight;
+                }
+            }
+
+            // Center has weight, so sum of weights is never zero
+            T* pTargetRow = pTarget + row * width;
+            for(size_t x = 0; x < width; x++)
+            {
+                pTargetRow[x] = storeValue<T>(accumulated[x] / weightSums[x]);
+            }
+        }
+    });
+}
+
+template<typename T> void VolumeProcessor::medianOfVolume(const T* pSource, glm::uvec3 resolution, T* pTarget)
+{
+    size_t rowSize = resolution.x;
+    size_t sliceSize = rowSize * resolution.y;
+    GLint lastY = static_cast<GLint>(resolution.y) - 1;
+    GLint lastZ = static_cast<GLint>(resolution.z) - 1;
+
+    // Each thread takes slabs of slices, neighbours at border are clamped like texture coordinates
+    UT::parallelFor(0, resolution.z, [&](size_t firstSlice, size_t lastSlice)
+    {
+        T window[27];
+        const T* pRows[9];
+        for(size_t z = firstSlice; z < lastSlice; z++)
+        {
+            for(size_t y = 0; y < resolution.y; y++)
+            {
+                // Nine rows of neighbourhood are shared by whole row
+                GLint row = 0;
+                for(GLint k = -1; k <= 1; k++)
+                {
+                    for(GLint j = -1; j <= 1; j++)
+                    {
+                        size_t neighbourZ = static_cast<size_t>(glm::clamp(static_cast<GLint>(z) + k, 0, lastZ));
+                        size_t neighbourY = static_cast<size_t>(glm::clamp(static_cast<GLint>(y) + j, 0, lastY));
+                        pRows[row++] = pSource + neighbourZ * sliceSize + neighbourY * rowSize;
+                    }
+                }
+
+                T* pTargetRow = pTarget + z * sliceSize + y * rowSize;
+                for(size_t x = 0; x < rowSize; x++)
+                {
+                    size_t left = (x > 0) ? x - 1 : x;
+                    size_t right = (x + 1 < rowSize) ? x + 1 : x;
+                    for(GLint i = 0; i < 9; i++)
+                    {
+                        window[3 * i] = pRows[i][left];
+                        window[3 * i + 1] = pRows[i][x];
+                        window[3 * i + 2] = pRows[i][right];
+                    }
+                    std::nth_element(window, window + 13, window + 27);
+                    pTargetRow[x] = window[13];
+                }
+            }
+        }
+    });
+}
+
+void VolumeProcessor::packBrickExtrema(const VolumeStatistics& rStatistics, VolumeValueResolution valueResolution, std::vector<GLfloat>& rExtrema)
+{
+    const std::vector<GLfloat>& rMinima = rStatistics.getBrickMinima();
+    const std::vector<GLfloat>& rMaxima = rStatistics.getBrickMaxima();
+    rExtrema.resize(2 * rMinima.size());
+
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        packExtrema<GLubyte>(rMinima, rMaxima, &rExtrema[0]);
+        break;
+    case VOLUME_16BIT:
+        packExtrema<GLushort>(rMinima, rMaxima, &rExtrema[0]);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        packExtrema<GLshort>(rMinima, rMaxima, &rExtrema[0]);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        packExtrema<GLfloat>(rMinima, rMaxima, &rExtrema[0]);
+        break;
+    }
+}
+
+template<typename T> void VolumeProcessor::packExtrema(const std::vector<GLfloat>& rMinima, const std::vector<GLfloat>& rMaxima, GLfloat* pExtrema)
+{
+    // Statistics keep values of voxel type, so they convert back exactly
+    for(size_t i = 0; i < rMinima.size(); i++)
+    {
+        pExtrema[2 * i] = textureValue(static_cast<T>(rMinima[i]));
+        pExtrema[2 * i + 1] = textureValue(static_cast<T>(rMaxima[i]));
+    }
+}
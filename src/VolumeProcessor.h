@@ -0,0 +1,162 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VolumeProcessor
+ *--------------
+ * Processing of raw data after import and before
+ * texture creation. Runs on all threads.
+ *
+ */
+
+#ifndef VOLUMEPROCESSOR_H_
+#define VOLUMEPROCESSOR_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "VolumeProperties.h"
+#include "VolumeStatistics.h"
+#include "Utilities.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VOLUMEPROCESSOR_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+/** Filters against noise, which are applied at import */
+enum VolumeDenoising
+{
+    VOLUMEPROCESSOR_DENOISE_NONE, VOLUMEPROCESSOR_DENOISE_GAUSSIAN, VOLUMEPROCESSOR_DENOISE_MEDIAN, VOLUMEPROCESSOR_DENOISE_BILATERAL
+};
+
+class VolumeProcessor
+{
+public:
+    /** Window of 16 bit values between percentiles of full histogram. Clip percentage of
+        zero gives range of values actually used. Window is never smaller than one value */
+    static void findValueWindow(const VolumeStatistics& rStatistics, GLfloat clipPercentage, GLushort& rLow, GLushort& rHigh);
+
+    /** Maps 16 bit values in window linearly to 8 bit, values outside are clamped */
+    static void quantize(const GLushort* pSource, GLubyte* pTarget, size_t count, GLushort low, GLushort high);
+
+    /** Isotropic grid covering same extent. Spacing of zero takes finest axis, spacing
+        grows until grid fits into voxel budget if budget is not zero */
+    static glm::vec3 findResampledResolution(glm::vec3 volumeResolution, glm::vec3 voxelScale, GLfloat spacing, GLuint64 voxelBudget);
+
+    /** Bytes of texture with all mip levels */
+    static GLuint64 getTextureByteCount(glm::vec3 resolution, size_t bytesPerVoxel);
+
+    /** Largest resolution with proportions of volume, whose texture fits maximum resolution
+        per axis and budget of bytes including mip levels. Zero means no limit */
+    static glm::vec3 findTextureResolution(glm::vec3 volumeResolution, size_t bytesPerVoxel, GLint maxResolution, GLuint64 byteBudget);
+
+    /** Resamples volume with separable tent filter, which is widened when axis shrinks */
+    static void resample(const GLubyte* pSource, glm::vec3 sourceResolution, GLubyte* pTarget, glm::vec3 targetResolution, VolumeValueResolution valueResolution);
+
+    /** Removes noise with separable Gaussian, median of 3x3x3 neighbourhood or separable bilateral filter.
+        Sigma is given in voxels, range sigma of bilateral filter relative to values like texture returns them */
+    static void denoise(const GLubyte* pSource, glm::vec3 resolution, GLubyte* pTarget, VolumeValueResolution valueResolution, VolumeDenoising denoising, GLfloat sigma, GLfloat rangeSigma);
+
+    /** Central difference gradients packed as normal in RGB and magnitude in A, either with
+        8 or 16 bit per component. Magnitude is scaled like the one computed in raycaster */
+    static void computeGradients(const GLubyte* pSource, glm::vec3 resolution, VolumeValueResolution valueResolution, GLboolean use16Bit, std::vector<GLubyte>& rGradients);
+
+    /** Minimum and maximum per brick of statistics as pairs, in units of texture of volume. Bricks
+        include one voxel of their neighbours, so linear filtering stays within extrema */
+    static void packBrickExtrema(const VolumeStatistics& rStatistics, VolumeValueResolution valueResolution, std::vector<GLfloat>& rExtrema);
+
+private:
+    VolumeProcessor();
+
+    /** Filter of one axis, each target sample has same count of taps */
+    struct AxisFilter
+    {
+        GLuint taps;
+        std::vector<GLuint> indices;
+        std::vector<GLfloat> weights;
+    };
+
+    /** Creates filter from source count to target count of samples */
+    static AxisFilter createAxisFilter(GLuint sourceCount, GLuint targetCount);
+
+    /** Creates Gaussian filter with same weights for every sample, count of samples is kept */
+    static AxisFilter createGaussianFilter(GLuint count, GLfloat sigma);
+
+    /** Resampling of volume with voxel type */
+    template<typename T> static void resampleVolume(const T* pSource, glm::uvec3 sourceResolution, T* pTarget, glm::uvec3 targetResolution);
+
+    /** Filters along one axis, other axes keep their resolution */
+    template<typename S, typename T> static void filterAxis(const S* pSource, glm::uvec3 sourceResolution, T* pTarget, GLint axis, const AxisFilter& rFilter);
+
+    /** Adds weighted row of values to accumulated row */
+    template<typename S> static void addRow(const S* pRow, GLfloat weight, GLfloat* pAccumulated, size_t count);
+
+    /** Denoising of volume with voxel type */
+    template<typename T> static void denoiseVolume(const T* pSource, glm::uvec3 resolution, T* pTarget, VolumeDenoising denoising, GLfloat sigma, GLfloat rangeSigma);
+
+    /** Pass of separable denoising along one axis, bilateral if range factor is not zero */
+    template<typename S, typename T> static void denoiseAxis(const S* pSource, glm::uvec3 resolution, T* pTarget, GLint axis, const AxisFilter& rFilter, GLfloat rangeFactor);
+
+    /** Bilateral filter along one axis, spatial weights of filter are taken from first sample */
+    template<typename S, typename T> static void bilateralAxis(const S* pSource, glm::uvec3 resolution, T* pTarget, GLint axis, const AxisFilter& rFilter, GLfloat rangeFactor);
+
+    /** Median of 3x3x3 neighbourhood, clamped at border */
+    template<typename T> static void medianOfVolume(const T* pSource, glm::uvec3 resolution, T* pTarget);
+
+    /** Converts filtered value to voxel type, integers are rounded and clamped */
+    template<typename T> static T storeValue(GLfloat value);
+
+    /** Gradients of volume with voxel type, packed into components of type G */
+    template<typename T, typename G> static void gradientsOfVolume(const T* pSource, glm::uvec3 resolution, G* pTarget);
+
+    /** Chooses voxel type for gradients */
+    template<typename G> static void gradientsOfType(const GLubyte* pSource, glm::uvec3 resolution, VolumeValueResolution valueResolution, G* pTarget);
+
+    /** Maps value from zero to one to unsigned normalized component */
+    template<typename G> static G packComponent(GLfloat value);
+
+    /** Converts extrema of voxel type to units of texture */
+    template<typename T> static void packExtrema(const std::vector<GLfloat>& rMinima, const std::vector<GLfloat>& rMaxima, GLfloat* pExtrema);
+
+    /** Value like texture returns it, signed values are normalized to minus one to one */
+    template<typename T> static GLfloat textureValue(T voxel);
+};
+
+/** Name of denoising filter for logging */
+inline const char* getVolumeDenoisingName(VolumeDenoising denoising)
+{
+    switch(denoising)
+    {
+    case VOLUMEPROCESSOR_DENOISE_GAUSSIAN:
+        return "Gaussian";
+    case VOLUMEPROCESSOR_DENOISE_MEDIAN:
+        return "median";
+    case VOLUMEPROCESSOR_DENOISE_BILATERAL:
+        return "bilateral";
+    default:
+        return "no";
+    }
+}
+
+#endif
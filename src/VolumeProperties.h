@@ -34,7 +34,7 @@ const GLfloat VOLUMEPROPERTIES_VALUE_OFFSET = 0.0f;
 const GLfloat VOLUMEPROPERTIES_VALUE_OFFSET_MIN = -1.0f;
 const GLfloat VOLUMEPROPERTIES_VALUE_OFFSET_MAX = 1.0f;
 const GLfloat VOLUMEPROPERTIES_VALUE_SCALE = 1.0f;
-const GLfloat VOLUMEPROPERTIES_VALUE_SCALE_MIN = 1.0f;
+const GLfloat VOLUMEPROPERTIES_VALUE_SCALE_MIN = 0.01f;
 const GLfloat VOLUMEPROPERTIES_VALUE_SCALE_MAX = 100.0f;
 const glm::vec3 VOLUMEPROPERTIES_EULER_ZXZ_ROTATION(0,0,0);
 const glm::vec3 VOLUMEPROPERTIES_EULER_ZXZ_ROTATION_MIN(0,0,0);
@@ -47,6 +47,150 @@ const GLboolean VOLUMEPROPERTIES_MIRROR_Y = GL_FALSE;
 const GLboolean VOLUMEPROPERTIES_MIRROR_Z = GL_FALSE;
 const GLboolean VOLUMEPROPERTIES_USE_LINEAR_FILTERING = GL_TRUE;
 
+enum VolumeValueResolution
+{
+    VOLUME_8BIT, VOLUME_16BIT, VOLUME_16BIT_SIGNED, VOLUME_32BIT_FLOAT
+};
+
+/** Count of voxels, multiplied as integers since floats are inexact above 2^24 */
+inline GLuint64 getVoxelCount(glm::vec3 volumeResolution)
+{
+    return static_cast<GLuint64>(volumeResolution.x)
+        * static_cast<GLuint64>(volumeResolution.y)
+        * static_cast<GLuint64>(volumeResolution.z);
+}
+
+/** Bytes used by one voxel */
+inline size_t getBytesPerVoxel(VolumeValueResolution valueResolution)
+{
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        return 1;
+    case VOLUME_32BIT_FLOAT:
+        return 4;
+    default:
+        return 2;
+    }
+}
+
+/** Bits as written to files, negative for signed values */
+inline GLint getValueResolutionBits(VolumeValueResolution valueResolution)
+{
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        return 8;
+    case VOLUME_16BIT_SIGNED:
+        return -16;
+    case VOLUME_32BIT_FLOAT:
+        return 32;
+    default:
+        return 16;
+    }
+}
+
+/** Inverse of getValueResolutionBits, returns false for unknown bits */
+inline GLboolean getValueResolutionFromBits(GLint bits, VolumeValueResolution& rValueResolution)
+{
+    switch(bits)
+    {
+    case 8:
+        rValueResolution = VOLUME_8BIT;
+        return GL_TRUE;
+    case 16:
+        rValueResolution = VOLUME_16BIT;
+        return GL_TRUE;
+    case -16:
+        rValueResolution = VOLUME_16BIT_SIGNED;
+        return GL_TRUE;
+    case 32:
+        rValueResolution = VOLUME_32BIT_FLOAT;
+        return GL_TRUE;
+    default:
+        return GL_FALSE;
+    }
+}
+
+/** Name for logging and display */
+inline const char* getValueResolutionName(VolumeValueResolution valueResolution)
+{
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        return "8 BIT";
+    case VOLUME_16BIT_SIGNED:
+        return "16 BIT SIGNED";
+    case VOLUME_32BIT_FLOAT:
+        return "32 BIT FLOAT";
+    default:
+        return "16 BIT";
+    }
+}
+
+/** Texture format matching value resolution, signed values are normalized to minus one to one */
+inline void getTextureFormat(VolumeValueResolution valueResolution, GLint& rInternalFormat, GLenum& rType)
+{
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        rInternalFormat = GL_R8;
+        rType = GL_UNSIGNED_BYTE;
+        break;
+    case VOLUME_16BIT_SIGNED:
+        rInternalFormat = GL_R16_SNORM;
+        rType = GL_SHORT;
+        break;
+    case VOLUME_32BIT_FLOAT:
+        rInternalFormat = GL_R32F;
+        rType = GL_FLOAT;
+        break;
+    default:
+        rInternalFormat = GL_R16;
+        rType = GL_UNSIGNED_SHORT;
+        break;
+    }
+}
+
+/** Range of values sampled from texture, signed normalized textures reach down to minus one */
+inline glm::vec2 getTextureValueRange(VolumeValueResolution valueResolution)
+{
+    return (valueResolution == VOLUME_16BIT_SIGNED) ? glm::vec2(-1, 1) : glm::vec2(0, 1);
+}
+
+/** Voxel types of value resolutions. Value maps voxel to position in texture
+    value range from zero to one, which histogram and pivot are based on. Integer
+    is unsigned and exact for sums, floats are mapped to 16 bit */
+template<typename T> struct VoxelTraits;
+
+template<> struct VoxelTraits<GLubyte>
+{
+    static const VolumeValueResolution valueResolution = VOLUME_8BIT;
+    static GLdouble value(GLubyte voxel) { return static_cast<GLdouble>(voxel) / 255.0; }
+    static GLuint64 integer(GLubyte voxel) { return voxel; }
+};
+
+template<> struct VoxelTraits<GLushort>
+{
+    static const VolumeValueResolution valueResolution = VOLUME_16BIT;
+    static GLdouble value(GLushort voxel) { return static_cast<GLdouble>(voxel) / 65535.0; }
+    static GLuint64 integer(GLushort voxel) { return voxel; }
+};
+
+template<> struct VoxelTraits<GLshort>
+{
+    static const VolumeValueResolution valueResolution = VOLUME_16BIT_SIGNED;
+    static GLdouble value(GLshort voxel) { return (static_cast<GLdouble>(voxel) + 32768.0) / 65535.0; }
+    static GLuint64 integer(GLshort voxel) { return static_cast<GLuint64>(static_cast<GLint>(voxel) + 32768); }
+};
+
+template<> struct VoxelTraits<GLfloat>
+{
+    static const VolumeValueResolution valueResolution = VOLUME_32BIT_FLOAT;
+    static GLdouble value(GLfloat voxel) { return (voxel > 0.0f) ? ((voxel < 1.0f) ? static_cast<GLdouble>(voxel) : 1.0) : 0.0; }
+    static GLuint64 integer(GLfloat voxel) { return static_cast<GLuint64>(value(voxel) * 65535.0 + 0.5); }
+};
+
 class VolumeProperties
 {
 public:
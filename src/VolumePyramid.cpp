@@ -0,0 +1,183 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "VolumePyramid.h"
+
+VolumePyramid::VolumePyramid()
+{
+    reduction = VOLUMEPYRAMID_AVERAGE;
+}
+
+VolumePyramid::~VolumePyramid()
+{
+}
+
+void VolumePyramid::build(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, VolumePyramidReduction reduction)
+{
+    this->reduction = reduction;
+    resolutions.assign(1, glm::ivec3(volumeResolution));
+    levels.clear();
+
+    // Halve until single voxel, like mip levels of OpenGL
+    size_t bytesPerVoxel = getBytesPerVoxel(valueResolution);
+    while(glm::any(glm::greaterThan(resolutions.back(), glm::ivec3(1))))
+    {
+        glm::ivec3 sourceResolution = resolutions.back();
+        glm::ivec3 targetResolution = glm::max(sourceResolution / 2, glm::ivec3(1));
+        const GLubyte* pSource = levels.empty() ? pData : &(levels.back()[0]);
+
+        std::vector<GLubyte> level(static_cast<size_t>(targetResolution.x) * targetResolution.y * targetResolution.z * bytesPerVoxel);
+
+        // Decide type once instead of per voxel
+        switch(valueResolution)
+        {
+        case VOLUME_8BIT:
+            reduceLevel(pSource, sourceResolution, &level[0], targetResolution);
+            break;
+        case VOLUME_16BIT:
+            reduceLevel(reinterpret_cast<const GLushort*>(pSource), sourceResolution, reinterpret_cast<GLushort*>(&level[0]), targetResolution);
+            break;
+        case VOLUME_16BIT_SIGNED:
+            reduceLevel(reinterpret_cast<const GLshort*>(pSource), sourceResolution, reinterpret_cast<GLshort*>(&level[0]), targetResolution);
+            break;
+        case VOLUME_32BIT_FLOAT:
+            reduceLevel(reinterpret_cast<const GLfloat*>(pSource), sourceResolution, reinterpret_cast<GLfloat*>(&level[0]), targetResolution);
+            break;
+        }
+
+        resolutions.push_back(targetResolution);
+        levels.push_back(std::vector<GLubyte>());
+        levels.back().swap(level);
+    }
+}
+
+GLboolean VolumePyramid::isBuilt() const
+{
+    return !resolutions.empty();
+}
+
+void VolumePyramid::swap(VolumePyramid& rOther)
+{
+    std::swap(reduction, rOther.reduction);
+    resolutions.swap(rOther.resolutions);
+    levels.swap(rOther.levels);
+}
+
+VolumePyramidReduction VolumePyramid::getReduction() const
+{
+    return reduction;
+}
+
+GLint VolumePyramid::getLevelCount() const
+{
+    return static_cast<GLint>(resolutions.size());
+}
+
+glm::ivec3 VolumePyramid::getLevelResolution(GLint level) const
+{
+    return resolutions[level];
+}
+
+const GLubyte* VolumePyramid::getLevelData(GLint level) const
+{
+    if(level <= 0)
+    {
+        return NULL;
+    }
+    return &(levels[level - 1][0]);
+}
+
+void VolumePyramid::uploadLevels(GLint internalFormat, GLenum type) const
+{
+    // Rows of coarse levels are rarely multiples of four bytes
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for(GLint level = 1; level < getLevelCount(); level++)
+    {
+        glTexImage3D(GL_TEXTURE_3D, level, internalFormat, resolutions[level].x, resolutions[level].y, resolutions[level].z, 0, GL_RED, type, getLevelData(level));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+    // Texture stays complete for mipmap filtering with any count of levels
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, glm::max(getLevelCount() - 1, 0));
+}
+
+template<typename T> void VolumePyramid::reduceLevel(const T* pSource, glm::ivec3 sourceResolution, T* pTarget, glm::ivec3 targetResolution) const
+{
+    size_t sourceRowSize = static_cast<size_t>(sourceResolution.x);
+    size_t sourceSliceSize = sourceRowSize * sourceResolution.y;
+    size_t targetRowSize = static_cast<size_t>(targetResolution.x);
+    size_t targetSliceSize = targetRowSize * targetResolution.y;
+
+    UT::parallelFor(0, targetResolution.z, [&](size_t first, size_t last)
+    {
+        for(GLint z = static_cast<GLint>(first); z < static_cast<GLint>(last); z++)
+        {
+            // Last block of odd axis takes three voxels, so no voxel is dropped
+            GLint beginZ = 2 * z;
+            GLint endZ = (z == targetResolution.z - 1) ? sourceResolution.z : glm::min(beginZ + 2, sourceResolution.z);
+            for(GLint y = 0; y < targetResolution.y; y++)
+            {
+                GLint beginY = 2 * y;
+                GLint endY = (y == targetResolution.y - 1) ? sourceResolution.y : glm::min(beginY + 2, sourceResolution.y);
+                for(GLint x = 0; x < targetResolution.x; x++)
+                {
+                    GLint beginX = 2 * x;
+                    GLint endX = (x == targetResolution.x - 1) ? sourceResolution.x : glm::min(beginX + 2, sourceResolution.x);
+
+                    GLdouble sum = 0;
+                    T minimum = pSource[beginZ * sourceSliceSize + beginY * sourceRowSize + beginX];
+                    T maximum = minimum;
+                    for(GLint k = beginZ; k < endZ; k++)
+                    {
+                        for(GLint j = beginY; j < endY; j++)
+                        {
+                            const T* pRow = pSource + k * sourceSliceSize + j * sourceRowSize;
+                            for(GLint i = beginX; i < endX; i++)
+                            {
+                                sum += pRow[i];
+                                minimum = glm::min(minimum, pRow[i]);
+                                maximum = glm::max(maximum, pRow[i]);
+                            }
+                        }
+                    }
+
+                    T value;
+                    switch(reduction)
+                    {
+                    case VOLUMEPYRAMID_MINIMUM:
+                        value = minimum;
+                        break;
+                    case VOLUMEPYRAMID_MAXIMUM:
+                        value = maximum;
+                        break;
+                    default:
+                        {
+                            // Integers are rounded to nearest
+                            GLdouble mean = sum / ((endZ - beginZ) * (endY - beginY) * (endX - beginX));
+                            value = std::numeric_limits<T>::is_integer ? static_cast<T>(glm::floor(mean + 0.5)) : static_cast<T>(mean);
+                        }
+                        break;
+                    }
+                    pTarget[z * targetSliceSize + y * targetRowSize + x] = value;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,109 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VolumePyramid
+ *--------------
+ * Mip levels of a volume, each level halves the
+ * resolution of the previous one until a single
+ * voxel is left. Blocks of two by two by two voxels
+ * are reduced by average, minimum or maximum. Level
+ * zero is the volume itself and not stored here.
+ *
+ */
+
+#ifndef VOLUMEPYRAMID_H_
+#define VOLUMEPYRAMID_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <limits>
+
+#include "VolumeProperties.h"
+#include "Utilities.h"
+
+enum VolumePyramidReduction
+{
+    VOLUMEPYRAMID_AVERAGE, VOLUMEPYRAMID_MINIMUM, VOLUMEPYRAMID_MAXIMUM
+};
+
+class VolumePyramid
+{
+public:
+    VolumePyramid();
+    ~VolumePyramid();
+
+    /** Builds all levels, each in parallel over its slices */
+    void build(const GLubyte* pData, glm::vec3 volumeResolution, VolumeValueResolution valueResolution, VolumePyramidReduction reduction);
+
+    /** Returns whether levels were built */
+    GLboolean isBuilt() const;
+
+    /** Swaps content with other pyramid */
+    void swap(VolumePyramid& rOther);
+
+    /** Returns reduction used for blocks */
+    VolumePyramidReduction getReduction() const;
+
+    /** Returns count of levels including level zero */
+    GLint getLevelCount() const;
+
+    /** Returns resolution of level */
+    glm::ivec3 getLevelResolution(GLint level) const;
+
+    /** Returns voxels of level from one on, in type of volume. NULL for level zero */
+    const GLubyte* getLevelData(GLint level) const;
+
+    /** Uploads levels from one on into bound 3D texture and limits its levels */
+    void uploadLevels(GLint internalFormat, GLenum type) const;
+
+private:
+    /** Private copy constuctor */
+    VolumePyramid(VolumePyramid const&) {};
+
+    /** Private assignment operator */
+    VolumePyramid& operator=(VolumePyramid const&) {return *this;};
+
+    /** Reduces level into next one per type of voxels */
+    template<typename T> void reduceLevel(const T* pSource, glm::ivec3 sourceResolution, T* pTarget, glm::ivec3 targetResolution) const;
+
+    VolumePyramidReduction reduction;
+
+    /** Resolutions of all levels, voxels of levels from one on */
+    std::vector<glm::ivec3> resolutions;
+    std::vector<std::vector<GLubyte> > levels;
+};
+
+/** Name of reduction for logging */
+inline const char* getVolumePyramidReductionName(VolumePyramidReduction reduction)
+{
+    switch(reduction)
+    {
+    case VOLUMEPYRAMID_MINIMUM:
+        return "minimum";
+    case VOLUMEPYRAMID_MAXIMUM:
+        return "maximum";
+    default:
+        return "average";
+    }
+}
+
+#endif
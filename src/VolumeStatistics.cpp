@@ -0,0 +1,345 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+
+#include "VolumeStatistics.h"
+
+VolumeStatistics::VolumeStatistics()
+{
+    accumulatedSlices = 0;
+    accumulationTime = 0;
+}
+
+VolumeStatistics::~VolumeStatistics()
+{
+}
+
+void VolumeStatistics::init(glm::vec3 volumeResolution, VolumeValueResolution valueResolution)
+{
+    this->volumeResolution = glm::ivec3(volumeResolution);
+    this->valueResolution = valueResolution;
+
+    // Calculate resolution of importance volume
+    importanceVolumeResolution = glm::max(this->volumeResolution / VOLUME_IMPORTANCE_VOLUME_DOWNSCALE, glm::ivec3(1));
+
+    // Calc block sizes represented by one voxel of importance volume, remainder goes to last block
+    blockSize = this->volumeResolution / importanceVolumeResolution;
+
+    // Reset accumulators
+    GLuint blockCount = importanceVolumeResolution.x * importanceVolumeResolution.y * importanceVolumeResolution.z;
+    valueSums.assign(blockCount, 0);
+    squaredValueSums.assign(blockCount, 0);
+    valueCounts.assign(blockCount, 0);
+    histogram.assign(VOLUME_HISTOGRAMM_BUCKET_COUNT, 0);
+
+    // Integer values of 8 bit volumes have one bin each, all others are 16 bit
+    GLuint64 maximum = (valueResolution == VOLUME_8BIT) ? 255 : 65535;
+    GLuint64 binCount = VOLUME_HISTOGRAMM_FULL_RESOLUTION ? maximum + 1 : VOLUME_HISTOGRAMM_BUCKET_COUNT;
+    binWidth = maximum / (binCount - 1);
+    fullHistogram.assign(static_cast<size_t>(binCount), 0);
+    variances.clear();
+    accumulatedSlices = 0;
+    accumulationTime = 0;
+
+    brickCount = computeBrickCount(volumeResolution);
+    GLuint bricks = brickCount.x * brickCount.y * brickCount.z;
+    brickMinima.assign(bricks, std::numeric_limits<GLfloat>::max());
+    brickMaxima.assign(bricks, -std::numeric_limits<GLfloat>::max());
+}
+
+void VolumeStatistics::accumulate(const GLubyte* pSlices, GLuint firstSlice, GLuint sliceCount)
+{
+    GLdouble startTime = glfwGetTime();
+
+    // Decide type once instead of per voxel
+    switch(valueResolution)
+    {
+    case VOLUME_8BIT:
+        accumulateSlices(pSlices, firstSlice, sliceCount);
+        break;
+    case VOLUME_16BIT:
+        accumulateSlices(reinterpret_cast<const GLushort*>(pSlices), firstSlice, sliceCount);
+        break;
+    case VOLUME_16BIT_SIGNED:
+        accumulateSlices(reinterpret_cast<const GLshort*>(pSlices), firstSlice, sliceCount);
+        break;
+    case VOLUME_32BIT_FLOAT:
+        accumulateSlices(reinterpret_cast<const GLfloat*>(pSlices), firstSlice, sliceCount);
+        break;
+    }
+
+    accumulatedSlices += sliceCount;
+    accumulationTime += glfwGetTime() - startTime;
+
+    if(isComplete())
+    {
+        finish();
+    }
+}
+
+void VolumeStatistics::restore(
+    glm::vec3 volumeResolution,
+    VolumeValueResolution valueResolution,
+    const std::vector<GLuint64>& fullHistogram,
+    const std::vector<GLfloat>& variances,
+    const std::vector<GLfloat>& brickMinima,
+    const std::vector<GLfloat>& brickMaxima)
+{
+    init(volumeResolution, valueResolution);
+
+    // Accumulators are not needed anymore
+    std::vector<GLuint64>().swap(valueSums);
+    std::vector<GLuint64>().swap(squaredValueSums);
+    std::vector<GLuint>().swap(valueCounts);
+
+    this->fullHistogram = fullHistogram;
+    bucketHistogram();
+    this->variances = variances;
+    this->brickMinima = brickMinima;
+    this->brickMaxima = brickMaxima;
+    accumulatedSlices = static_cast<GLuint>(this->volumeResolution.z);
+}
+
+GLboolean VolumeStatistics::isComplete() const
+{
+    return (accumulatedSlices > 0 && accumulatedSlices >= static_cast<GLuint>(volumeResolution.z));
+}
+
+GLuint VolumeStatistics::getSlicesPerBlock() const
+{
+    return static_cast<GLuint>(blockSize.z);
+}
+
+glm::ivec3 VolumeStatistics::getImportanceVolumeResolution() const
+{
+    return importanceVolumeResolution;
+}
+
+const std::vector<GLuint64>& VolumeStatistics::getHistogram() const
+{
+    return histogram;
+}
+
+const std::vector<GLuint64>& VolumeStatistics::getFullHistogram() const
+{
+    return fullHistogram;
+}
+
+const std::vector<GLfloat>& VolumeStatistics::getVariances() const
+{
+    return variances;
+}
+
+glm::ivec3 VolumeStatistics::getBrickCount() const
+{
+    return brickCount;
+}
+
+glm::ivec3 VolumeStatistics::computeBrickCount(glm::vec3 volumeResolution)
+{
+    return (glm::ivec3(volumeResolution) + VOLUME_BRICK_SIZE - 1) / VOLUME_BRICK_SIZE;
+}
+
+const std::vector<GLfloat>& VolumeStatistics::getBrickMinima() const
+{
+    return brickMinima;
+}
+
+const std::vector<GLfloat>& VolumeStatistics::getBrickMaxima() const
+{
+    return brickMaxima;
+}
+
+void VolumeStatistics::finish()
+{
+    bucketHistogram();
+
+    variances.assign(valueSums.size(), 0);
+    GLdouble count;
+
+    for(GLuint i = 0; i < variances.size(); i++)
+    {
+        if(valueCounts[i] == 0)
+        {
+            continue;
+        }
+
+        // Numerator of variance is exact, count times squared sum stays far below 64 bit for blocks of 16 bit values
+        count = static_cast<GLdouble>(valueCounts[i]);
+        GLuint64 numerator = valueCounts[i] * squaredValueSums[i] - valueSums[i] * valueSums[i];
+        variances[i] = static_cast<GLfloat>(static_cast<GLdouble>(numerator) / (count * count));
+    }
+
+    // Accumulators are not needed anymore
+    std::vector<GLuint64>().swap(valueSums);
+    std::vector<GLuint64>().swap(squaredValueSums);
+    std::vector<GLuint>().swap(valueCounts);
+
+    LogInfo("Histogram and importance volume accumulated in " + UT::to_string(accumulationTime) + " seconds");
+}
+
+void VolumeStatistics::bucketHistogram()
+{
+    // Buckets cover same values as when mapping values from zero to one
+    histogram.assign(VOLUME_HISTOGRAMM_BUCKET_COUNT, 0);
+    size_t lastBin = fullHistogram.size() - 1;
+    for(size_t i = 0; i < fullHistogram.size(); i++)
+    {
+        histogram[i * (VOLUME_HISTOGRAMM_BUCKET_COUNT - 1) / lastBin] += fullHistogram[i];
+    }
+}
+
+GLint VolumeStatistics::getBlockLayer(GLint slice) const
+{
+    return glm::min(slice / blockSize.z, importanceVolumeResolution.z - 1);
+}
+
+template<typename T> void VolumeStatistics::accumulateSlices(const T* pSlices, GLuint firstSlice, GLuint sliceCount)
+{
+    size_t sliceSize = static_cast<size_t>(volumeResolution.x) * static_cast<size_t>(volumeResolution.y);
+    GLint bricksPerLayer = brickCount.x * brickCount.y;
+    GLint blocksPerLayer = importanceVolumeResolution.x * importanceVolumeResolution.y;
+    std::mutex mutex;
+
+    // Each thread accumulates slab of slices into own accumulators, which cover only layers of its slab
+    UT::parallelFor(firstSlice, firstSlice + sliceCount, [&](size_t firstZ, size_t lastZ)
+    {
+        // Slices at borders of slab also belong to bricks of neighbouring layers
+        GLint firstBrickLayer = glm::max(static_cast<GLint>(firstZ) - 1, 0) / VOLUME_BRICK_SIZE;
+        GLint firstBlockLayer = getBlockLayer(static_cast<GLint>(firstZ));
+        GLint brickLayers = glm::min(static_cast<GLint>(lastZ), volumeResolution.z - 1) / VOLUME_BRICK_SIZE - firstBrickLayer + 1;
+        GLint blockLayers = getBlockLayer(static_cast<GLint>(lastZ - 1)) - firstBlockLayer + 1;
+
+        std::vector<GLuint64> slabHistogram(fullHistogram.size(), 0);
+        std::vector<T> slabMinima(bricksPerLayer * brickLayers, std::numeric_limits<T>::max());
+        std::vector<T> slabMaxima(bricksPerLayer * brickLayers, std::numeric_limits<T>::lowest());
+        std::vector<T> rowMinima(brickCount.x);
+        std::vector<T> rowMaxima(brickCount.x);
+        std::vector<GLuint64> slabSums(blocksPerLayer * blockLayers, 0);
+        std::vector<GLuint64> slabSquaredSums(blocksPerLayer * blockLayers, 0);
+        std::vector<GLuint> slabCounts(blocksPerLayer * blockLayers, 0);
+
+        const T* pValue = pSlices + (firstZ - firstSlice) * sliceSize;
+        GLuint64 value, rowSum, rowSquaredSum;
+        GLuint blockIndex, brickIndex;
+
+        // Walk through slices in order of memory
+        for(GLint z = static_cast<GLint>(firstZ); z < static_cast<GLint>(lastZ); z++)
+        {
+            for(GLint y = 0; y < volumeResolution.y; y++)
+            {
+                // Histogram of complete row, integer values are bins when they have full resolution
+                if(binWidth == 1)
+                {
+                    for(GLint x = 0; x < volumeResolution.x; x++)
+                    {
+                        slabHistogram[static_cast<size_t>(VoxelTraits<T>::integer(pValue[x]))]++;
+                    }
+                }
+                else
+                {
+                    for(GLint x = 0; x < volumeResolution.x; x++)
+                    {
+                        slabHistogram[static_cast<size_t>(VoxelTraits<T>::integer(pValue[x]) / binWidth)]++;
+                    }
+                }
+
+                // Minimum and maximum of row within each brick and one voxel of its neighbours
+                for(GLint brickX = 0; brickX < brickCount.x; brickX++)
+                {
+                    GLint begin = glm::max(brickX * VOLUME_BRICK_SIZE - 1, 0);
+                    GLint end = glm::min((brickX + 1) * VOLUME_BRICK_SIZE + 1, volumeResolution.x);
+                    T rowMinimum = pValue[begin];
+                    T rowMaximum = pValue[begin];
+                    for(GLint i = begin + 1; i < end; i++)
+                    {
+                        rowMinimum = pValue[i] < rowMinimum ? pValue[i] : rowMinimum;
+                        rowMaximum = pValue[i] > rowMaximum ? pValue[i] : rowMaximum;
+                    }
+                    rowMinima[brickX] = rowMinimum;
+                    rowMaxima[brickX] = rowMaximum;
+                }
+
+                // Row at border of brick belongs to neighbouring bricks as well
+                GLint lastBrickY = glm::min(y + 1, volumeResolution.y - 1) / VOLUME_BRICK_SIZE;
+                GLint lastBrickZ = glm::min(z + 1, volumeResolution.z - 1) / VOLUME_BRICK_SIZE;
+                for(GLint brickZ = glm::max(z - 1, 0) / VOLUME_BRICK_SIZE; brickZ <= lastBrickZ; brickZ++)
+                {
+                    for(GLint brickY = glm::max(y - 1, 0) / VOLUME_BRICK_SIZE; brickY <= lastBrickY; brickY++)
+                    {
+                        brickIndex = brickCount.x * brickY + bricksPerLayer * (brickZ - firstBrickLayer);
+                        for(GLint brickX = 0; brickX < brickCount.x; brickX++)
+                        {
+                            slabMinima[brickIndex] = rowMinima[brickX] < slabMinima[brickIndex] ? rowMinima[brickX] : slabMinima[brickIndex];
+                            slabMaxima[brickIndex] = rowMaxima[brickX] > slabMaxima[brickIndex] ? rowMaxima[brickX] : slabMaxima[brickIndex];
+                            brickIndex++;
+                        }
+                    }
+                }
+
+                // Sums for blocks covered by row, last block of row takes remaining voxels
+                blockIndex = importanceVolumeResolution.x * glm::min(y / blockSize.y, importanceVolumeResolution.y - 1)
+                    + blocksPerLayer * (getBlockLayer(z) - firstBlockLayer);
+
+                for(GLint blockX = 0; blockX < importanceVolumeResolution.x; blockX++)
+                {
+                    GLint blockBegin = blockX * blockSize.x;
+                    GLint blockEnd = (blockX + 1 == importanceVolumeResolution.x) ? volumeResolution.x : blockBegin + blockSize.x;
+                    rowSum = 0;
+                    rowSquaredSum = 0;
+                    for(GLint x = blockBegin; x < blockEnd; x++)
+                    {
+                        value = VoxelTraits<T>::integer(pValue[x]);
+                        rowSum += value;
+                        rowSquaredSum += value * value;
+                    }
+
+                    slabSums[blockIndex] += rowSum;
+                    slabSquaredSums[blockIndex] += rowSquaredSum;
+                    slabCounts[blockIndex] += blockEnd - blockBegin;
+                    blockIndex++;
+                }
+
+                pValue += volumeResolution.x;
+            }
+        }
+
+        // Slabs of other threads may share layers at their borders
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for(size_t i = 0; i < slabHistogram.size(); i++)
+        {
+            fullHistogram[i] += slabHistogram[i];
+        }
+
+        size_t brickOffset = static_cast<size_t>(bricksPerLayer) * firstBrickLayer;
+        for(size_t i = 0; i < slabMinima.size(); i++)
+        {
+            brickMinima[brickOffset + i] = glm::min(brickMinima[brickOffset + i], static_cast<GLfloat>(slabMinima[i]));
+            brickMaxima[brickOffset + i] = glm::max(brickMaxima[brickOffset + i], static_cast<GLfloat>(slabMaxima[i]));
+        }
+
+        size_t blockOffset = static_cast<size_t>(blocksPerLayer) * firstBlockLayer;
+        for(size_t i = 0; i < slabSums.size(); i++)
+        {
+            valueSums[blockOffset + i] += slabSums[i];
+            squaredValueSums[blockOffset + i] += slabSquaredSums[i];
+            valueCounts[blockOffset + i] += slabCounts[i];
+        }
+    });
+}
@@ -0,0 +1,152 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VolumeStatistics
+ *--------------
+ * Accumulates histogram, variances for the
+ * importance volume and minimum and maximum per
+ * brick slice by slice, so it can be fed while raw
+ * data is still being read. Slices are split into
+ * slabs which are accumulated in parallel. Bricks
+ * include one voxel of their neighbours, so their
+ * extrema serve empty space skipping directly.
+ *
+ */
+
+#ifndef VOLUMESTATISTICS_H_
+#define VOLUMESTATISTICS_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <limits>
+#include <mutex>
+
+#include "Logger.h"
+#include "VolumeProperties.h"
+#include "Utilities.h"
+
+const GLint VOLUME_IMPORTANCE_VOLUME_DOWNSCALE = 4;
+const GLuint VOLUME_HISTOGRAMM_BUCKET_COUNT = 256;
+const GLboolean VOLUME_HISTOGRAMM_FULL_RESOLUTION = GL_TRUE;
+const GLint VOLUME_BRICK_SIZE = 8;
+
+class VolumeStatistics
+{
+public:
+    VolumeStatistics();
+    ~VolumeStatistics();
+
+    /** Prepare empty accumulators for volume */
+    void init(glm::vec3 volumeResolution, VolumeValueResolution valueResolution);
+
+    /** Fold complete slices into accumulators, data points to first slice */
+    void accumulate(const GLubyte* pSlices, GLuint firstSlice, GLuint sliceCount);
+
+    /** Use results computed earlier instead of accumulating, histogram is derived from full histogram */
+    void restore(
+        glm::vec3 volumeResolution,
+        VolumeValueResolution valueResolution,
+        const std::vector<GLuint64>& fullHistogram,
+        const std::vector<GLfloat>& variances,
+        const std::vector<GLfloat>& brickMinima,
+        const std::vector<GLfloat>& brickMaxima);
+
+    /** Returns whether all slices have been accumulated */
+    GLboolean isComplete() const;
+
+    /** Returns count of slices forming one block of importance volume */
+    GLuint getSlicesPerBlock() const;
+
+    /** Returns resolution of importance volume */
+    glm::ivec3 getImportanceVolumeResolution() const;
+
+    /** Returns absolute histogram */
+    const std::vector<GLuint64>& getHistogram() const;
+
+    /** Returns absolute histogram with one bin per 16 bit value if full resolution is used,
+        otherwise same as histogram */
+    const std::vector<GLuint64>& getFullHistogram() const;
+
+    /** Returns variance per voxel of importance volume */
+    const std::vector<GLfloat>& getVariances() const;
+
+    /** Returns count of bricks per axis */
+    glm::ivec3 getBrickCount() const;
+
+    /** Count of bricks per axis for volume resolution, bricks at the border may be smaller */
+    static glm::ivec3 computeBrickCount(glm::vec3 volumeResolution);
+
+    /** Returns minimum value per brick */
+    const std::vector<GLfloat>& getBrickMinima() const;
+
+    /** Returns maximum value per brick */
+    const std::vector<GLfloat>& getBrickMaxima() const;
+
+protected:
+    /** Calculates variances and frees accumulators */
+    void finish();
+
+    /** Derives buckets of histogram from full histogram */
+    void bucketHistogram();
+
+    /** Accumulation for one type of voxels */
+    template<typename T> void accumulateSlices(const T* pSlices, GLuint firstSlice, GLuint sliceCount);
+
+    /** Layer of importance volume containing slice, last layer takes remaining slices */
+    GLint getBlockLayer(GLint slice) const;
+
+    /** Volume information */
+    glm::ivec3 volumeResolution;
+    VolumeValueResolution valueResolution;
+
+    /** Resolution of importance volume and size of its blocks */
+    glm::ivec3 importanceVolumeResolution;
+    glm::ivec3 blockSize;
+
+    /** Accumulators per block of importance volume, blocks at the end take remaining voxels */
+    std::vector<GLuint64> valueSums;
+    std::vector<GLuint64> squaredValueSums;
+    std::vector<GLuint> valueCounts;
+
+    /** Absolute histogram, derived from full histogram when complete */
+    std::vector<GLuint64> histogram;
+
+    /** Absolute histogram indexed by integer values divided by bin width */
+    std::vector<GLuint64> fullHistogram;
+    GLuint64 binWidth;
+
+    /** Variances available after last slice */
+    std::vector<GLfloat> variances;
+
+    /** Minimum and maximum per brick, including one voxel of neighbouring bricks */
+    glm::ivec3 brickCount;
+    std::vector<GLfloat> brickMinima;
+    std::vector<GLfloat> brickMaxima;
+
+    /** Count of accumulated slices */
+    GLuint accumulatedSlices;
+
+    /** Seconds spent with accumulation */
+    GLdouble accumulationTime;
+};
+
+#endif
@@ -0,0 +1,309 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+#include "VoxelConverter.h"
+
+VoxelType VoxelConverter::parseType(std::string name)
+{
+    // Names used by NRRD and MetaImage
+    if(name == "signed char" || name == "int8" || name == "int8_t" || name == "MET_CHAR")
+    {
+        return VOXEL_INT8;
+    }
+    else if(name == "uchar" || name == "unsigned char" || name == "uint8" || name == "uint8_t" || name == "MET_UCHAR")
+    {
+        return VOXEL_UINT8;
+    }
+    else if(name == "short" || name == "short int" || name == "signed short" || name == "signed short int" || name == "int16" || name == "int16_t" || name == "MET_SHORT")
+    {
+        return VOXEL_INT16;
+    }
+    else if(name == "ushort" || name == "unsigned short" || name == "unsigned short int" || name == "uint16" || name == "uint16_t" || name == "MET_USHORT")
+    {
+        return VOXEL_UINT16;
+    }
+    else if(name == "int" || name == "signed int" || name == "int32" || name == "int32_t" || name == "MET_INT")
+    {
+        return VOXEL_INT32;
+    }
+    else if(name == "uint" || name == "unsigned int" || name == "uint32" || name == "uint32_t" || name == "MET_UINT")
+    {
+        return VOXEL_UINT32;
+    }
+    else if(name == "float" || name == "MET_FLOAT")
+    {
+        return VOXEL_FLOAT32;
+    }
+    else if(name == "double" || name == "MET_DOUBLE")
+    {
+        return VOXEL_FLOAT64;
+    }
+    return VOXEL_UNKNOWN;
+}
+
+size_t VoxelConverter::getSize(VoxelType type)
+{
+    switch(type)
+    {
+    case VOXEL_INT8:
+    case VOXEL_UINT8:
+        return 1;
+    case VOXEL_INT16:
+    case VOXEL_UINT16:
+        return 2;
+    case VOXEL_INT32:
+    case VOXEL_UINT32:
+    case VOXEL_FLOAT32:
+        return 4;
+    case VOXEL_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+VolumeValueResolution VoxelConverter::getValueResolution(VoxelType type)
+{
+    switch(type)
+    {
+    case VOXEL_INT8:
+    case VOXEL_UINT8:
+        return VOLUME_8BIT;
+    case VOXEL_INT16:
+        return VOLUME_16BIT_SIGNED;
+    case VOXEL_FLOAT32:
+    case VOXEL_FLOAT64:
+        return VOLUME_32BIT_FLOAT;
+    default:
+        return VOLUME_16BIT;
+    }
+}
+
+void VoxelConverter::convert(const GLubyte* pSource, GLubyte* pTarget, size_t count, VoxelType type, GLboolean bigEndian)
+{
+    // Only swap if byte order differs from the one of this machine
+    const GLushort one = 1;
+    GLboolean machineIsBigEndian = (*reinterpret_cast<const GLubyte*>(&one) == 0);
+    GLboolean swap = (bigEndian != machineIsBigEndian);
+
+    switch(type)
+    {
+    case VOXEL_INT8:
+    case VOXEL_UINT8:
+        convert8Bit(pSource, pTarget, count, type == VOXEL_INT8);
+        break;
+    case VOXEL_INT16:
+    case VOXEL_UINT16:
+        convert16Bit(reinterpret_cast<const GLushort*>(pSource), reinterpret_cast<GLushort*>(pTarget), count, swap);
+        break;
+    case VOXEL_FLOAT32:
+        convertFloat(reinterpret_cast<const GLfloat*>(pSource), reinterpret_cast<GLfloat*>(pTarget), count, swap);
+        break;
+    case VOXEL_INT32:
+        convertScalar<GLint>(pSource, reinterpret_cast<GLushort*>(pTarget), count, swap, 65535.0);
+        break;
+    case VOXEL_UINT32:
+        convertScalar<GLuint>(pSource, reinterpret_cast<GLushort*>(pTarget), count, swap, 65535.0);
+        break;
+    case VOXEL_FLOAT64:
+        convertScalar<GLdouble>(pSource, reinterpret_cast<GLfloat*>(pTarget), count, swap, 1.0);
+        break;
+    default:
+        break;
+    }
+}
+
+void VoxelConverter::convert8Bit(const GLubyte* pSource, GLubyte* pTarget, size_t count, GLboolean isSigned)
+{
+    GLubyte flip = isSigned ? 0x80 : 0x00;
+
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        size_t i = first;
+#ifdef VOXELCONVERTER_USE_SSE2
+        __m128i flipMask = _mm_set1_epi8(static_cast<GLchar>(flip));
+        for(; i + 16 <= last; i += 16)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pTarget + i), _mm_xor_si128(values, flipMask));
+        }
+#endif
+        for(; i < last; i++)
+        {
+            pTarget[i] = pSource[i] ^ flip;
+        }
+    });
+}
+
+void VoxelConverter::convert16Bit(const GLushort* pSource, GLushort* pTarget, size_t count, GLboolean swap)
+{
+    // Signed values are kept, texture of volume is signed normalized
+    if(!swap)
+    {
+        if(pSource != pTarget)
+        {
+            memcpy(pTarget, pSource, count * sizeof(GLushort));
+        }
+        return;
+    }
+
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        size_t i = first;
+#ifdef VOXELCONVERTER_USE_SSE2
+        for(; i + 8 <= last; i += 8)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pTarget + i), _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8)));
+        }
+#endif
+        for(; i < last; i++)
+        {
+            pTarget[i] = swapBytes(pSource[i]);
+        }
+    });
+}
+
+void VoxelConverter::convertFloat(const GLfloat* pSource, GLfloat* pTarget, size_t count, GLboolean swap)
+{
+    // First pass finds range of finite values
+    std::mutex mutex;
+    GLfloat minimum = std::numeric_limits<GLfloat>::max();
+    GLfloat maximum = -std::numeric_limits<GLfloat>::max();
+
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        GLfloat localMinimum = std::numeric_limits<GLfloat>::max();
+        GLfloat localMaximum = -std::numeric_limits<GLfloat>::max();
+        for(size_t i = first; i < last; i++)
+        {
+            GLfloat value = swap ? swapBytes(pSource[i]) : pSource[i];
+            if(std::isfinite(value))
+            {
+                localMinimum = glm::min(localMinimum, value);
+                localMaximum = glm::max(localMaximum, value);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        minimum = glm::min(minimum, localMinimum);
+        maximum = glm::max(maximum, localMaximum);
+    });
+
+    if(minimum > maximum)
+    {
+        minimum = maximum = 0;
+    }
+    GLfloat scale = (maximum > minimum) ? 1.0f / (maximum - minimum) : 0.0f;
+
+    // Second pass maps range to zero to one
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        size_t i = first;
+#ifdef VOXELCONVERTER_USE_SSE2
+        __m128 minimumValues = _mm_set1_ps(minimum);
+        __m128 maximumValues = _mm_set1_ps(maximum);
+        __m128 scales = _mm_set1_ps(scale);
+        for(; i + 8 <= last; i += 8)
+        {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i + 4));
+            if(swap)
+            {
+                // Swap 16 bit halves, then bytes within them
+                low = _mm_shufflehi_epi16(_mm_shufflelo_epi16(low, 0xB1), 0xB1);
+                high = _mm_shufflehi_epi16(_mm_shufflelo_epi16(high, 0xB1), 0xB1);
+                low = _mm_or_si128(_mm_slli_epi16(low, 8), _mm_srli_epi16(low, 8));
+                high = _mm_or_si128(_mm_slli_epi16(high, 8), _mm_srli_epi16(high, 8));
+            }
+
+            // Clamping removes infinities, NaN becomes minimum
+            __m128 lowValues = _mm_min_ps(_mm_max_ps(_mm_castsi128_ps(low), minimumValues), maximumValues);
+            __m128 highValues = _mm_min_ps(_mm_max_ps(_mm_castsi128_ps(high), minimumValues), maximumValues);
+
+            _mm_storeu_ps(pTarget + i, _mm_mul_ps(_mm_sub_ps(lowValues, minimumValues), scales));
+            _mm_storeu_ps(pTarget + i + 4, _mm_mul_ps(_mm_sub_ps(highValues, minimumValues), scales));
+        }
+#endif
+        for(; i < last; i++)
+        {
+            GLfloat value = swap ? swapBytes(pSource[i]) : pSource[i];
+            value = std::isnan(value) ? minimum : glm::clamp(value, minimum, maximum);
+            pTarget[i] = (value - minimum) * scale;
+        }
+    });
+}
+
+template<typename S, typename T> void VoxelConverter::convertScalar(const GLubyte* pSource, T* pTarget, size_t count, GLboolean swap, GLdouble targetMaximum)
+{
+    const S* pValues = reinterpret_cast<const S*>(pSource);
+
+    // First pass finds range
+    std::mutex mutex;
+    GLdouble minimum = std::numeric_limits<GLdouble>::max();
+    GLdouble maximum = -std::numeric_limits<GLdouble>::max();
+
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        GLdouble localMinimum = std::numeric_limits<GLdouble>::max();
+        GLdouble localMaximum = -std::numeric_limits<GLdouble>::max();
+        for(size_t i = first; i < last; i++)
+        {
+            GLdouble value = static_cast<GLdouble>(swap ? swapBytes(pValues[i]) : pValues[i]);
+            if(std::isfinite(value))
+            {
+                localMinimum = glm::min(localMinimum, value);
+                localMaximum = glm::max(localMaximum, value);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        minimum = glm::min(minimum, localMinimum);
+        maximum = glm::max(maximum, localMaximum);
+    });
+
+    if(minimum > maximum)
+    {
+        minimum = maximum = 0;
+    }
+    GLdouble scale = (maximum > minimum) ? targetMaximum / (maximum - minimum) : 0.0;
+    GLdouble rounding = std::numeric_limits<T>::is_integer ? 0.5 : 0.0;
+
+    // Second pass maps range to range of target
+    UT::parallelFor(0, count, [&](size_t first, size_t last)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            GLdouble value = static_cast<GLdouble>(swap ? swapBytes(pValues[i]) : pValues[i]);
+            value = std::isnan(value) ? minimum : glm::clamp(value, minimum, maximum);
+            pTarget[i] = static_cast<T>((value - minimum) * scale + rounding);
+        }
+    });
+}
+
+template<typename T> T VoxelConverter::swapBytes(T value)
+{
+    T swapped;
+    const GLubyte* pSource = reinterpret_cast<const GLubyte*>(&value);
+    GLubyte* pTarget = reinterpret_cast<GLubyte*>(&swapped);
+    for(size_t i = 0; i < sizeof(T); i++)
+    {
+        pTarget[i] = pSource[sizeof(T) - 1 - i];
+    }
+    return swapped;
+}
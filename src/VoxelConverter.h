@@ -0,0 +1,86 @@
+/**************************************************************************
+ * Voraca 0.97 (VOlume RAy-CAster)
+ **************************************************************************
+ * Copyright (c) 2016, Raphael Philipp Menges
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************/
+
+/*
+ * VoxelConverter
+ *--------------
+ * Converts voxels of foreign types and byte orders into
+ * the value resolutions of volumes. Conversion runs on
+ * all threads, with SSE2 where available.
+ *
+ */
+
+#ifndef VOXELCONVERTER_H_
+#define VOXELCONVERTER_H_
+
+#include "OpenGLLoader/gl_core_3_3.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include <string>
+#include <mutex>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#include "VolumeProperties.h"
+#include "Utilities.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VOXELCONVERTER_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+enum VoxelType
+{
+    VOXEL_INT8, VOXEL_UINT8, VOXEL_INT16, VOXEL_UINT16, VOXEL_INT32, VOXEL_UINT32, VOXEL_FLOAT32, VOXEL_FLOAT64, VOXEL_UNKNOWN
+};
+
+class VoxelConverter
+{
+public:
+    /** Parses type names of NRRD and MetaImage, returns VOXEL_UNKNOWN if not supported */
+    static VoxelType parseType(std::string name);
+
+    /** Bytes per voxel of type */
+    static size_t getSize(VoxelType type);
+
+    /** Value resolution voxels of type are converted to */
+    static VolumeValueResolution getValueResolution(VoxelType type);
+
+    /** Converts voxels. Signed 16 bit keeps its values, floating point types are normalized
+        by their range to float and other wide types to 16 bit. Source may be target if
+        voxels keep their size */
+    static void convert(const GLubyte* pSource, GLubyte* pTarget, size_t count, VoxelType type, GLboolean bigEndian);
+
+private:
+    VoxelConverter();
+
+    /** Eight and 16 bit types keep their values, signed eight bit is shifted into unsigned range */
+    static void convert8Bit(const GLubyte* pSource, GLubyte* pTarget, size_t count, GLboolean isSigned);
+    static void convert16Bit(const GLushort* pSource, GLushort* pTarget, size_t count, GLboolean swap);
+    static void convertFloat(const GLfloat* pSource, GLfloat* pTarget, size_t count, GLboolean swap);
+
+    /** Fallback for types which are rare in practice, maps range to range of target type */
+    template<typename S, typename T> static void convertScalar(const GLubyte* pSource, T* pTarget, size_t count, GLboolean swap, GLdouble targetMaximum);
+
+    /** Reverses bytes of value */
+    template<typename T> static T swapBytes(T value);
+};
+
+#endif